@@ -50,7 +50,9 @@
  * Define the default size for the slave (outstation) message queue. This is used also
  * to buffer ASDUs in the case when the connection is lost.
  *
- * For each queued message about 256 bytes of memory are required.
+ * The queue size is the number of ASDUs of maximum size that can be queued. 256 bytes
+ * of memory are reserved for each of them. The queued ASDUs are packed (each uses its
+ * size plus 3 bytes), so the queue can store more typical (small) ASDUs.
  */
 #define CONFIG_SLAVE_ASDU_QUEUE_SIZE 100
 
@@ -59,10 +61,35 @@
  * specific ASDUs like those that are automatically generated by the stack or created in
  * the slave side callback. The messages in the queue are removed when the connection is lost.
  *
- * For each queued message about 256 bytes of memory are required.
+ * The queue size is the number of ASDUs of maximum size that can be queued (256 bytes of
+ * memory are reserved for each of them).
  */
 #define CONFIG_SLAVE_CONNECTION_ASDU_QUEUE_SIZE 10
 
+/**
+ * Support for a persistent slave message queue that is stored in a memory mapped
+ * file (see T104Slave_setEventQueueFile). Requires the memory mapped file HAL
+ * (hal_mapped_file.h).
+ */
+#define CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE 1
+
+/**
+ * Number of ASDUs in the lock-free ingestion queue of the slave (outstation). Producers
+ * calling Slave_enqueueASDU only encode the ASDU into this queue (without taking a lock)
+ * and the connection threads move the ASDUs to the message queue or event log. The size
+ * is rounded up to a power of two (about 280 bytes of memory are used per ASDU).
+ *
+ * Set to 0 to add the ASDUs directly to the message queue or event log.
+ */
+#define CONFIG_SLAVE_INGEST_QUEUE_SIZE 256
+
+/**
+ * Number of slots of the index used to replace queued measured values that are not yet
+ * sent with newer values (see T104Slave_setEventCoalescing). 24 bytes of memory are used
+ * per slot (only when the coalescing is enabled).
+ */
+#define CONFIG_SLAVE_COALESCING_INDEX_SIZE 1024
+
 /**
  * Compile library with support for SINGLE_REDUNDANCY_GROUP server mode (only CS104 server)
  */
@@ -90,6 +117,30 @@
 /* number of not missing keepalive responses until socket is considered dead */
 #define CONFIG_TCP_KEEPALIVE_CNT 2
 
+/**
+ * Size of the receive buffer of a CS104 connection (in bytes). Has to be at least 255 (maximum APDU size).
+ * A larger buffer allows to read more APDUs with a single socket read.
+ */
+#define CONFIG_T104_RECEIVE_BUFFER_SIZE 2048
+
+/**
+ * Size of the send buffer of a slave connection (in bytes). Has to be at least 255 (maximum APDU size).
+ * All messages created in one pass of the connection handling are written to the socket at once.
+ */
+#define CONFIG_SLAVE_SEND_BUFFER_SIZE 4096
+
+/**
+ * Maximum number of ASDUs a slave connection sends in one pass of the connection handling before
+ * it handles received messages again. 0 -> no limit (the ASDUs are only limited by the k parameter)
+ */
+#define CONFIG_SLAVE_MAX_ASDUS_PER_PASS 0
+
+/**
+ * Use SSE4.1/AVX2 instructions (when supported by the CPU) to decode sequences of measured values
+ * and single/double points with ASDU_decodeBatch. Only used with GCC or clang on x86 platforms.
+ */
+#define CONFIG_USE_SIMD_DECODER 1
+
 
 
 #endif /* CONFIG_LIB60870_CONFIG_H_ */
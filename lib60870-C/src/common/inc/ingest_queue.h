@@ -0,0 +1,115 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef INGEST_QUEUE_H_
+#define INGEST_QUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Lock-free bounded multi-producer single-consumer queue of messages.
+ *
+ * The queue has a power of two number of fixed size slots. Each slot has a
+ * sequence number that tells producers and the consumer if the slot is free or
+ * contains a message. Producers reserve a slot with a single atomic compare and
+ * swap operation, write the message into the slot and publish it. Only one
+ * consumer at a time may read messages (the caller has to serialize consumers).
+ */
+typedef struct sIngestQueue* IngestQueue;
+
+/** Maximum size of a message */
+#define INGEST_QUEUE_MAX_MESSAGE_SIZE 256
+
+typedef struct sIngestQueueSlot* IngestQueueSlot;
+
+struct sIngestQueueSlot {
+    volatile uint64_t seqNo;
+    uint64_t pos; /* queue position of the message (set by the producer) */
+    int msgSize;
+    uint8_t msg[INGEST_QUEUE_MAX_MESSAGE_SIZE];
+};
+
+/**
+ * \brief Create a new queue
+ *
+ * \param minSize minimum number of slots (rounded up to a power of two)
+ */
+IngestQueue
+IngestQueue_create(int minSize);
+
+void
+IngestQueue_destroy(IngestQueue self);
+
+/**
+ * \brief Get the number of slots
+ */
+int
+IngestQueue_getSize(IngestQueue self);
+
+/**
+ * \brief Reserve a slot for a message (producer)
+ *
+ * The message and its size have to be written to the slot and the slot published
+ * with IngestQueue_publish.
+ *
+ * \return the reserved slot or NULL when the queue is full
+ */
+IngestQueueSlot
+IngestQueue_reserve(IngestQueue self);
+
+/**
+ * \brief Make the message in a reserved slot available for the consumer
+ */
+void
+IngestQueue_publish(IngestQueue self, IngestQueueSlot slot);
+
+/**
+ * \brief Get the oldest message (consumer)
+ *
+ * \return the slot with the oldest message or NULL when no published message is available
+ */
+IngestQueueSlot
+IngestQueue_peek(IngestQueue self);
+
+/**
+ * \brief Release the slot returned by IngestQueue_peek (consumer)
+ */
+void
+IngestQueue_release(IngestQueue self, IngestQueueSlot slot);
+
+/**
+ * \brief Check if the queue is empty (can be called by any thread)
+ *
+ * The result is only a hint when producers or the consumer are active at the same time.
+ */
+bool
+IngestQueue_isEmpty(IngestQueue self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INGEST_QUEUE_H_ */
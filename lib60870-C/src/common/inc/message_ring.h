@@ -0,0 +1,228 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef MESSAGE_RING_H_
+#define MESSAGE_RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Ring buffer of variable length messages.
+ *
+ * The messages are packed into a contiguous byte buffer. Each message is stored
+ * with a three byte header (length and state) and is never split at the end of the
+ * buffer, so the memory used by a message is its size plus three bytes. Every
+ * message gets a sequence number when it is added. Messages are removed in the
+ * same order they have been added.
+ *
+ * Space for a message can be reserved and the message written later (e.g. without
+ * holding a lock). Reserved messages can be committed in any order, but readers
+ * only see the messages up to the first message that is not yet committed.
+ */
+struct sMessageRing {
+    uint8_t* buffer;
+    int size; /* size of the buffer in bytes */
+
+    int oldestPos; /* position of the oldest message */
+    int committedPos; /* position of the first message that is not committed */
+    int nextPos; /* position of the next message to add */
+    int newestPos; /* position of the newest message (-1 when unknown) */
+
+    uint64_t oldestSeqNo; /* sequence number of the oldest message */
+    uint64_t committedSeqNo; /* sequence number of the first message that is not committed */
+    uint64_t nextSeqNo; /* sequence number of the next message to add */
+};
+
+typedef struct sMessageRing* MessageRing;
+
+/**
+ * Position of a message in the ring. Can be used to read the messages in order.
+ */
+typedef struct {
+    uint64_t seqNo;
+    int pos;
+} MessageRingCursor;
+
+/** Maximum size of a message */
+#define MESSAGE_RING_MAX_MESSAGE_SIZE 0xfffe
+
+/**
+ * \brief Initialize the message ring
+ *
+ * \param buffer the memory used to store the messages
+ * \param size the size of the buffer in bytes
+ */
+void
+MessageRing_initialize(MessageRing self, uint8_t* buffer, int size);
+
+/**
+ * \brief Remove all committed messages (the sequence numbers are not reset)
+ */
+void
+MessageRing_clear(MessageRing self);
+
+/**
+ * \brief Get the number of committed messages
+ */
+static inline int
+MessageRing_getNumberOfMessages(MessageRing self)
+{
+    return (int) (self->committedSeqNo - self->oldestSeqNo);
+}
+
+/**
+ * \brief Check if the ring contains no committed messages
+ */
+static inline bool
+MessageRing_isEmpty(MessageRing self)
+{
+    return (self->committedSeqNo == self->oldestSeqNo);
+}
+
+/**
+ * \brief Get the number of bytes used by the messages (including reserved messages)
+ */
+int
+MessageRing_getUsedSpace(MessageRing self);
+
+/**
+ * \brief Add a message (reserve and commit)
+ *
+ * \return true if the message has been added, false if there is not enough free space
+ */
+bool
+MessageRing_add(MessageRing self, const uint8_t* msg, int msgSize);
+
+/**
+ * \brief Reserve space for a message
+ *
+ * The message has to be written to the returned buffer and committed with
+ * MessageRing_commit. The reserved message is not visible to readers and is not
+ * removed before it is committed.
+ *
+ * \return buffer for the message or NULL if there is not enough free space
+ */
+uint8_t*
+MessageRing_reserve(MessageRing self, int msgSize);
+
+/**
+ * \brief Commit a reserved message
+ *
+ * \param msg the buffer returned by MessageRing_reserve
+ */
+void
+MessageRing_commit(MessageRing self, uint8_t* msg);
+
+/**
+ * \brief Get the newest message when it is committed and no message is reserved
+ *
+ * \param msgSize returns the size of the message
+ *
+ * \return the newest message or NULL
+ */
+uint8_t*
+MessageRing_getNewest(MessageRing self, int* msgSize);
+
+/**
+ * \brief Append bytes to the newest message (see MessageRing_getNewest)
+ *
+ * Cursors that point behind the newest message become invalid.
+ *
+ * \param additionalSize the number of bytes to append
+ *
+ * \return buffer for the appended bytes or NULL if there is not enough free space behind the message
+ */
+uint8_t*
+MessageRing_extendNewest(MessageRing self, int additionalSize);
+
+/**
+ * \brief Remove the oldest message (the ring must contain a committed message)
+ */
+void
+MessageRing_removeOldest(MessageRing self);
+
+/**
+ * \brief Remove all committed messages with a sequence number less or equal to the given sequence number
+ */
+void
+MessageRing_removeUntil(MessageRing self, uint64_t seqNo);
+
+/**
+ * \brief Check that the positions and sequence numbers match the committed messages in the buffer
+ *
+ * Used when the state of the ring is restored from a file. Every message has to be
+ * committed, no longer than maxMessageSize and inside of the buffer.
+ */
+bool
+MessageRing_isConsistent(MessageRing self, int maxMessageSize);
+
+/**
+ * \brief Set the cursor to the oldest message
+ */
+void
+MessageRing_getOldest(MessageRing self, MessageRingCursor* cursor);
+
+/**
+ * \brief Set the cursor behind the newest committed message
+ */
+void
+MessageRing_getEnd(MessageRing self, MessageRingCursor* cursor);
+
+/**
+ * \brief Check if the message the cursor points to has been removed from the ring
+ */
+static inline bool
+MessageRing_isRemoved(MessageRing self, MessageRingCursor* cursor)
+{
+    return (cursor->seqNo < self->oldestSeqNo);
+}
+
+/**
+ * \brief Check if the cursor points behind the newest committed message
+ */
+static inline bool
+MessageRing_isAtEnd(MessageRing self, MessageRingCursor* cursor)
+{
+    return (cursor->seqNo == self->committedSeqNo);
+}
+
+/**
+ * \brief Read the message the cursor points to and move the cursor to the next message
+ *
+ * The cursor has to point to a committed message that is in the ring.
+ *
+ * \param msgSize returns the size of the message
+ *
+ * \return the message. It remains valid until it is removed from the ring.
+ */
+uint8_t*
+MessageRing_read(MessageRing self, MessageRingCursor* cursor, int* msgSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESSAGE_RING_H_ */
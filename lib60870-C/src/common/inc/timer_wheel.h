@@ -0,0 +1,173 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup common_api_group
+ */
+/**@{*/
+
+/**
+ * \defgroup TIMER_WHEEL Hierarchical timer wheel
+ *
+ * The timer wheel manages a large number of timers with millisecond resolution. Arming and
+ * cancelling a timer are O(1) operations. The timers are stored in four levels of 64 slots
+ * (1 ms, 64 ms, 4.096 s, and 262.144 s per slot). Timers beyond the range of the highest level
+ * are kept in an overflow list.
+ *
+ * The timer wheel is not thread-safe. All functions have to be called by the thread that owns it.
+ */
+/**@{*/
+
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_SLOTS 64
+
+/**
+ * \brief Callback function that is called when a timer expired
+ *
+ * The handler is allowed to arm or cancel timers (including the expired timer).
+ *
+ * \param parameter user provided parameter
+ */
+typedef void (*TimerWheel_TimeoutHandler) (void* parameter);
+
+struct sTimerWheelLink {
+    struct sTimerWheelLink* next;
+    struct sTimerWheelLink* prev;
+};
+
+/**
+ * \brief Timer that can be embedded in other structures (no memory allocation required)
+ */
+struct sTimerWheelTimer {
+    struct sTimerWheelLink link; /* has to be the first element */
+    uint64_t expiryTime;
+    TimerWheel_TimeoutHandler handler;
+    void* parameter;
+    uint8_t level;
+    uint8_t slot;
+};
+
+typedef struct sTimerWheelTimer* TimerWheelTimer;
+
+typedef struct sTimerWheel* TimerWheel;
+
+/**
+ * \brief Initialize a timer (the timer is not armed)
+ *
+ * \param self the timer instance
+ * \param handler the function to be called when the timer expired
+ * \param parameter user provided parameter for the handler
+ */
+void
+TimerWheelTimer_initialize(TimerWheelTimer self, TimerWheel_TimeoutHandler handler, void* parameter);
+
+/**
+ * \brief Check if the timer is armed
+ */
+bool
+TimerWheelTimer_isArmed(TimerWheelTimer self);
+
+/**
+ * \brief Get the expiry time of the timer (only valid when armed)
+ */
+uint64_t
+TimerWheelTimer_getExpiryTime(TimerWheelTimer self);
+
+/**
+ * \brief Create a new timer wheel
+ *
+ * \param currentTime the current time in ms
+ *
+ * \return the new instance or NULL when memory allocation failed
+ */
+TimerWheel
+TimerWheel_create(uint64_t currentTime);
+
+/**
+ * \brief Destroy the timer wheel. The armed timers are not touched.
+ */
+void
+TimerWheel_destroy(TimerWheel self);
+
+/**
+ * \brief Arm a timer. If the timer is already armed it is rescheduled.
+ *
+ * \param timer the timer to arm
+ * \param expiryTime time in ms when the timer expires. A time in the past expires with the next call of TimerWheel_advance.
+ */
+void
+TimerWheel_arm(TimerWheel self, TimerWheelTimer timer, uint64_t expiryTime);
+
+/**
+ * \brief Cancel a timer (nothing happens when the timer is not armed)
+ */
+void
+TimerWheel_cancel(TimerWheel self, TimerWheelTimer timer);
+
+/**
+ * \brief Advance the time of the timer wheel and call the handlers of all expired timers
+ *
+ * \param currentTime the current time in ms
+ */
+void
+TimerWheel_advance(TimerWheel self, uint64_t currentTime);
+
+/**
+ * \brief Get the time when TimerWheel_advance has to be called next
+ *
+ * The returned time can be earlier than the expiry time of the next timer (when timers
+ * of higher levels have to be moved to lower levels).
+ *
+ * \return the time in ms or UINT64_MAX when no timer is armed
+ */
+uint64_t
+TimerWheel_getNextExpiryTime(TimerWheel self);
+
+/**
+ * \brief Get the time to wait until TimerWheel_advance has to be called next
+ *
+ * \param currentTime the current time in ms
+ * \param maxTimeout the maximum value to be returned
+ *
+ * \return time to wait in ms (0 .. maxTimeout)
+ */
+int
+TimerWheel_getTimeout(TimerWheel self, uint64_t currentTime, int maxTimeout);
+
+/**@}*/
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMER_WHEEL_H_ */
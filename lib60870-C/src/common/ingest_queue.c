@@ -0,0 +1,149 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include "ingest_queue.h"
+#include "hal_atomic.h"
+#include "lib_memory.h"
+
+#if (HAL_ATOMIC_AVAILABLE == 1)
+
+struct sIngestQueue {
+    int size; /* number of slots - always a power of two */
+
+    volatile uint64_t enqueuePos; /* next position to reserve by a producer */
+    volatile uint64_t dequeuePos; /* next position to read by the consumer */
+
+    IngestQueueSlot slots;
+};
+
+IngestQueue
+IngestQueue_create(int minSize)
+{
+    IngestQueue self = (IngestQueue) GLOBAL_MALLOC(sizeof(struct sIngestQueue));
+
+    if (self != NULL) {
+        int size = 1;
+
+        while (size < minSize)
+            size = size * 2;
+
+        self->slots = (IngestQueueSlot) GLOBAL_CALLOC(size, sizeof(struct sIngestQueueSlot));
+
+        if (self->slots == NULL) {
+            GLOBAL_FREEMEM(self);
+            return NULL;
+        }
+
+        self->size = size;
+        self->enqueuePos = 0;
+        self->dequeuePos = 0;
+
+        /* a slot is free for position pos when its sequence number is pos */
+        int i;
+
+        for (i = 0; i < size; i++)
+            self->slots[i].seqNo = (uint64_t) i;
+    }
+
+    return self;
+}
+
+void
+IngestQueue_destroy(IngestQueue self)
+{
+    if (self != NULL) {
+        GLOBAL_FREEMEM(self->slots);
+        GLOBAL_FREEMEM(self);
+    }
+}
+
+int
+IngestQueue_getSize(IngestQueue self)
+{
+    return self->size;
+}
+
+IngestQueueSlot
+IngestQueue_reserve(IngestQueue self)
+{
+    uint64_t pos = Atomic_loadAcquire(&(self->enqueuePos));
+
+    while (true) {
+        IngestQueueSlot slot = &(self->slots[pos & (uint64_t) (self->size - 1)]);
+
+        int64_t diff = (int64_t) (Atomic_loadAcquire(&(slot->seqNo)) - pos);
+
+        if (diff == 0) {
+            /* slot is free -> try to reserve the position */
+            if (Atomic_compareAndSwap(&(self->enqueuePos), pos, pos + 1)) {
+                slot->pos = pos;
+                return slot;
+            }
+        }
+        else if (diff < 0) {
+            /* slot still contains the message of the previous round -> queue is full */
+            return NULL;
+        }
+
+        /* another producer reserved the position */
+        pos = Atomic_loadAcquire(&(self->enqueuePos));
+    }
+}
+
+void
+IngestQueue_publish(IngestQueue self, IngestQueueSlot slot)
+{
+    (void) self;
+
+    Atomic_storeRelease(&(slot->seqNo), slot->pos + 1);
+}
+
+IngestQueueSlot
+IngestQueue_peek(IngestQueue self)
+{
+    uint64_t pos = self->dequeuePos;
+
+    IngestQueueSlot slot = &(self->slots[pos & (uint64_t) (self->size - 1)]);
+
+    if (Atomic_loadAcquire(&(slot->seqNo)) != (pos + 1))
+        return NULL;
+
+    slot->pos = pos;
+
+    return slot;
+}
+
+void
+IngestQueue_release(IngestQueue self, IngestQueueSlot slot)
+{
+    /* the slot can be used again in the next round */
+    Atomic_storeRelease(&(slot->seqNo), slot->pos + self->size);
+
+    Atomic_storeRelease(&(self->dequeuePos), slot->pos + 1);
+}
+
+bool
+IngestQueue_isEmpty(IngestQueue self)
+{
+    return (Atomic_loadAcquire(&(self->enqueuePos)) == Atomic_loadAcquire(&(self->dequeuePos)));
+}
+
+#endif /* (HAL_ATOMIC_AVAILABLE == 1) */
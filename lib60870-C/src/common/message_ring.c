@@ -0,0 +1,312 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include <string.h>
+
+#include "message_ring.h"
+
+/* message header: length (2 bytes) and state (1 byte) */
+#define HEADER_SIZE 3
+
+#define STATE_RESERVED 0
+#define STATE_COMMITTED 1
+
+/* length header value that marks the end of the used buffer space (continue at position 0) */
+#define WRAP_MARKER 0xffff
+
+static int
+getLength(MessageRing self, int pos)
+{
+    return self->buffer[pos] + (self->buffer[pos + 1] * 0x100);
+}
+
+static void
+setLength(MessageRing self, int pos, int length)
+{
+    self->buffer[pos] = (uint8_t) (length % 0x100);
+    self->buffer[pos + 1] = (uint8_t) (length / 0x100);
+}
+
+/* Get the position of the message header. Only valid when a message is stored at pos */
+static int
+getHeaderPos(MessageRing self, int pos)
+{
+    /* not enough space for a header -> message is at the beginning of the buffer */
+    if (pos > (self->size - HEADER_SIZE))
+        return 0;
+
+    if (getLength(self, pos) == WRAP_MARKER)
+        return 0;
+
+    return pos;
+}
+
+void
+MessageRing_initialize(MessageRing self, uint8_t* buffer, int size)
+{
+    self->buffer = buffer;
+    self->size = size;
+    self->oldestPos = 0;
+    self->committedPos = 0;
+    self->nextPos = 0;
+    self->newestPos = -1;
+    self->oldestSeqNo = 0;
+    self->committedSeqNo = 0;
+    self->nextSeqNo = 0;
+}
+
+void
+MessageRing_clear(MessageRing self)
+{
+    self->oldestSeqNo = self->committedSeqNo;
+    self->oldestPos = self->committedPos;
+}
+
+int
+MessageRing_getUsedSpace(MessageRing self)
+{
+    if (self->nextSeqNo == self->oldestSeqNo)
+        return 0;
+
+    if (self->nextPos > self->oldestPos)
+        return self->nextPos - self->oldestPos;
+
+    /* the used space wraps around (the unused space at the end of the buffer is counted as used) */
+    return self->size - self->oldestPos + self->nextPos;
+}
+
+uint8_t*
+MessageRing_reserve(MessageRing self, int msgSize)
+{
+    int requiredSize = msgSize + HEADER_SIZE;
+
+    if ((msgSize > MESSAGE_RING_MAX_MESSAGE_SIZE) || (requiredSize > self->size))
+        return NULL;
+
+    bool isEmpty = (self->nextSeqNo == self->oldestSeqNo);
+
+    /* start at the beginning of the buffer when the ring is empty */
+    if (isEmpty) {
+        self->oldestPos = 0;
+        self->committedPos = 0;
+        self->nextPos = 0;
+    }
+
+    int pos = self->nextPos;
+
+    if ((pos > self->oldestPos) || isEmpty) {
+
+        /* message doesn't fit at the end of the buffer -> continue at the beginning */
+        if ((self->size - pos) < requiredSize) {
+
+            if (self->oldestPos < requiredSize)
+                return NULL;
+
+            if ((self->size - pos) >= HEADER_SIZE)
+                setLength(self, pos, WRAP_MARKER);
+
+            pos = 0;
+        }
+    }
+    else if (pos < self->oldestPos) {
+        if ((self->oldestPos - pos) < requiredSize)
+            return NULL;
+    }
+    else /* ring is full */
+        return NULL;
+
+    setLength(self, pos, msgSize);
+    self->buffer[pos + 2] = STATE_RESERVED;
+
+    self->newestPos = pos;
+    self->nextPos = pos + requiredSize;
+    self->nextSeqNo++;
+
+    return self->buffer + pos + HEADER_SIZE;
+}
+
+void
+MessageRing_commit(MessageRing self, uint8_t* msg)
+{
+    *(msg - 1) = STATE_COMMITTED;
+
+    /* move the commit position over all committed messages */
+    while (self->committedSeqNo != self->nextSeqNo) {
+        int pos = getHeaderPos(self, self->committedPos);
+
+        if (self->buffer[pos + 2] != STATE_COMMITTED)
+            break;
+
+        self->committedPos = pos + HEADER_SIZE + getLength(self, pos);
+        self->committedSeqNo++;
+    }
+}
+
+bool
+MessageRing_add(MessageRing self, const uint8_t* msg, int msgSize)
+{
+    uint8_t* buffer = MessageRing_reserve(self, msgSize);
+
+    if (buffer == NULL)
+        return false;
+
+    memcpy(buffer, msg, msgSize);
+
+    MessageRing_commit(self, buffer);
+
+    return true;
+}
+
+uint8_t*
+MessageRing_getNewest(MessageRing self, int* msgSize)
+{
+    if (MessageRing_isEmpty(self) || (self->committedSeqNo != self->nextSeqNo) || (self->newestPos < 0))
+        return NULL;
+
+    *msgSize = getLength(self, self->newestPos);
+
+    return self->buffer + self->newestPos + HEADER_SIZE;
+}
+
+uint8_t*
+MessageRing_extendNewest(MessageRing self, int additionalSize)
+{
+    int msgSize;
+
+    if (MessageRing_getNewest(self, &msgSize) == NULL)
+        return NULL;
+
+    if ((msgSize + additionalSize) > MESSAGE_RING_MAX_MESSAGE_SIZE)
+        return NULL;
+
+    /* free space behind the newest message */
+    int freeSpace;
+
+    if (self->nextPos > self->oldestPos)
+        freeSpace = self->size - self->nextPos;
+    else
+        freeSpace = self->oldestPos - self->nextPos;
+
+    if (freeSpace < additionalSize)
+        return NULL;
+
+    uint8_t* buffer = self->buffer + self->nextPos;
+
+    setLength(self, self->newestPos, msgSize + additionalSize);
+
+    self->nextPos += additionalSize;
+    self->committedPos = self->nextPos;
+
+    return buffer;
+}
+
+void
+MessageRing_removeOldest(MessageRing self)
+{
+    int pos = getHeaderPos(self, self->oldestPos);
+
+    self->oldestPos = pos + HEADER_SIZE + getLength(self, pos);
+    self->oldestSeqNo++;
+}
+
+void
+MessageRing_removeUntil(MessageRing self, uint64_t seqNo)
+{
+    while ((self->oldestSeqNo <= seqNo) && (MessageRing_isEmpty(self) == false))
+        MessageRing_removeOldest(self);
+}
+
+bool
+MessageRing_isConsistent(MessageRing self, int maxMessageSize)
+{
+    if ((self->oldestPos < 0) || (self->oldestPos > self->size) ||
+            (self->committedPos < 0) || (self->committedPos > self->size))
+        return false;
+
+    if (self->committedSeqNo < self->oldestSeqNo)
+        return false;
+
+    /* every message uses at least the space of the header */
+    if ((self->committedSeqNo - self->oldestSeqNo) > (uint64_t) (self->size / HEADER_SIZE))
+        return false;
+
+    int pos = self->oldestPos;
+    bool isWrapped = false;
+    uint64_t seqNo;
+
+    for (seqNo = self->oldestSeqNo; seqNo < self->committedSeqNo; seqNo++) {
+
+        if ((pos > (self->size - HEADER_SIZE)) || (getLength(self, pos) == WRAP_MARKER)) {
+
+            /* the messages can only continue once at the beginning of the buffer */
+            if (isWrapped)
+                return false;
+
+            isWrapped = true;
+            pos = 0;
+        }
+
+        int length = getLength(self, pos);
+
+        if ((length > maxMessageSize) || (self->buffer[pos + 2] != STATE_COMMITTED))
+            return false;
+
+        pos += HEADER_SIZE + length;
+
+        if ((pos > self->size) || (isWrapped && (pos > self->oldestPos)))
+            return false;
+    }
+
+    return (pos == self->committedPos);
+}
+
+void
+MessageRing_getOldest(MessageRing self, MessageRingCursor* cursor)
+{
+    cursor->seqNo = self->oldestSeqNo;
+    cursor->pos = self->oldestPos;
+}
+
+void
+MessageRing_getEnd(MessageRing self, MessageRingCursor* cursor)
+{
+    cursor->seqNo = self->committedSeqNo;
+    cursor->pos = self->committedPos;
+}
+
+uint8_t*
+MessageRing_read(MessageRing self, MessageRingCursor* cursor, int* msgSize)
+{
+    int pos;
+
+    /* the ring may have been restarted at position 0 since the cursor was set */
+    if (cursor->seqNo == self->oldestSeqNo)
+        pos = getHeaderPos(self, self->oldestPos);
+    else
+        pos = getHeaderPos(self, cursor->pos);
+
+    *msgSize = getLength(self, pos);
+
+    cursor->pos = pos + HEADER_SIZE + *msgSize;
+    cursor->seqNo++;
+
+    return self->buffer + pos + HEADER_SIZE;
+}
@@ -0,0 +1,383 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include "timer_wheel.h"
+#include "lib_memory.h"
+
+#define SLOT_BITS 6
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+
+/* level of the timers in the overflow list */
+#define OVERFLOW_LEVEL TIMER_WHEEL_LEVELS
+
+struct sTimerWheel {
+    uint64_t currentTime;
+    int numberOfTimers;
+
+    uint64_t occupiedSlots[TIMER_WHEEL_LEVELS]; /* one bit per non-empty slot */
+    struct sTimerWheelLink slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    struct sTimerWheelLink overflow;
+};
+
+static void
+List_initialize(struct sTimerWheelLink* head)
+{
+    head->next = head;
+    head->prev = head;
+}
+
+static bool
+List_isEmpty(struct sTimerWheelLink* head)
+{
+    return (head->next == head);
+}
+
+static void
+List_append(struct sTimerWheelLink* head, struct sTimerWheelLink* link)
+{
+    link->prev = head->prev;
+    link->next = head;
+    head->prev->next = link;
+    head->prev = link;
+}
+
+static void
+List_unlink(struct sTimerWheelLink* link)
+{
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+
+    link->next = NULL;
+    link->prev = NULL;
+}
+
+/* move all elements of the list "from" to the empty list "to" */
+static void
+List_moveAll(struct sTimerWheelLink* from, struct sTimerWheelLink* to)
+{
+    if (List_isEmpty(from))
+        List_initialize(to);
+    else {
+        to->next = from->next;
+        to->prev = from->prev;
+        to->next->prev = to;
+        to->prev->next = to;
+
+        List_initialize(from);
+    }
+}
+
+static int
+findFirstSetBit(uint64_t value)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(value);
+#else
+    int bit = 0;
+
+    while ((value & 1) == 0) {
+        value = value >> 1;
+        bit++;
+    }
+
+    return bit;
+#endif
+}
+
+void
+TimerWheelTimer_initialize(TimerWheelTimer self, TimerWheel_TimeoutHandler handler, void* parameter)
+{
+    self->link.next = NULL;
+    self->link.prev = NULL;
+    self->expiryTime = 0;
+    self->handler = handler;
+    self->parameter = parameter;
+    self->level = 0;
+    self->slot = 0;
+}
+
+bool
+TimerWheelTimer_isArmed(TimerWheelTimer self)
+{
+    return (self->link.next != NULL);
+}
+
+uint64_t
+TimerWheelTimer_getExpiryTime(TimerWheelTimer self)
+{
+    return self->expiryTime;
+}
+
+TimerWheel
+TimerWheel_create(uint64_t currentTime)
+{
+    TimerWheel self = (TimerWheel) GLOBAL_MALLOC(sizeof(struct sTimerWheel));
+
+    if (self != NULL) {
+        self->currentTime = currentTime;
+        self->numberOfTimers = 0;
+
+        int level;
+        int slot;
+
+        for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+            self->occupiedSlots[level] = 0;
+
+            for (slot = 0; slot < TIMER_WHEEL_SLOTS; slot++)
+                List_initialize(&(self->slots[level][slot]));
+        }
+
+        List_initialize(&(self->overflow));
+    }
+
+    return self;
+}
+
+void
+TimerWheel_destroy(TimerWheel self)
+{
+    GLOBAL_FREEMEM(self);
+}
+
+/*
+ * A timer is stored in the lowest level where the expiry time and the current time only
+ * differ in the bits of this level.
+ */
+static void
+insertTimer(TimerWheel self, TimerWheelTimer timer)
+{
+    uint64_t expiryTime = timer->expiryTime;
+
+    if (expiryTime < self->currentTime)
+        expiryTime = self->currentTime;
+
+    uint64_t difference = expiryTime ^ self->currentTime;
+
+    int level;
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if ((difference >> (SLOT_BITS * (level + 1))) == 0)
+            break;
+    }
+
+    if (level == TIMER_WHEEL_LEVELS) {
+        timer->level = OVERFLOW_LEVEL;
+        List_append(&(self->overflow), &(timer->link));
+    }
+    else {
+        int slot = (int) ((expiryTime >> (SLOT_BITS * level)) & SLOT_MASK);
+
+        timer->level = (uint8_t) level;
+        timer->slot = (uint8_t) slot;
+
+        List_append(&(self->slots[level][slot]), &(timer->link));
+
+        self->occupiedSlots[level] |= ((uint64_t) 1 << slot);
+    }
+}
+
+static void
+removeTimer(TimerWheel self, TimerWheelTimer timer)
+{
+    List_unlink(&(timer->link));
+
+    if (timer->level != OVERFLOW_LEVEL) {
+        if (List_isEmpty(&(self->slots[timer->level][timer->slot])))
+            self->occupiedSlots[timer->level] &= ~((uint64_t) 1 << timer->slot);
+    }
+
+    self->numberOfTimers--;
+}
+
+/*
+ * Get the time of the next slot that has to be handled.
+ *
+ * For levels > 0 this is the start time of the slot where its timers have to be moved to
+ * the lower levels.
+ */
+static uint64_t
+getNextEventTime(TimerWheel self, bool includeCurrentSlot, int* eventLevel)
+{
+    uint64_t currentTime = self->currentTime;
+
+    int level;
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        int currentSlot = (int) ((currentTime >> (SLOT_BITS * level)) & SLOT_MASK);
+
+        uint64_t mask;
+
+        if ((level == 0) && includeCurrentSlot)
+            mask = ~((uint64_t) 0) << currentSlot;
+        else if (currentSlot == SLOT_MASK)
+            mask = 0;
+        else
+            mask = ~((uint64_t) 0) << (currentSlot + 1);
+
+        uint64_t occupied = self->occupiedSlots[level] & mask;
+
+        if (occupied != 0) {
+            int upperLevelShift = SLOT_BITS * (level + 1);
+
+            *eventLevel = level;
+
+            return ((currentTime >> upperLevelShift) << upperLevelShift) |
+                    ((uint64_t) findFirstSetBit(occupied) << (SLOT_BITS * level));
+        }
+    }
+
+    if (List_isEmpty(&(self->overflow)) == false) {
+        int overflowShift = SLOT_BITS * TIMER_WHEEL_LEVELS;
+
+        *eventLevel = OVERFLOW_LEVEL;
+
+        return ((currentTime >> overflowShift) + 1) << overflowShift;
+    }
+
+    return UINT64_MAX;
+}
+
+/* move the timers of a higher level slot to the lower levels */
+static void
+cascadeSlot(TimerWheel self, int level)
+{
+    struct sTimerWheelLink timers;
+
+    if (level == OVERFLOW_LEVEL)
+        List_moveAll(&(self->overflow), &timers);
+    else {
+        int slot = (int) ((self->currentTime >> (SLOT_BITS * level)) & SLOT_MASK);
+
+        List_moveAll(&(self->slots[level][slot]), &timers);
+
+        self->occupiedSlots[level] &= ~((uint64_t) 1 << slot);
+    }
+
+    while (List_isEmpty(&timers) == false) {
+        TimerWheelTimer timer = (TimerWheelTimer) timers.next;
+
+        List_unlink(&(timer->link));
+
+        insertTimer(self, timer);
+    }
+}
+
+static void
+expireCurrentSlot(TimerWheel self)
+{
+    int slot = (int) (self->currentTime & SLOT_MASK);
+
+    if ((self->occupiedSlots[0] & ((uint64_t) 1 << slot)) == 0)
+        return;
+
+    struct sTimerWheelLink expiredTimers;
+
+    List_moveAll(&(self->slots[0][slot]), &expiredTimers);
+
+    self->occupiedSlots[0] &= ~((uint64_t) 1 << slot);
+
+    /* handlers can cancel other expired timers - so always take the first remaining timer */
+    while (List_isEmpty(&expiredTimers) == false) {
+        TimerWheelTimer timer = (TimerWheelTimer) expiredTimers.next;
+
+        List_unlink(&(timer->link));
+
+        self->numberOfTimers--;
+
+        timer->handler(timer->parameter);
+    }
+}
+
+void
+TimerWheel_arm(TimerWheel self, TimerWheelTimer timer, uint64_t expiryTime)
+{
+    if (TimerWheelTimer_isArmed(timer))
+        removeTimer(self, timer);
+
+    timer->expiryTime = expiryTime;
+
+    insertTimer(self, timer);
+
+    self->numberOfTimers++;
+}
+
+void
+TimerWheel_cancel(TimerWheel self, TimerWheelTimer timer)
+{
+    if (TimerWheelTimer_isArmed(timer))
+        removeTimer(self, timer);
+}
+
+void
+TimerWheel_advance(TimerWheel self, uint64_t currentTime)
+{
+    /* ignore when the time is going backwards */
+    if (currentTime < self->currentTime)
+        return;
+
+    if (self->numberOfTimers == 0) {
+        self->currentTime = currentTime;
+        return;
+    }
+
+    /* timers that have been armed with an expiry time in the past */
+    expireCurrentSlot(self);
+
+    while (true) {
+        int level;
+
+        uint64_t nextEventTime = getNextEventTime(self, false, &level);
+
+        if (nextEventTime > currentTime) {
+            self->currentTime = currentTime;
+            break;
+        }
+
+        self->currentTime = nextEventTime;
+
+        if (level > 0)
+            cascadeSlot(self, level);
+
+        expireCurrentSlot(self);
+    }
+}
+
+uint64_t
+TimerWheel_getNextExpiryTime(TimerWheel self)
+{
+    int level;
+
+    return getNextEventTime(self, true, &level);
+}
+
+int
+TimerWheel_getTimeout(TimerWheel self, uint64_t currentTime, int maxTimeout)
+{
+    uint64_t nextExpiryTime = TimerWheel_getNextExpiryTime(self);
+
+    if (nextExpiryTime <= currentTime)
+        return 0;
+
+    if ((nextExpiryTime - currentTime) > (uint64_t) maxTimeout)
+        return maxTimeout;
+
+    return (int) (nextExpiryTime - currentTime);
+}
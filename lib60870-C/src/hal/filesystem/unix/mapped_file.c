@@ -0,0 +1,96 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "hal_mapped_file.h"
+#include "lib_memory.h"
+
+struct sMappedFile {
+    int fd;
+    int size;
+    uint8_t* buffer;
+};
+
+MappedFile
+MappedFile_open(const char* fileName, int size)
+{
+    MappedFile self = NULL;
+
+    int fd = open(fileName, O_RDWR | O_CREAT, 0644);
+
+    if (fd == -1)
+        return NULL;
+
+    struct stat fileStat;
+
+    if ((fstat(fd, &fileStat) == 0) &&
+            ((fileStat.st_size >= size) || (ftruncate(fd, size) == 0)))
+    {
+        void* buffer = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (buffer != MAP_FAILED) {
+            self = (MappedFile) GLOBAL_MALLOC(sizeof(struct sMappedFile));
+
+            if (self != NULL) {
+                self->fd = fd;
+                self->size = size;
+                self->buffer = (uint8_t*) buffer;
+            }
+            else
+                munmap(buffer, size);
+        }
+    }
+
+    if (self == NULL)
+        close(fd);
+
+    return self;
+}
+
+uint8_t*
+MappedFile_getBuffer(MappedFile self)
+{
+    return self->buffer;
+}
+
+bool
+MappedFile_sync(MappedFile self, int offset, int size)
+{
+    /* msync requires an address at a page boundary */
+    int pageOffset = offset % (int) sysconf(_SC_PAGESIZE);
+
+    return (msync(self->buffer + offset - pageOffset, size + pageOffset, MS_SYNC) == 0);
+}
+
+void
+MappedFile_close(MappedFile self)
+{
+    msync(self->buffer, self->size, MS_SYNC);
+    munmap(self->buffer, self->size);
+    close(self->fd);
+
+    GLOBAL_FREEMEM(self);
+}
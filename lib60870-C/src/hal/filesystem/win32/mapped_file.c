@@ -0,0 +1,99 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include <windows.h>
+
+#include "hal_mapped_file.h"
+#include "lib_memory.h"
+
+struct sMappedFile {
+    HANDLE file;
+    HANDLE mapping;
+    uint8_t* buffer;
+};
+
+MappedFile
+MappedFile_open(const char* fileName, int size)
+{
+    MappedFile self = NULL;
+
+    HANDLE file = CreateFileA(fileName, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    /* the file is extended to the size of the mapping */
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, 0, (DWORD) size, NULL);
+
+    if (mapping != NULL) {
+        void* buffer = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T) size);
+
+        if (buffer != NULL) {
+            self = (MappedFile) GLOBAL_MALLOC(sizeof(struct sMappedFile));
+
+            if (self != NULL) {
+                self->file = file;
+                self->mapping = mapping;
+                self->buffer = (uint8_t*) buffer;
+            }
+            else
+                UnmapViewOfFile(buffer);
+        }
+
+        if (self == NULL)
+            CloseHandle(mapping);
+    }
+
+    if (self == NULL)
+        CloseHandle(file);
+
+    return self;
+}
+
+uint8_t*
+MappedFile_getBuffer(MappedFile self)
+{
+    return self->buffer;
+}
+
+bool
+MappedFile_sync(MappedFile self, int offset, int size)
+{
+    if (FlushViewOfFile(self->buffer + offset, (SIZE_T) size) == FALSE)
+        return false;
+
+    /* FlushViewOfFile doesn't wait until the data is written to the storage device */
+    return (FlushFileBuffers(self->file) != FALSE);
+}
+
+void
+MappedFile_close(MappedFile self)
+{
+    FlushViewOfFile(self->buffer, 0);
+    UnmapViewOfFile(self->buffer);
+    FlushFileBuffers(self->file);
+
+    CloseHandle(self->mapping);
+    CloseHandle(self->file);
+
+    GLOBAL_FREEMEM(self);
+}
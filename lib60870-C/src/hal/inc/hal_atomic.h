@@ -0,0 +1,117 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef HAL_ATOMIC_H_
+#define HAL_ATOMIC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \addtogroup hal
+   *
+   *  @{
+   */
+
+/**
+ * @defgroup HAL_ATOMIC Atomic operations
+ *
+ * Minimal set of atomic operations (with acquire/release semantics) used by the
+ * lock-free queues of the library. HAL_ATOMIC_AVAILABLE is set to 0 when the compiler
+ * provides no atomic operations (the lock-free queues are not used in this case).
+ *
+ * @{
+ */
+
+#if defined(_MSC_VER)
+
+#define HAL_ATOMIC_AVAILABLE 1
+
+#include <windows.h>
+
+static inline uint64_t
+Atomic_loadAcquire(volatile uint64_t* value)
+{
+    return (uint64_t) InterlockedCompareExchange64((volatile LONG64*) value, 0, 0);
+}
+
+static inline void
+Atomic_storeRelease(volatile uint64_t* value, uint64_t newValue)
+{
+    InterlockedExchange64((volatile LONG64*) value, (LONG64) newValue);
+}
+
+static inline bool
+Atomic_compareAndSwap(volatile uint64_t* value, uint64_t expected, uint64_t newValue)
+{
+    return (InterlockedCompareExchange64((volatile LONG64*) value, (LONG64) newValue, (LONG64) expected) == (LONG64) expected);
+}
+
+static inline int
+Atomic_exchange(volatile int* value, int newValue)
+{
+    return (int) InterlockedExchange((volatile LONG*) value, (LONG) newValue);
+}
+
+#elif defined(__GNUC__)
+
+#define HAL_ATOMIC_AVAILABLE 1
+
+static inline uint64_t
+Atomic_loadAcquire(volatile uint64_t* value)
+{
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+static inline void
+Atomic_storeRelease(volatile uint64_t* value, uint64_t newValue)
+{
+    __atomic_store_n(value, newValue, __ATOMIC_RELEASE);
+}
+
+static inline bool
+Atomic_compareAndSwap(volatile uint64_t* value, uint64_t expected, uint64_t newValue)
+{
+    return __atomic_compare_exchange_n(value, &expected, newValue, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+static inline int
+Atomic_exchange(volatile int* value, int newValue)
+{
+    return __atomic_exchange_n(value, newValue, __ATOMIC_ACQ_REL);
+}
+
+#else
+#define HAL_ATOMIC_AVAILABLE 0
+#endif
+
+/*! @} */
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_ATOMIC_H_ */
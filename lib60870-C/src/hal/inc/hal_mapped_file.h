@@ -0,0 +1,95 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef HAL_MAPPED_FILE_H_
+#define HAL_MAPPED_FILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \addtogroup hal
+   *
+   *  @{
+   */
+
+/**
+ * @defgroup HAL_MAPPED_FILE Memory mapped files (optional)
+ *
+ * @{
+ */
+
+typedef struct sMappedFile* MappedFile;
+
+/**
+ * \brief Open a file and map it into the memory
+ *
+ * The file is created when it doesn't exist and is extended to the given size when
+ * it is smaller. New parts of the file are filled with zeros. Changes of the mapped
+ * memory are written to the file (also when the process is terminated unexpectedly).
+ * When the operating system fails, only the parts written with MappedFile_sync are
+ * guaranteed to be stored in the file.
+ *
+ * \param fileName full name (path + filename) of the file
+ * \param size the size of the mapped memory in bytes
+ *
+ * \return a handle for the mapped file or NULL if opening or mapping the file fails
+ */
+MappedFile
+MappedFile_open(const char* fileName, int size);
+
+/**
+ * \brief Get the mapped memory of the file
+ */
+uint8_t*
+MappedFile_getBuffer(MappedFile self);
+
+/**
+ * \brief Write the changes of a part of the mapped memory to the file
+ *
+ * The function returns when the data is written to the storage device.
+ *
+ * \param offset the offset of the part in the mapped memory
+ * \param size the size of the part in bytes
+ *
+ * \return true if the data has been written, false otherwise
+ */
+bool
+MappedFile_sync(MappedFile self, int offset, int size);
+
+/**
+ * \brief Write all changes to the file and release the mapped memory
+ */
+void
+MappedFile_close(MappedFile self);
+
+/*! @} */
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_MAPPED_FILE_H_ */
@@ -79,7 +79,8 @@ Handleset_addSocket(HandleSet self, const Socket sock);
 /**
  * \brief wait for a socket to become ready
  *
- * This function is corresponding to the BSD socket select function.
+ * This function is corresponding to the BSD socket select function (implemented with poll on
+ * Linux and BSD - without the FD_SETSIZE limit).
  * It returns the number of sockets on which data is pending or 0 if no data is pending
  * on any of the monitored connections. The function will return after "timeout" ms if no
  * data is pending.
@@ -99,6 +100,169 @@ Handleset_waitReady(HandleSet self, unsigned int timeoutMs);
 void
 Handleset_destroy(HandleSet self);
 
+/** Opaque reference for a persistent set of monitored server and socket handles */
+typedef struct sPollSet* PollSet;
+
+/**
+ * \brief Create a new PollSet instance
+ *
+ * Other than the HandleSet the PollSet keeps the registered handles until they are
+ * removed. It is intended for event loops that have to monitor a large number of
+ * connections (implemented with epoll on Linux).
+ *
+ * \return new PollSet instance or NULL if the instance cannot be created
+ */
+PollSet
+PollSet_create(void);
+
+/**
+ * \brief add a socket to the PollSet
+ *
+ * \param self the PollSet instance
+ * \param sock the socket to add
+ * \param parameter user provided parameter that is returned by PollSet_getReadyParameter
+ *
+ * \return true if the socket has been added, false otherwise
+ */
+bool
+PollSet_addSocket(PollSet self, const Socket sock, void* parameter);
+
+/**
+ * \brief add a server socket to the PollSet
+ *
+ * The server socket becomes ready when a new connection is pending.
+ *
+ * \param self the PollSet instance
+ * \param sock the server socket to add
+ * \param parameter user provided parameter that is returned by PollSet_getReadyParameter
+ *
+ * \return true if the server socket has been added, false otherwise
+ */
+bool
+PollSet_addServerSocket(PollSet self, const ServerSocket sock, void* parameter);
+
+/**
+ * \brief select the readiness condition of a socket in the PollSet
+ *
+ * By default a socket becomes ready when data can be read. When waitForWritable is true
+ * the socket becomes ready when it can take more data instead (or when an error is pending).
+ *
+ * \param self the PollSet instance
+ * \param sock the socket that has been added before
+ * \param parameter the parameter that was provided when the socket was added
+ * \param waitForWritable true to wait until the socket is writable, false to wait for received data
+ *
+ * \return true if the readiness condition has been changed, false otherwise
+ */
+bool
+PollSet_setWaitForWritable(PollSet self, const Socket sock, void* parameter, bool waitForWritable);
+
+/**
+ * \brief remove a socket from the PollSet
+ *
+ * NOTE: has to be called before the socket is destroyed!
+ *
+ * \param self the PollSet instance
+ * \param sock the socket to remove
+ */
+void
+PollSet_removeSocket(PollSet self, const Socket sock);
+
+/**
+ * \brief wait until at least one of the registered handles becomes ready
+ *
+ * \param self the PollSet instance
+ * \param timeoutMs maximum time to wait in milliseconds (ms)
+ *
+ * \return the number of ready handles, 0 on timeout, or -1 in case of an error
+ */
+int
+PollSet_waitReady(PollSet self, unsigned int timeoutMs);
+
+/**
+ * \brief get the user provided parameter of a ready handle
+ *
+ * \param self the PollSet instance
+ * \param index the index of the ready handle (0 .. return value of PollSet_waitReady - 1)
+ *
+ * \return the parameter that was provided when the handle was added
+ */
+void*
+PollSet_getReadyParameter(PollSet self, int index);
+
+/**
+ * \brief destroy the PollSet instance
+ *
+ * The registered sockets are not closed.
+ *
+ * \param self the PollSet instance to destroy
+ */
+void
+PollSet_destroy(PollSet self);
+
+/** Opaque reference for a handle to wake up a thread that is waiting on a HandleSet or PollSet */
+typedef struct sWakeupHandle* WakeupHandle;
+
+/**
+ * \brief Create a new WakeupHandle instance
+ *
+ * A WakeupHandle becomes ready when it is signaled by another thread and remains ready
+ * until it is reset. It can be used to inform a thread that is waiting for socket events
+ * about new work (implemented with eventfd on Linux).
+ *
+ * Implementation of this function is OPTIONAL. Platforms without support shall return NULL.
+ * In this case the users have to fall back to polling.
+ *
+ * \return new WakeupHandle instance or NULL
+ */
+WakeupHandle
+WakeupHandle_create(void);
+
+/**
+ * \brief signal the handle (wake up the waiting thread)
+ *
+ * \param self the WakeupHandle instance (can be NULL)
+ */
+void
+WakeupHandle_signal(WakeupHandle self);
+
+/**
+ * \brief reset the handle after it has been signaled
+ *
+ * \param self the WakeupHandle instance (can be NULL)
+ */
+void
+WakeupHandle_reset(WakeupHandle self);
+
+/**
+ * \brief destroy the WakeupHandle instance
+ *
+ * \param self the WakeupHandle instance (can be NULL)
+ */
+void
+WakeupHandle_destroy(WakeupHandle self);
+
+/**
+ * \brief add a wakeup handle to an existing handle set
+ *
+ * \param self the HandleSet instance
+ * \param handle the wakeup handle to add (can be NULL)
+ */
+void
+Handleset_addWakeupHandle(HandleSet self, const WakeupHandle handle);
+
+/**
+ * \brief add a wakeup handle to the PollSet
+ *
+ * \param self the PollSet instance
+ * \param handle the wakeup handle to add
+ * \param parameter user provided parameter that is returned by PollSet_getReadyParameter
+ *
+ * \return true if the handle has been added, false otherwise
+ */
+bool
+PollSet_addWakeupHandle(PollSet self, const WakeupHandle handle, void* parameter);
+
 /**
  * \brief Create a new TcpServerSocket instance
  *
@@ -112,6 +276,21 @@ Handleset_destroy(HandleSet self);
 ServerSocket
 TcpServerSocket_create(const char* address, int port);
 
+/**
+ * \brief Create a new TcpServerSocket instance that can share the TCP port with other server sockets
+ *
+ * Multiple server sockets created with this function can be bound to the same address and port
+ * (SO_REUSEPORT). The operating system distributes the incoming connections between them.
+ *
+ * Implementation of this function is OPTIONAL. Platforms without support shall return NULL.
+ *
+ * \param address ip address or hostname to listen on
+ * \param port the TCP port to listen on
+ *
+ * \return the newly create TcpServerSocket instance or NULL
+ */
+ServerSocket
+TcpServerSocket_createShared(const char* address, int port);
 
 void
 ServerSocket_listen(ServerSocket self);
@@ -224,11 +403,37 @@ Socket_read(Socket self, uint8_t* buf, int size);
  *
  * \param self client, connection or server socket instance
  *
- * \return number of bytes transmitted of -1 in case of an error
+ * \return number of bytes transmitted of -1 in case of an error (0 when the socket cannot take more data)
  */
 int
 Socket_write(Socket self, uint8_t* buf, int size);
 
+/**
+ * \brief put the socket into non-blocking mode
+ *
+ * Afterwards \ref Socket_write returns immediately with the number of bytes the socket could take.
+ * Used for sockets that are handled by an event loop.
+ *
+ * \param self client or connection socket instance
+ */
+void
+Socket_setNonBlocking(Socket self);
+
+/**
+ * \brief wait until data can be written to the socket
+ *
+ * Used when \ref Socket_write returned less than the requested number of bytes.
+ *
+ * Implementation of this function is MANDATORY
+ *
+ * \param self client or connection socket instance
+ * \param timeoutMs maximum time to wait in ms
+ *
+ * \return true when data can be written (or an error is pending), false on timeout
+ */
+bool
+Socket_waitWritable(Socket self, unsigned int timeoutMs);
+
 /**
  * \brief Get the address of the peer application (IP address and port number)
  *
@@ -80,6 +80,19 @@ Thread_start(Thread thread);
 void
 Thread_destroy(Thread thread);
 
+/**
+ * \brief Bind a started Thread to a single CPU core
+ *
+ * Implementation of this function is OPTIONAL. Platforms without support shall return false.
+ *
+ * \param thread the Thread instance (has to be started before)
+ * \param cpu the index of the CPU core (starting with 0)
+ *
+ * \return true if the CPU affinity has been set, false otherwise
+ */
+bool
+Thread_setCpuAffinity(Thread thread, int cpu);
+
 /**
  * \brief Suspend execution of the Thread for the specified number of milliseconds
  */
@@ -93,6 +106,16 @@ Semaphore_create(int initialValue);
 void
 Semaphore_wait(Semaphore self);
 
+/**
+ * \brief Wait until the semaphore value is greater than zero or the timeout elapsed
+ *
+ * \param timeoutMs the maximum time to wait in ms
+ *
+ * \return true if the semaphore value has been decreased, false when the timeout elapsed
+ */
+bool
+Semaphore_timedWait(Semaphore self, unsigned int timeoutMs);
+
 void
 Semaphore_post(Semaphore self);
 
@@ -31,6 +31,7 @@
 #include <stdio.h>
 
 #include <fcntl.h>
+#include <poll.h>
 
 #include <netinet/tcp.h> // required for TCP keepalive
 
@@ -52,8 +53,9 @@ struct sServerSocket {
 };
 
 struct sHandleSet {
-   fd_set handles;
-   int maxHandle;
+   struct pollfd* fds;
+   int size;
+   int maxSize;
 };
 
 HandleSet
@@ -62,8 +64,9 @@ Handleset_new(void)
    HandleSet result = (HandleSet) GLOBAL_MALLOC(sizeof(struct sHandleSet));
 
    if (result != NULL) {
-       FD_ZERO(&result->handles);
-       result->maxHandle = -1;
+       result->fds = NULL;
+       result->size = 0;
+       result->maxSize = 0;
    }
    return result;
 }
@@ -71,20 +74,36 @@ Handleset_new(void)
 void
 Handleset_reset(HandleSet self)
 {
-    FD_ZERO(&self->handles);
-    self->maxHandle = -1;
+    self->size = 0;
 }
 
+static void
+Handleset_addFd(HandleSet self, int fd)
+{
+   if (self->size == self->maxSize) {
+       int newMaxSize = (self->maxSize == 0) ? 4 : (self->maxSize * 2);
+
+       struct pollfd* fds = (struct pollfd*) GLOBAL_REALLOC(self->fds, newMaxSize * sizeof(struct pollfd));
+
+       if (fds == NULL)
+           return;
+
+       self->fds = fds;
+       self->maxSize = newMaxSize;
+   }
+
+   self->fds[self->size].fd = fd;
+   self->fds[self->size].events = POLLIN;
+   self->fds[self->size].revents = 0;
+
+   self->size++;
+}
 
 void
 Handleset_addSocket(HandleSet self, const Socket sock)
 {
-   if (self != NULL && sock != NULL && sock->fd != -1) {
-       FD_SET(sock->fd, &self->handles);
-       if (sock->fd > self->maxHandle) {
-           self->maxHandle = sock->fd;
-       }
-   }
+   if (self != NULL && sock != NULL && sock->fd != -1)
+       Handleset_addFd(self, sock->fd);
 }
 
 int
@@ -92,12 +111,11 @@ Handleset_waitReady(HandleSet self, unsigned int timeoutMs)
 {
    int result;
 
-   if (self != NULL && self->maxHandle >= 0) {
-       struct timeval timeout;
+   if ((self != NULL) && (self->size > 0)) {
+       result = poll(self->fds, self->size, (int) timeoutMs);
 
-       timeout.tv_sec = timeoutMs / 1000;
-       timeout.tv_usec = (timeoutMs % 1000) * 1000;
-       result = select(self->maxHandle + 1, &self->handles, NULL, NULL, &timeout);
+       if ((result == -1) && (errno == EINTR))
+           result = 0;
    } else {
        result = -1;
    }
@@ -108,9 +126,248 @@ Handleset_waitReady(HandleSet self, unsigned int timeoutMs)
 void
 Handleset_destroy(HandleSet self)
 {
+   if (self->fds != NULL)
+       GLOBAL_FREEMEM(self->fds);
+
    GLOBAL_FREEMEM(self);
 }
 
+struct sPollSet {
+    struct pollfd* fds;
+    void** parameters;
+    int size;
+    int maxSize;
+
+    int* readyIndexes;
+    int readyCount;
+};
+
+PollSet
+PollSet_create(void)
+{
+    PollSet self = (PollSet) GLOBAL_CALLOC(1, sizeof(struct sPollSet));
+
+    return self;
+}
+
+static bool
+PollSet_addFd(PollSet self, int fd, void* parameter)
+{
+    if (fd == -1)
+        return false;
+
+    if (self->size == self->maxSize) {
+        int newMaxSize = (self->maxSize == 0) ? 16 : (self->maxSize * 2);
+
+        struct pollfd* fds = (struct pollfd*) GLOBAL_REALLOC(self->fds, newMaxSize * sizeof(struct pollfd));
+
+        if (fds == NULL)
+            return false;
+
+        self->fds = fds;
+
+        void** parameters = (void**) GLOBAL_REALLOC(self->parameters, newMaxSize * sizeof(void*));
+
+        if (parameters == NULL)
+            return false;
+
+        self->parameters = parameters;
+
+        int* readyIndexes = (int*) GLOBAL_REALLOC(self->readyIndexes, newMaxSize * sizeof(int));
+
+        if (readyIndexes == NULL)
+            return false;
+
+        self->readyIndexes = readyIndexes;
+
+        self->maxSize = newMaxSize;
+    }
+
+    self->fds[self->size].fd = fd;
+    self->fds[self->size].events = POLLIN;
+    self->fds[self->size].revents = 0;
+    self->parameters[self->size] = parameter;
+
+    self->size++;
+
+    return true;
+}
+
+bool
+PollSet_addSocket(PollSet self, const Socket sock, void* parameter)
+{
+    return PollSet_addFd(self, sock->fd, parameter);
+}
+
+bool
+PollSet_addServerSocket(PollSet self, const ServerSocket sock, void* parameter)
+{
+    return PollSet_addFd(self, sock->fd, parameter);
+}
+
+bool
+PollSet_setWaitForWritable(PollSet self, const Socket sock, void* parameter, bool waitForWritable)
+{
+    int i;
+
+    for (i = 0; i < self->size; i++) {
+        if (self->fds[i].fd == sock->fd) {
+            self->fds[i].events = waitForWritable ? POLLOUT : POLLIN;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+PollSet_removeSocket(PollSet self, const Socket sock)
+{
+    int i;
+
+    for (i = 0; i < self->size; i++) {
+        if (self->fds[i].fd == sock->fd) {
+            self->size--;
+
+            /* move last entry to the free position */
+            self->fds[i] = self->fds[self->size];
+            self->parameters[i] = self->parameters[self->size];
+
+            break;
+        }
+    }
+
+    self->readyCount = 0;
+}
+
+int
+PollSet_waitReady(PollSet self, unsigned int timeoutMs)
+{
+    self->readyCount = 0;
+
+    int result = poll(self->fds, self->size, (int) timeoutMs);
+
+    if (result > 0) {
+        int i;
+
+        for (i = 0; i < self->size; i++) {
+            if (self->fds[i].revents != 0)
+                self->readyIndexes[self->readyCount++] = i;
+        }
+
+        result = self->readyCount;
+    }
+    else if ((result == -1) && (errno == EINTR))
+        result = 0;
+
+    return result;
+}
+
+void*
+PollSet_getReadyParameter(PollSet self, int index)
+{
+    if ((index < 0) || (index >= self->readyCount))
+        return NULL;
+
+    return self->parameters[self->readyIndexes[index]];
+}
+
+void
+PollSet_destroy(PollSet self)
+{
+    if (self->fds != NULL)
+        GLOBAL_FREEMEM(self->fds);
+
+    if (self->parameters != NULL)
+        GLOBAL_FREEMEM(self->parameters);
+
+    if (self->readyIndexes != NULL)
+        GLOBAL_FREEMEM(self->readyIndexes);
+
+    GLOBAL_FREEMEM(self);
+}
+
+struct sWakeupHandle {
+    int readFd;
+    int writeFd;
+};
+
+WakeupHandle
+WakeupHandle_create(void)
+{
+    WakeupHandle self = (WakeupHandle) GLOBAL_MALLOC(sizeof(struct sWakeupHandle));
+
+    if (self != NULL) {
+        int fds[2];
+
+        if (pipe(fds) == -1) {
+            GLOBAL_FREEMEM(self);
+            return NULL;
+        }
+
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        fcntl(fds[1], F_SETFL, O_NONBLOCK);
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+        self->readFd = fds[0];
+        self->writeFd = fds[1];
+    }
+
+    return self;
+}
+
+void
+WakeupHandle_signal(WakeupHandle self)
+{
+    if (self != NULL) {
+        uint8_t value = 1;
+
+        /* when the pipe is full the handle is already signaled */
+        if (write(self->writeFd, &value, 1) == -1) {
+            if (DEBUG_SOCKET)
+                printf("SOCKET: failed to signal wakeup handle (errno=%i)\n", errno);
+        }
+    }
+}
+
+void
+WakeupHandle_reset(WakeupHandle self)
+{
+    if (self != NULL) {
+        uint8_t buffer[64];
+
+        while (read(self->readFd, buffer, sizeof(buffer)) > 0);
+    }
+}
+
+void
+WakeupHandle_destroy(WakeupHandle self)
+{
+    if (self != NULL) {
+        close(self->readFd);
+        close(self->writeFd);
+
+        GLOBAL_FREEMEM(self);
+    }
+}
+
+void
+Handleset_addWakeupHandle(HandleSet self, const WakeupHandle handle)
+{
+   if (self != NULL && handle != NULL)
+       Handleset_addFd(self, handle->readFd);
+}
+
+bool
+PollSet_addWakeupHandle(PollSet self, const WakeupHandle handle, void* parameter)
+{
+    if (handle == NULL)
+        return false;
+
+    return PollSet_addFd(self, handle->readFd, parameter);
+}
+
 #if (CONFIG_ACTIVATE_TCP_KEEPALIVE == 1)
 static void
 activateKeepAlive(int sd)
@@ -166,8 +423,8 @@ setSocketNonBlocking(Socket self)
     fcntl(self->fd, F_SETFL, flags | O_NONBLOCK);
 }
 
-ServerSocket
-TcpServerSocket_create(const char* address, int port)
+static ServerSocket
+createServerSocket(const char* address, int port, bool reusePort)
 {
     ServerSocket serverSocket = NULL;
 
@@ -184,6 +441,20 @@ TcpServerSocket_create(const char* address, int port)
         int optionReuseAddr = 1;
         setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (char *) &optionReuseAddr, sizeof(int));
 
+        if (reusePort) {
+#if defined(SO_REUSEPORT)
+            int optionReusePort = 1;
+
+            if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (char *) &optionReusePort, sizeof(int)) != 0) {
+                close(fd);
+                return NULL;
+            }
+#else
+            close(fd);
+            return NULL;
+#endif
+        }
+
         if (bind(fd, (struct sockaddr *) &serverAddress, sizeof(serverAddress)) >= 0) {
             serverSocket = GLOBAL_MALLOC(sizeof(struct sServerSocket));
             serverSocket->fd = fd;
@@ -204,6 +475,18 @@ TcpServerSocket_create(const char* address, int port)
     return serverSocket;
 }
 
+ServerSocket
+TcpServerSocket_create(const char* address, int port)
+{
+    return createServerSocket(address, port, false);
+}
+
+ServerSocket
+TcpServerSocket_createShared(const char* address, int port)
+{
+    return createServerSocket(address, port, true);
+}
+
 void
 ServerSocket_listen(ServerSocket self)
 {
@@ -428,7 +711,35 @@ Socket_write(Socket self, uint8_t* buf, int size)
         return -1;
 
     // MSG_NOSIGNAL - prevent send to signal SIGPIPE when peer unexpectedly closed the socket
-    return send(self->fd, buf, size, 0);
+    int bytesSent = send(self->fd, buf, size, 0);
+
+    if (bytesSent == -1) {
+        int error = errno;
+
+        /* nothing sent but the connection is still usable */
+        if ((error == EAGAIN) || (error == EWOULDBLOCK) || (error == EINTR))
+            return 0;
+    }
+
+    return bytesSent;
+}
+
+void
+Socket_setNonBlocking(Socket self)
+{
+    setSocketNonBlocking(self);
+}
+
+bool
+Socket_waitWritable(Socket self, unsigned int timeoutMs)
+{
+    struct pollfd fd;
+
+    fd.fd = self->fd;
+    fd.events = POLLOUT;
+    fd.revents = 0;
+
+    return (poll(&fd, 1, (int) timeoutMs) > 0);
 }
 
 void
@@ -31,6 +31,9 @@
 #include <stdio.h>
 
 #include <fcntl.h>
+#include <sys/epoll.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 
 #include <netinet/tcp.h> // required for TCP keepalive
 
@@ -52,8 +55,9 @@ struct sServerSocket {
 };
 
 struct sHandleSet {
-   fd_set handles;
-   int maxHandle;
+   struct pollfd* fds;
+   int size;
+   int maxSize;
 };
 
 HandleSet
@@ -62,8 +66,9 @@ Handleset_new(void)
    HandleSet result = (HandleSet) GLOBAL_MALLOC(sizeof(struct sHandleSet));
 
    if (result != NULL) {
-       FD_ZERO(&result->handles);
-       result->maxHandle = -1;
+       result->fds = NULL;
+       result->size = 0;
+       result->maxSize = 0;
    }
    return result;
 }
@@ -71,19 +76,36 @@ Handleset_new(void)
 void
 Handleset_reset(HandleSet self)
 {
-    FD_ZERO(&self->handles);
-    self->maxHandle = -1;
+    self->size = 0;
+}
+
+static void
+Handleset_addFd(HandleSet self, int fd)
+{
+   if (self->size == self->maxSize) {
+       int newMaxSize = (self->maxSize == 0) ? 4 : (self->maxSize * 2);
+
+       struct pollfd* fds = (struct pollfd*) GLOBAL_REALLOC(self->fds, newMaxSize * sizeof(struct pollfd));
+
+       if (fds == NULL)
+           return;
+
+       self->fds = fds;
+       self->maxSize = newMaxSize;
+   }
+
+   self->fds[self->size].fd = fd;
+   self->fds[self->size].events = POLLIN;
+   self->fds[self->size].revents = 0;
+
+   self->size++;
 }
 
 void
 Handleset_addSocket(HandleSet self, const Socket sock)
 {
-   if (self != NULL && sock != NULL && sock->fd != -1) {
-       FD_SET(sock->fd, &self->handles);
-       if (sock->fd > self->maxHandle) {
-           self->maxHandle = sock->fd;
-       }
-   }
+   if (self != NULL && sock != NULL && sock->fd != -1)
+       Handleset_addFd(self, sock->fd);
 }
 
 int
@@ -91,12 +113,11 @@ Handleset_waitReady(HandleSet self, unsigned int timeoutMs)
 {
    int result;
 
-   if ((self != NULL) && (self->maxHandle >= 0)) {
-       struct timeval timeout;
+   if ((self != NULL) && (self->size > 0)) {
+       result = poll(self->fds, self->size, (int) timeoutMs);
 
-       timeout.tv_sec = timeoutMs / 1000;
-       timeout.tv_usec = (timeoutMs % 1000) * 1000;
-       result = select(self->maxHandle + 1, &self->handles, NULL, NULL, &timeout);
+       if ((result == -1) && (errno == EINTR))
+           result = 0;
    } else {
        result = -1;
    }
@@ -107,9 +128,206 @@ Handleset_waitReady(HandleSet self, unsigned int timeoutMs)
 void
 Handleset_destroy(HandleSet self)
 {
+   if (self->fds != NULL)
+       GLOBAL_FREEMEM(self->fds);
+
    GLOBAL_FREEMEM(self);
 }
 
+#define POLLSET_MAX_EVENTS 64
+
+struct sPollSet {
+    int epollFd;
+    int readyCount;
+    struct epoll_event events[POLLSET_MAX_EVENTS];
+};
+
+PollSet
+PollSet_create(void)
+{
+    PollSet self = (PollSet) GLOBAL_MALLOC(sizeof(struct sPollSet));
+
+    if (self != NULL) {
+        self->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        self->readyCount = 0;
+
+        if (self->epollFd == -1) {
+            GLOBAL_FREEMEM(self);
+            self = NULL;
+        }
+    }
+
+    return self;
+}
+
+static bool
+PollSet_addFd(PollSet self, int fd, void* parameter)
+{
+    struct epoll_event event;
+
+    if (fd == -1)
+        return false;
+
+    memset(&event, 0, sizeof(struct epoll_event));
+
+    event.events = EPOLLIN;
+    event.data.ptr = parameter;
+
+    if (epoll_ctl(self->epollFd, EPOLL_CTL_ADD, fd, &event) == -1)
+        return false;
+
+    return true;
+}
+
+bool
+PollSet_addSocket(PollSet self, const Socket sock, void* parameter)
+{
+    return PollSet_addFd(self, sock->fd, parameter);
+}
+
+bool
+PollSet_addServerSocket(PollSet self, const ServerSocket sock, void* parameter)
+{
+    return PollSet_addFd(self, sock->fd, parameter);
+}
+
+bool
+PollSet_setWaitForWritable(PollSet self, const Socket sock, void* parameter, bool waitForWritable)
+{
+    struct epoll_event event;
+
+    if (sock->fd == -1)
+        return false;
+
+    memset(&event, 0, sizeof(struct epoll_event));
+
+    event.events = waitForWritable ? EPOLLOUT : EPOLLIN;
+    event.data.ptr = parameter;
+
+    if (epoll_ctl(self->epollFd, EPOLL_CTL_MOD, sock->fd, &event) == -1)
+        return false;
+
+    return true;
+}
+
+void
+PollSet_removeSocket(PollSet self, const Socket sock)
+{
+    if (sock->fd != -1) {
+        struct epoll_event event;
+
+        /* event argument is ignored but has to be non-NULL for older kernels */
+        epoll_ctl(self->epollFd, EPOLL_CTL_DEL, sock->fd, &event);
+    }
+}
+
+int
+PollSet_waitReady(PollSet self, unsigned int timeoutMs)
+{
+    int result = epoll_wait(self->epollFd, self->events, POLLSET_MAX_EVENTS, (int) timeoutMs);
+
+    if (result == -1) {
+        self->readyCount = 0;
+
+        if (errno == EINTR)
+            result = 0;
+    }
+    else
+        self->readyCount = result;
+
+    return result;
+}
+
+void*
+PollSet_getReadyParameter(PollSet self, int index)
+{
+    if ((index < 0) || (index >= self->readyCount))
+        return NULL;
+
+    return self->events[index].data.ptr;
+}
+
+void
+PollSet_destroy(PollSet self)
+{
+    close(self->epollFd);
+
+    GLOBAL_FREEMEM(self);
+}
+
+struct sWakeupHandle {
+    int fd;
+};
+
+WakeupHandle
+WakeupHandle_create(void)
+{
+    WakeupHandle self = (WakeupHandle) GLOBAL_MALLOC(sizeof(struct sWakeupHandle));
+
+    if (self != NULL) {
+        self->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (self->fd == -1) {
+            GLOBAL_FREEMEM(self);
+            self = NULL;
+        }
+    }
+
+    return self;
+}
+
+void
+WakeupHandle_signal(WakeupHandle self)
+{
+    if (self != NULL) {
+        uint64_t value = 1;
+
+        if (write(self->fd, &value, sizeof(value)) == -1) {
+            if (DEBUG_SOCKET)
+                printf("SOCKET: failed to signal wakeup handle (errno=%i)\n", errno);
+        }
+    }
+}
+
+void
+WakeupHandle_reset(WakeupHandle self)
+{
+    if (self != NULL) {
+        uint64_t value;
+
+        if (read(self->fd, &value, sizeof(value)) == -1) {
+            if (DEBUG_SOCKET)
+                printf("SOCKET: wakeup handle not signaled (errno=%i)\n", errno);
+        }
+    }
+}
+
+void
+WakeupHandle_destroy(WakeupHandle self)
+{
+    if (self != NULL) {
+        close(self->fd);
+
+        GLOBAL_FREEMEM(self);
+    }
+}
+
+void
+Handleset_addWakeupHandle(HandleSet self, const WakeupHandle handle)
+{
+   if (self != NULL && handle != NULL)
+       Handleset_addFd(self, handle->fd);
+}
+
+bool
+PollSet_addWakeupHandle(PollSet self, const WakeupHandle handle, void* parameter)
+{
+    if (handle == NULL)
+        return false;
+
+    return PollSet_addFd(self, handle->fd, parameter);
+}
+
 static bool
 prepareServerAddress(const char* address, int port, struct sockaddr_in* sockaddr)
 {
@@ -159,8 +377,8 @@ activateTcpNoDelay(Socket self)
     setsockopt(self->fd, IPPROTO_TCP, TCP_NODELAY, (char *) &flag, sizeof(int));
 }
 
-ServerSocket
-TcpServerSocket_create(const char* address, int port)
+static ServerSocket
+createServerSocket(const char* address, int port, bool reusePort)
 {
     ServerSocket serverSocket = NULL;
 
@@ -177,6 +395,20 @@ TcpServerSocket_create(const char* address, int port)
         int optionReuseAddr = 1;
         setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (char *) &optionReuseAddr, sizeof(int));
 
+        if (reusePort) {
+#if defined(SO_REUSEPORT)
+            int optionReusePort = 1;
+
+            if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (char *) &optionReusePort, sizeof(int)) != 0) {
+                close(fd);
+                return NULL;
+            }
+#else
+            close(fd);
+            return NULL;
+#endif
+        }
+
         if (bind(fd, (struct sockaddr *) &serverAddress, sizeof(serverAddress)) >= 0) {
             serverSocket = GLOBAL_MALLOC(sizeof(struct sServerSocket));
             serverSocket->fd = fd;
@@ -194,6 +426,18 @@ TcpServerSocket_create(const char* address, int port)
     return serverSocket;
 }
 
+ServerSocket
+TcpServerSocket_create(const char* address, int port)
+{
+    return createServerSocket(address, port, false);
+}
+
+ServerSocket
+TcpServerSocket_createShared(const char* address, int port)
+{
+    return createServerSocket(address, port, true);
+}
+
 void
 ServerSocket_listen(ServerSocket self)
 {
@@ -436,7 +680,35 @@ Socket_write(Socket self, uint8_t* buf, int size)
         return -1;
 
     // MSG_NOSIGNAL - prevent send to signal SIGPIPE when peer unexpectedly closed the socket
-    return send(self->fd, buf, size, MSG_NOSIGNAL);
+    int bytesSent = send(self->fd, buf, size, MSG_NOSIGNAL);
+
+    if (bytesSent == -1) {
+        int error = errno;
+
+        /* nothing sent but the connection is still usable */
+        if ((error == EAGAIN) || (error == EWOULDBLOCK) || (error == EINTR))
+            return 0;
+    }
+
+    return bytesSent;
+}
+
+void
+Socket_setNonBlocking(Socket self)
+{
+    setSocketNonBlocking(self);
+}
+
+bool
+Socket_waitWritable(Socket self, unsigned int timeoutMs)
+{
+    struct pollfd fd;
+
+    fd.fd = self->fd;
+    fd.events = POLLOUT;
+    fd.revents = 0;
+
+    return (poll(&fd, 1, (int) timeoutMs) > 0);
 }
 
 void
@@ -111,6 +111,228 @@ Handleset_destroy(HandleSet self)
    GLOBAL_FREEMEM(self);
 }
 
+struct sPollSet {
+    SOCKET* fds;
+    bool* waitForWritable;
+    void** parameters;
+    int size;
+    int maxSize;
+
+    int* readyIndexes;
+    int readyCount;
+};
+
+PollSet
+PollSet_create(void)
+{
+    PollSet self = (PollSet) GLOBAL_CALLOC(1, sizeof(struct sPollSet));
+
+    return self;
+}
+
+static bool
+PollSet_addFd(PollSet self, SOCKET fd, void* parameter)
+{
+    if (fd == INVALID_SOCKET)
+        return false;
+
+    /* select based implementation cannot handle more than FD_SETSIZE sockets */
+    if (self->size == FD_SETSIZE)
+        return false;
+
+    if (self->size == self->maxSize) {
+        int newMaxSize = (self->maxSize == 0) ? 16 : (self->maxSize * 2);
+
+        SOCKET* fds = (SOCKET*) GLOBAL_REALLOC(self->fds, newMaxSize * sizeof(SOCKET));
+
+        if (fds == NULL)
+            return false;
+
+        self->fds = fds;
+
+        bool* waitForWritable = (bool*) GLOBAL_REALLOC(self->waitForWritable, newMaxSize * sizeof(bool));
+
+        if (waitForWritable == NULL)
+            return false;
+
+        self->waitForWritable = waitForWritable;
+
+        void** parameters = (void**) GLOBAL_REALLOC(self->parameters, newMaxSize * sizeof(void*));
+
+        if (parameters == NULL)
+            return false;
+
+        self->parameters = parameters;
+
+        int* readyIndexes = (int*) GLOBAL_REALLOC(self->readyIndexes, newMaxSize * sizeof(int));
+
+        if (readyIndexes == NULL)
+            return false;
+
+        self->readyIndexes = readyIndexes;
+
+        self->maxSize = newMaxSize;
+    }
+
+    self->fds[self->size] = fd;
+    self->waitForWritable[self->size] = false;
+    self->parameters[self->size] = parameter;
+
+    self->size++;
+
+    return true;
+}
+
+bool
+PollSet_addSocket(PollSet self, const Socket sock, void* parameter)
+{
+    return PollSet_addFd(self, sock->fd, parameter);
+}
+
+bool
+PollSet_addServerSocket(PollSet self, const ServerSocket sock, void* parameter)
+{
+    return PollSet_addFd(self, sock->fd, parameter);
+}
+
+bool
+PollSet_setWaitForWritable(PollSet self, const Socket sock, void* parameter, bool waitForWritable)
+{
+    int i;
+
+    for (i = 0; i < self->size; i++) {
+        if (self->fds[i] == sock->fd) {
+            self->waitForWritable[i] = waitForWritable;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+PollSet_removeSocket(PollSet self, const Socket sock)
+{
+    int i;
+
+    for (i = 0; i < self->size; i++) {
+        if (self->fds[i] == sock->fd) {
+            self->size--;
+
+            /* move last entry to the free position */
+            self->fds[i] = self->fds[self->size];
+            self->waitForWritable[i] = self->waitForWritable[self->size];
+            self->parameters[i] = self->parameters[self->size];
+
+            break;
+        }
+    }
+
+    self->readyCount = 0;
+}
+
+int
+PollSet_waitReady(PollSet self, unsigned int timeoutMs)
+{
+    fd_set handles;
+    fd_set writeHandles;
+    struct timeval timeout;
+    int i;
+
+    self->readyCount = 0;
+
+    if (self->size == 0) {
+        Sleep(timeoutMs);
+        return 0;
+    }
+
+    FD_ZERO(&handles);
+    FD_ZERO(&writeHandles);
+
+    for (i = 0; i < self->size; i++) {
+        if (self->waitForWritable[i])
+            FD_SET(self->fds[i], &writeHandles);
+        else
+            FD_SET(self->fds[i], &handles);
+    }
+
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+
+    int result = select(0, &handles, &writeHandles, NULL, &timeout);
+
+    if (result > 0) {
+        for (i = 0; i < self->size; i++) {
+            if (FD_ISSET(self->fds[i], &handles) || FD_ISSET(self->fds[i], &writeHandles))
+                self->readyIndexes[self->readyCount++] = i;
+        }
+
+        result = self->readyCount;
+    }
+
+    return result;
+}
+
+void*
+PollSet_getReadyParameter(PollSet self, int index)
+{
+    if ((index < 0) || (index >= self->readyCount))
+        return NULL;
+
+    return self->parameters[self->readyIndexes[index]];
+}
+
+void
+PollSet_destroy(PollSet self)
+{
+    if (self->fds != NULL)
+        GLOBAL_FREEMEM(self->fds);
+
+    if (self->waitForWritable != NULL)
+        GLOBAL_FREEMEM(self->waitForWritable);
+
+    if (self->parameters != NULL)
+        GLOBAL_FREEMEM(self->parameters);
+
+    if (self->readyIndexes != NULL)
+        GLOBAL_FREEMEM(self->readyIndexes);
+
+    GLOBAL_FREEMEM(self);
+}
+
+/* not supported - the users fall back to polling */
+WakeupHandle
+WakeupHandle_create(void)
+{
+    return NULL;
+}
+
+void
+WakeupHandle_signal(WakeupHandle self)
+{
+}
+
+void
+WakeupHandle_reset(WakeupHandle self)
+{
+}
+
+void
+WakeupHandle_destroy(WakeupHandle self)
+{
+}
+
+void
+Handleset_addWakeupHandle(HandleSet self, const WakeupHandle handle)
+{
+}
+
+bool
+PollSet_addWakeupHandle(PollSet self, const WakeupHandle handle, void* parameter)
+{
+    return false;
+}
+
 static void
 activateKeepAlive(SOCKET s)
 {
@@ -224,6 +446,13 @@ TcpServerSocket_create(const char* address, int port)
 	return serverSocket;
 }
 
+ServerSocket
+TcpServerSocket_createShared(const char* address, int port)
+{
+    /* not supported */
+    return NULL;
+}
+
 void
 ServerSocket_listen(ServerSocket self)
 {
@@ -442,6 +671,27 @@ Socket_write(Socket self, uint8_t* buf, int size)
 	return bytes_sent;
 }
 
+void
+Socket_setNonBlocking(Socket self)
+{
+    setSocketNonBlocking(self);
+}
+
+bool
+Socket_waitWritable(Socket self, unsigned int timeoutMs)
+{
+    fd_set handles;
+    struct timeval timeout;
+
+    FD_ZERO(&handles);
+    FD_SET(self->fd, &handles);
+
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+
+    return (select(0, NULL, &handles, NULL, &timeout) > 0);
+}
+
 void
 Socket_destroy(Socket self)
 {
@@ -50,6 +50,23 @@ Semaphore_wait(Semaphore self)
     sem_wait((sem_t*) self);
 }
 
+bool
+Semaphore_timedWait(Semaphore self, unsigned int timeoutMs)
+{
+    /* sem_timedwait is not available for named semaphores on all systems */
+    unsigned int waitedMs = 0;
+
+    while (sem_trywait((sem_t*) self) != 0) {
+        if (waitedMs >= timeoutMs)
+            return false;
+
+        usleep(1000);
+        waitedMs++;
+    }
+
+    return true;
+}
+
 void
 Semaphore_post(Semaphore self)
 {
@@ -112,6 +129,13 @@ Thread_destroy(Thread thread)
    GLOBAL_FREEMEM(thread);
 }
 
+bool
+Thread_setCpuAffinity(Thread thread, int cpu)
+{
+    /* not supported */
+    return false;
+}
+
 void
 Thread_sleep(int millies)
 {
@@ -19,8 +19,15 @@
  *  See COPYING file for the complete license text.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* required for pthread_setaffinity_np */
+#endif
+
 #include <pthread.h>
+#include <sched.h>
 #include <semaphore.h>
+#include <time.h>
+#include <errno.h>
 #include <unistd.h>
 #include "hal_thread.h"
 #include "lib_memory.h"
@@ -51,6 +58,28 @@ Semaphore_wait(Semaphore self)
     sem_wait((sem_t*) self);
 }
 
+bool
+Semaphore_timedWait(Semaphore self, unsigned int timeoutMs)
+{
+    struct timespec timeout;
+
+    clock_gettime(CLOCK_REALTIME, &timeout);
+
+    timeout.tv_sec += timeoutMs / 1000;
+    timeout.tv_nsec += (long) (timeoutMs % 1000) * 1000000;
+
+    if (timeout.tv_nsec >= 1000000000) {
+        timeout.tv_sec++;
+        timeout.tv_nsec -= 1000000000;
+    }
+
+    int result;
+
+    while (((result = sem_timedwait((sem_t*) self, &timeout)) == -1) && (errno == EINTR));
+
+    return (result == 0);
+}
+
 void
 Semaphore_post(Semaphore self)
 {
@@ -114,6 +143,23 @@ Thread_destroy(Thread thread)
 	GLOBAL_FREEMEM(thread);
 }
 
+bool
+Thread_setCpuAffinity(Thread thread, int cpu)
+{
+    cpu_set_t cpuSet;
+
+    if ((thread->state != 1) || (cpu < 0) || (cpu >= CPU_SETSIZE))
+        return false;
+
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+
+    if (pthread_setaffinity_np(thread->pthread, sizeof(cpu_set_t), &cpuSet) == 0)
+        return true;
+    else
+        return false;
+}
+
 void
 Thread_sleep(int millies)
 {
@@ -91,6 +91,18 @@ Thread_destroy(Thread thread)
 	GLOBAL_FREEMEM(thread);
 }
 
+bool
+Thread_setCpuAffinity(Thread thread, int cpu)
+{
+	if ((cpu < 0) || (cpu >= (int) (sizeof(DWORD_PTR) * 8)))
+		return false;
+
+	if (SetThreadAffinityMask(thread->handle, ((DWORD_PTR) 1) << cpu) != 0)
+		return true;
+	else
+		return false;
+}
+
 void
 Thread_sleep(int millies)
 {
@@ -112,6 +124,12 @@ Semaphore_wait(Semaphore self)
     WaitForSingleObject((HANDLE) self, INFINITE);
 }
 
+bool
+Semaphore_timedWait(Semaphore self, unsigned int timeoutMs)
+{
+    return (WaitForSingleObject((HANDLE) self, (DWORD) timeoutMs) == WAIT_OBJECT_0);
+}
+
 void
 Semaphore_post(Semaphore self)
 {
@@ -21,32 +21,22 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "iec60870_common.h"
 #include "information_objects_internal.h"
 #include "apl_types_internal.h"
 #include "lib_memory.h"
 #include "lib60870_internal.h"
+#include "platform_endian.h"
+#include "sequence_decoder.h"
 
-struct sASDU {
-    bool stackCreated;
-    ConnectionParameters parameters;
-    uint8_t* asdu;
-    int asduHeaderLength;
-    uint8_t* payload;
-    int payloadSize;
-};
-
-typedef struct sStaticASDU* StaticASDU;
+struct sASDUPool {
+    int size;
+    struct sStaticASDU* asdus;
 
-struct sStaticASDU {
-    bool stackCreated;
-    ConnectionParameters parameters;
-    uint8_t* asdu;
-    int asduHeaderLength;
-    uint8_t* payload;
-    int payloadSize;
-    uint8_t encodedData[256];
+    int numberOfFreeASDUs;
+    StaticASDU* freeASDUs; /* stack of the ASDUs that are not in use */
 };
 
 typedef struct sASDUFrame* ASDUFrame;
@@ -101,61 +91,173 @@ struct sFrameVFT asduFrameVFT = {
         asduFrame_getSpaceLeft
 };
 
+static ASDU
+initializeASDU(StaticASDU self, ConnectionParameters parameters, IEC60870_5_TypeID typeId, bool isSequence, CauseOfTransmission cot,
+        int oa, int ca, bool isTest, bool isNegative)
+{
+    int asduHeaderLength = 2 + parameters->sizeOfCOT + parameters->sizeOfCA;
+
+    self->encodedData[0] = (uint8_t) typeId;
+
+    if (isSequence)
+        self->encodedData[1] = 0x80;
+    else
+        self->encodedData[1] = 0;
+
+    self->encodedData[2] = (uint8_t) (cot & 0x3f);
+
+    if (isTest)
+        self->encodedData[2] |= 0x80;
+
+    if (isNegative)
+        self->encodedData[2] |= 0x40;
+
+    int caIndex;
+
+    if (parameters->sizeOfCOT > 1) {
+        self->encodedData[3] = (uint8_t) oa;
+        caIndex = 4;
+    }
+    else
+        caIndex = 3;
+
+    self->encodedData[caIndex] = ca % 0x100;
+
+    if (parameters->sizeOfCA > 1)
+        self->encodedData[caIndex + 1] = ca / 0x100;
+
+    self->asdu = self->encodedData;
+    self->asduHeaderLength = asduHeaderLength;
+    self->payload = self->encodedData + asduHeaderLength;
+    self->payloadSize = 0;
+    self->parameters = parameters;
+    self->pool = NULL;
+
+    return (ASDU) self;
+}
+
 ASDU
 ASDU_create(ConnectionParameters parameters, IEC60870_5_TypeID typeId, bool isSequence, CauseOfTransmission cot, int oa, int ca,
         bool isTest, bool isNegative)
 {
     StaticASDU self = (StaticASDU) GLOBAL_MALLOC(sizeof(struct sStaticASDU));
-    //TODO support allocation from static pool
 
     if (self != NULL) {
         self->stackCreated = false;
 
-        int asduHeaderLength = 2 + parameters->sizeOfCOT + parameters->sizeOfCA;
+        initializeASDU(self, parameters, typeId, isSequence, cot, oa, ca, isTest, isNegative);
+    }
 
-        self->encodedData[0] = (uint8_t) typeId;
+    return (ASDU) self;
+}
 
-        if (isSequence)
-            self->encodedData[1] = 0x80;
-        else
-            self->encodedData[1] = 0;
+ASDU
+ASDU_initializeStatic(StaticASDU self, ConnectionParameters parameters, IEC60870_5_TypeID typeId, bool isSequence,
+        CauseOfTransmission cot, int oa, int ca, bool isTest, bool isNegative)
+{
+    self->stackCreated = true;
 
-        self->encodedData[2] = (uint8_t) (cot & 0x3f);
+    return initializeASDU(self, parameters, typeId, isSequence, cot, oa, ca, isTest, isNegative);
+}
+
+ASDU
+ASDU_initializeStaticFromBuffer(StaticASDU self, ConnectionParameters parameters, const uint8_t* msg, int msgLength)
+{
+    int asduHeaderLength = 2 + parameters->sizeOfCOT + parameters->sizeOfCA;
+
+    if ((msgLength < asduHeaderLength) || (msgLength > IEC60870_5_104_MAX_ASDU_LENGTH))
+        return NULL;
+
+    memcpy(self->encodedData, msg, msgLength);
+
+    self->stackCreated = true;
+    self->parameters = parameters;
+    self->asdu = self->encodedData;
+    self->asduHeaderLength = asduHeaderLength;
+    self->payload = self->encodedData + asduHeaderLength;
+    self->payloadSize = msgLength - asduHeaderLength;
+    self->pool = NULL;
+
+    return (ASDU) self;
+}
+
+void
+ASDU_reset(ASDU self)
+{
+    /* keep the SQ bit */
+    self->asdu[1] &= 0x80;
 
-        if (isTest)
-            self->encodedData[2] |= 0x80;
+    self->payloadSize = 0;
+}
 
-        if (isNegative)
-            self->encodedData[2] |= 0x40;
+void
+ASDU_destroy(ASDU self)
+{
+    ASDUPool pool = self->pool;
 
-        int caIndex;
+    if (pool != NULL)
+        pool->freeASDUs[pool->numberOfFreeASDUs++] = (StaticASDU) self;
+    else
+        GLOBAL_FREEMEM(self);
+}
+
+ASDUPool
+ASDUPool_create(int size)
+{
+    ASDUPool self = (ASDUPool) GLOBAL_MALLOC(sizeof(struct sASDUPool));
 
-        if (parameters->sizeOfCOT > 1) {
-            self->encodedData[3] = (uint8_t) oa;
-            caIndex = 4;
+    if (self != NULL) {
+        self->size = size;
+        self->asdus = (struct sStaticASDU*) GLOBAL_MALLOC(sizeof(struct sStaticASDU) * size);
+        self->freeASDUs = (StaticASDU*) GLOBAL_MALLOC(sizeof(StaticASDU) * size);
+
+        if ((self->asdus == NULL) || (self->freeASDUs == NULL)) {
+            ASDUPool_destroy(self);
+            return NULL;
         }
-        else
-            caIndex = 3;
 
-        self->encodedData[caIndex] = ca % 0x100;
+        int i;
 
-        if (parameters->sizeOfCA > 1)
-            self->encodedData[caIndex + 1] = ca / 0x100;
+        for (i = 0; i < size; i++)
+            self->freeASDUs[i] = &(self->asdus[i]);
 
-        self->asdu = self->encodedData;
-        self->asduHeaderLength = asduHeaderLength;
-        self->payload = self->encodedData + asduHeaderLength;
-        self->payloadSize = 0;
-        self->parameters = parameters;
+        self->numberOfFreeASDUs = size;
     }
 
-    return (ASDU) self;
+    return self;
 }
 
 void
-ASDU_destroy(ASDU self)
+ASDUPool_destroy(ASDUPool self)
 {
-    GLOBAL_FREEMEM(self);
+    if (self != NULL) {
+
+        if (self->asdus != NULL)
+            GLOBAL_FREEMEM(self->asdus);
+
+        if (self->freeASDUs != NULL)
+            GLOBAL_FREEMEM(self->freeASDUs);
+
+        GLOBAL_FREEMEM(self);
+    }
+}
+
+ASDU
+ASDUPool_createASDU(ASDUPool self, ConnectionParameters parameters, IEC60870_5_TypeID typeId, bool isSequence,
+        CauseOfTransmission cot, int oa, int ca, bool isTest, bool isNegative)
+{
+    if (self->numberOfFreeASDUs == 0)
+        return ASDU_create(parameters, typeId, isSequence, cot, oa, ca, isTest, isNegative);
+
+    StaticASDU asdu = self->freeASDUs[--(self->numberOfFreeASDUs)];
+
+    asdu->stackCreated = false;
+
+    initializeASDU(asdu, parameters, typeId, isSequence, cot, oa, ca, isTest, isNegative);
+
+    asdu->pool = self;
+
+    return (ASDU) asdu;
 }
 
 bool
@@ -170,6 +272,12 @@ ASDU_encode(ASDU self, Frame frame)
     Frame_appendBytes(frame, self->asdu, self->asduHeaderLength + self->payloadSize);
 }
 
+int
+ASDU_getEncodedSize(ASDU self)
+{
+    return self->asduHeaderLength + self->payloadSize;
+}
+
 ASDU
 ASDU_createFromBuffer(ConnectionParameters parameters, uint8_t* msg, int msgLength)
 {
@@ -179,19 +287,30 @@ ASDU_createFromBuffer(ConnectionParameters parameters, uint8_t* msg, int msgLeng
         return NULL;
 
     ASDU self = (ASDU) GLOBAL_MALLOC(sizeof(struct sASDU));
-    //TODO support allocation from static pool
 
-    if (self != NULL) {
+    if (self != NULL)
+        ASDU_initializeFromBuffer(self, parameters, msg, msgLength);
 
-        self->stackCreated = true;
-        self->parameters = parameters;
+    return self;
+}
 
-        self->asdu = msg;
-        self->asduHeaderLength = asduHeaderLength;
+ASDU
+ASDU_initializeFromBuffer(ASDU self, ConnectionParameters parameters, uint8_t* msg, int msgLength)
+{
+    int asduHeaderLength = 2 + parameters->sizeOfCOT + parameters->sizeOfCA;
 
-        self->payload = msg + asduHeaderLength;
-        self->payloadSize = msgLength - asduHeaderLength;
-    }
+    if (msgLength < asduHeaderLength)
+        return NULL;
+
+    self->stackCreated = true;
+    self->parameters = parameters;
+
+    self->asdu = msg;
+    self->asduHeaderLength = asduHeaderLength;
+
+    self->payload = msg + asduHeaderLength;
+    self->payloadSize = msgLength - asduHeaderLength;
+    self->pool = NULL;
 
     return self;
 }
@@ -245,6 +364,23 @@ ASDU_addInformationObject(ASDU self, InformationObject io)
     return encoded;
 }
 
+bool
+ASDU_addEncodedObjects(ASDU self, const uint8_t* objects, int size, int numberOfObjects)
+{
+    if ((self->asduHeaderLength + self->payloadSize + size) > IEC60870_5_104_MAX_ASDU_LENGTH)
+        return false;
+
+    if ((ASDU_getNumberOfElements(self) + numberOfObjects) > 127)
+        return false;
+
+    memcpy(self->payload + self->payloadSize, objects, size);
+
+    self->payloadSize += size;
+    self->asdu[1] += (uint8_t) numberOfObjects;
+
+    return true;
+}
+
 bool
 ASDU_isTest(ASDU self)
 {
@@ -287,7 +423,7 @@ ASDU_getOA(ASDU self)
     if (self->parameters->sizeOfCOT < 2)
         return -1;
     else
-        return (int) self->asdu[4];
+        return (int) self->asdu[3];
 }
 
 CauseOfTransmission
@@ -339,8 +475,8 @@ ASDU_getNumberOfElements(ASDU self)
     return (self->asdu[1] & 0x7f);
 }
 
-InformationObject
-ASDU_getElement(ASDU self, int index)
+static InformationObject
+decodeElement(ASDU self, InformationObject io, int index)
 {
     InformationObject retVal = NULL;
 
@@ -353,13 +489,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 1;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) SinglePointInformation_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) SinglePointInformation_getFromBuffer((SinglePointInformation) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) SinglePointInformation_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) SinglePointInformation_getFromBuffer((SinglePointInformation) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -369,13 +505,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 4;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) SinglePointWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) SinglePointWithCP24Time2a_getFromBuffer((SinglePointWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) SinglePointWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) SinglePointWithCP24Time2a_getFromBuffer((SinglePointWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -385,13 +521,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 1;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) DoublePointInformation_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) DoublePointInformation_getFromBuffer((DoublePointInformation) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) DoublePointInformation_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) DoublePointInformation_getFromBuffer((DoublePointInformation) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
 
@@ -402,13 +538,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 4;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) DoublePointWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) DoublePointWithCP24Time2a_getFromBuffer((DoublePointWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) DoublePointWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) DoublePointWithCP24Time2a_getFromBuffer((DoublePointWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -418,13 +554,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 2;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) StepPositionInformation_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) StepPositionInformation_getFromBuffer((StepPositionInformation) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) StepPositionInformation_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) StepPositionInformation_getFromBuffer((StepPositionInformation) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -434,13 +570,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 5;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) StepPositionWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) StepPositionWithCP24Time2a_getFromBuffer((StepPositionWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) StepPositionWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) StepPositionWithCP24Time2a_getFromBuffer((StepPositionWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -450,13 +586,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 5;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) BitString32_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) BitString32_getFromBuffer((BitString32) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) BitString32_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) BitString32_getFromBuffer((BitString32) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -466,13 +602,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 8;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) Bitstring32WithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) Bitstring32WithCP24Time2a_getFromBuffer((Bitstring32WithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) Bitstring32WithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) Bitstring32WithCP24Time2a_getFromBuffer((Bitstring32WithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -482,13 +618,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 3;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueNormalized_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueNormalized_getFromBuffer((MeasuredValueNormalized) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) MeasuredValueNormalized_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueNormalized_getFromBuffer((MeasuredValueNormalized) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -498,13 +634,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 6;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueNormalizedWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueNormalizedWithCP24Time2a_getFromBuffer((MeasuredValueNormalizedWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) MeasuredValueNormalizedWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueNormalizedWithCP24Time2a_getFromBuffer((MeasuredValueNormalizedWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -514,13 +650,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 3;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueScaled_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueScaled_getFromBuffer((MeasuredValueScaled) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) MeasuredValueScaled_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueScaled_getFromBuffer((MeasuredValueScaled) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -530,13 +666,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 6;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueScaledWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueScaledWithCP24Time2a_getFromBuffer((MeasuredValueScaledWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) MeasuredValueScaledWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueScaledWithCP24Time2a_getFromBuffer((MeasuredValueScaledWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -547,13 +683,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 5;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueShort_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueShort_getFromBuffer((MeasuredValueShort) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) MeasuredValueShort_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueShort_getFromBuffer((MeasuredValueShort) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
 
@@ -564,13 +700,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 8;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueShortWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueShortWithCP24Time2a_getFromBuffer((MeasuredValueShortWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) MeasuredValueShortWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueShortWithCP24Time2a_getFromBuffer((MeasuredValueShortWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -580,13 +716,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 5;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) IntegratedTotals_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) IntegratedTotals_getFromBuffer((IntegratedTotals) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) IntegratedTotals_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) IntegratedTotals_getFromBuffer((IntegratedTotals) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -596,13 +732,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 8;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) IntegratedTotalsWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) IntegratedTotalsWithCP24Time2a_getFromBuffer((IntegratedTotalsWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) IntegratedTotalsWithCP24Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) IntegratedTotalsWithCP24Time2a_getFromBuffer((IntegratedTotalsWithCP24Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -612,13 +748,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 6;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) EventOfProtectionEquipment_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) EventOfProtectionEquipment_getFromBuffer((EventOfProtectionEquipment) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) EventOfProtectionEquipment_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) EventOfProtectionEquipment_getFromBuffer((EventOfProtectionEquipment) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -628,13 +764,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 7;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipment_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipment_getFromBuffer((PackedStartEventsOfProtectionEquipment) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipment_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipment_getFromBuffer((PackedStartEventsOfProtectionEquipment) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -644,13 +780,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 7;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) PackedOutputCircuitInfo_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) PackedOutputCircuitInfo_getFromBuffer((PackedOutputCircuitInfo) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) PackedOutputCircuitInfo_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) PackedOutputCircuitInfo_getFromBuffer((PackedOutputCircuitInfo) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -660,13 +796,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 5;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) PackedSinglePointWithSCD_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) PackedSinglePointWithSCD_getFromBuffer((PackedSinglePointWithSCD) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) PackedSinglePointWithSCD_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) PackedSinglePointWithSCD_getFromBuffer((PackedSinglePointWithSCD) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -676,13 +812,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 2;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueNormalizedWithoutQuality_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueNormalizedWithoutQuality_getFromBuffer((MeasuredValueNormalizedWithoutQuality) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) MeasuredValueNormalizedWithoutQuality_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueNormalizedWithoutQuality_getFromBuffer((MeasuredValueNormalizedWithoutQuality) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -692,13 +828,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 8;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) SinglePointWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) SinglePointWithCP56Time2a_getFromBuffer((SinglePointWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) SinglePointWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) SinglePointWithCP56Time2a_getFromBuffer((SinglePointWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -708,13 +844,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 8;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) DoublePointWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) DoublePointWithCP56Time2a_getFromBuffer((DoublePointWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) DoublePointWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) DoublePointWithCP56Time2a_getFromBuffer((DoublePointWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -724,13 +860,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 9;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) StepPositionWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) StepPositionWithCP56Time2a_getFromBuffer((StepPositionWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) StepPositionWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) StepPositionWithCP56Time2a_getFromBuffer((StepPositionWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -740,13 +876,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 12;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) Bitstring32WithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) Bitstring32WithCP56Time2a_getFromBuffer((Bitstring32WithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) Bitstring32WithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) Bitstring32WithCP56Time2a_getFromBuffer((Bitstring32WithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -756,13 +892,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 10;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueNormalizedWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueNormalizedWithCP56Time2a_getFromBuffer((MeasuredValueNormalizedWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) MeasuredValueNormalizedWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueNormalizedWithCP56Time2a_getFromBuffer((MeasuredValueNormalizedWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -772,13 +908,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 10;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueScaledWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueScaledWithCP56Time2a_getFromBuffer((MeasuredValueScaledWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) MeasuredValueScaledWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueScaledWithCP56Time2a_getFromBuffer((MeasuredValueScaledWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -788,13 +924,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 12;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueShortWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueShortWithCP56Time2a_getFromBuffer((MeasuredValueShortWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) MeasuredValueShortWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) MeasuredValueShortWithCP56Time2a_getFromBuffer((MeasuredValueShortWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -804,13 +940,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 12;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) IntegratedTotalsWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) IntegratedTotalsWithCP56Time2a_getFromBuffer((IntegratedTotalsWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) IntegratedTotalsWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) IntegratedTotalsWithCP56Time2a_getFromBuffer((IntegratedTotalsWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -820,13 +956,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 10;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) EventOfProtectionEquipmentWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) EventOfProtectionEquipmentWithCP56Time2a_getFromBuffer((EventOfProtectionEquipmentWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) EventOfProtectionEquipmentWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) EventOfProtectionEquipmentWithCP56Time2a_getFromBuffer((EventOfProtectionEquipmentWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -836,13 +972,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 11;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getFromBuffer((PackedStartEventsOfProtectionEquipmentWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getFromBuffer((PackedStartEventsOfProtectionEquipmentWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -852,13 +988,13 @@ ASDU_getElement(ASDU self, int index)
         elementSize = 11;
 
         if (ASDU_isSequence(self)) {
-            retVal  = (InformationObject) PackedOutputCircuitInfoWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) PackedOutputCircuitInfoWithCP56Time2a_getFromBuffer((PackedOutputCircuitInfoWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
 
             InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
         }
         else
-            retVal  = (InformationObject) PackedOutputCircuitInfoWithCP56Time2a_getFromBuffer(NULL, self->parameters,
+            retVal  = (InformationObject) PackedOutputCircuitInfoWithCP56Time2a_getFromBuffer((PackedOutputCircuitInfoWithCP56Time2a) io, self->parameters,
                     self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
 
         break;
@@ -869,7 +1005,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 1;
 
-        retVal = (InformationObject) SingleCommand_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) SingleCommand_getFromBuffer((SingleCommand) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -878,7 +1014,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 1;
 
-        retVal = (InformationObject) DoubleCommand_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) DoubleCommand_getFromBuffer((DoubleCommand) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -886,7 +1022,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 1;
 
-        retVal = (InformationObject) StepCommand_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) StepCommand_getFromBuffer((StepCommand) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -894,7 +1030,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 3;
 
-        retVal = (InformationObject) SetpointCommandNormalized_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) SetpointCommandNormalized_getFromBuffer((SetpointCommandNormalized) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -903,7 +1039,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 3;
 
-        retVal = (InformationObject) SetpointCommandScaled_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) SetpointCommandScaled_getFromBuffer((SetpointCommandScaled) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -911,7 +1047,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 5;
 
-        retVal = (InformationObject) SetpointCommandShort_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) SetpointCommandShort_getFromBuffer((SetpointCommandShort) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -919,7 +1055,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 4;
 
-        retVal = (InformationObject) Bitstring32Command_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) Bitstring32Command_getFromBuffer((Bitstring32Command) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -929,7 +1065,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 8;
 
-        retVal = (InformationObject) SingleCommandWithCP56Time2a_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) SingleCommandWithCP56Time2a_getFromBuffer((SingleCommandWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -937,7 +1073,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 8;
 
-        retVal = (InformationObject) DoubleCommandWithCP56Time2a_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) DoubleCommandWithCP56Time2a_getFromBuffer((DoubleCommandWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -945,7 +1081,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 8;
 
-        retVal = (InformationObject) StepCommandWithCP56Time2a_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) StepCommandWithCP56Time2a_getFromBuffer((StepCommandWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -953,7 +1089,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 10;
 
-        retVal = (InformationObject) SetpointCommandNormalizedWithCP56Time2a_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) SetpointCommandNormalizedWithCP56Time2a_getFromBuffer((SetpointCommandNormalizedWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -961,7 +1097,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 10;
 
-        retVal = (InformationObject) SetpointCommandScaledWithCP56Time2a_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) SetpointCommandScaledWithCP56Time2a_getFromBuffer((SetpointCommandScaledWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -969,7 +1105,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 12;
 
-        retVal = (InformationObject) SetpointCommandShortWithCP56Time2a_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) SetpointCommandShortWithCP56Time2a_getFromBuffer((SetpointCommandShortWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -977,7 +1113,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 11;
 
-        retVal = (InformationObject) Bitstring32CommandWithCP56Time2a_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) Bitstring32CommandWithCP56Time2a_getFromBuffer((Bitstring32CommandWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -985,43 +1121,43 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 1;
 
-        retVal = (InformationObject) EndOfInitialization_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  0);
+        retVal = (InformationObject) EndOfInitialization_getFromBuffer((EndOfInitialization) io, self->parameters, self->payload, self->payloadSize,  0);
 
         break;
 
     case C_IC_NA_1: /* 100 - Interrogation command */
 
-        retVal = (InformationObject) InterrogationCommand_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  0);
+        retVal = (InformationObject) InterrogationCommand_getFromBuffer((InterrogationCommand) io, self->parameters, self->payload, self->payloadSize,  0);
 
         break;
 
     case C_CI_NA_1: /* 101 - Counter interrogation command */
 
-        retVal = (InformationObject) CounterInterrogationCommand_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  0);
+        retVal = (InformationObject) CounterInterrogationCommand_getFromBuffer((CounterInterrogationCommand) io, self->parameters, self->payload, self->payloadSize,  0);
 
         break;
 
     case C_RD_NA_1: /* 102 - Read command */
 
-        retVal = (InformationObject) ReadCommand_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  0);
+        retVal = (InformationObject) ReadCommand_getFromBuffer((ReadCommand) io, self->parameters, self->payload, self->payloadSize,  0);
 
         break;
 
     case C_CS_NA_1: /* 103 - Clock synchronization command */
 
-        retVal = (InformationObject) ClockSynchronizationCommand_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  0);
+        retVal = (InformationObject) ClockSynchronizationCommand_getFromBuffer((ClockSynchronizationCommand) io, self->parameters, self->payload, self->payloadSize,  0);
 
         break;
 
     case C_RP_NA_1: /* 105 - Reset process command */
 
-        retVal = (InformationObject) ResetProcessCommand_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  0);
+        retVal = (InformationObject) ResetProcessCommand_getFromBuffer((ResetProcessCommand) io, self->parameters, self->payload, self->payloadSize,  0);
 
         break;
 
     case C_CD_NA_1: /* 106 - Delay acquisition command */
 
-        retVal = (InformationObject) DelayAcquisitionCommand_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  0);
+        retVal = (InformationObject) DelayAcquisitionCommand_getFromBuffer((DelayAcquisitionCommand) io, self->parameters, self->payload, self->payloadSize,  0);
 
         break;
 
@@ -1029,7 +1165,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 3;
 
-        retVal = (InformationObject) ParameterNormalizedValue_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) ParameterNormalizedValue_getFromBuffer((ParameterNormalizedValue) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -1037,7 +1173,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 3;
 
-        retVal = (InformationObject) ParameterScaledValue_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) ParameterScaledValue_getFromBuffer((ParameterScaledValue) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -1045,7 +1181,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 5;
 
-        retVal = (InformationObject) ParameterFloatValue_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) ParameterFloatValue_getFromBuffer((ParameterFloatValue) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
 
@@ -1053,7 +1189,7 @@ ASDU_getElement(ASDU self, int index)
 
         elementSize = self->parameters->sizeOfIOA + 1;
 
-        retVal = (InformationObject) ParameterActivation_getFromBuffer(NULL, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+        retVal = (InformationObject) ParameterActivation_getFromBuffer((ParameterActivation) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
 
         break;
     }
@@ -1061,6 +1197,262 @@ ASDU_getElement(ASDU self, int index)
     return retVal;
 }
 
+InformationObject
+ASDU_getElement(ASDU self, int index)
+{
+    return decodeElement(self, NULL, index);
+}
+
+InformationObject
+ASDU_getElementEx(ASDU self, StaticInformationObject io, int index)
+{
+    return decodeElement(self, (InformationObject) io, index);
+}
+
+typedef enum {
+    BATCH_VALUE_SINGLE_POINT,
+    BATCH_VALUE_DOUBLE_POINT,
+    BATCH_VALUE_BITSTRING,
+    BATCH_VALUE_NORMALIZED,
+    BATCH_VALUE_NORMALIZED_WITHOUT_QUALITY,
+    BATCH_VALUE_SCALED,
+    BATCH_VALUE_SHORT
+} BatchValueType;
+
+static void
+decodeBatchValues(BatchValueType valueType, uint8_t* data, int stride, int numberOfElements, double* value)
+{
+    int i;
+
+    switch (valueType) {
+
+    case BATCH_VALUE_SINGLE_POINT:
+        for (i = 0; i < numberOfElements; i++)
+            value[i] = (double) (data[i * stride] & 0x01);
+        break;
+
+    case BATCH_VALUE_DOUBLE_POINT:
+        for (i = 0; i < numberOfElements; i++)
+            value[i] = (double) (data[i * stride] & 0x03);
+        break;
+
+    case BATCH_VALUE_BITSTRING:
+        for (i = 0; i < numberOfElements; i++) {
+            uint8_t* element = data + (i * stride);
+
+            value[i] = (double) ((uint32_t) element[0] + ((uint32_t) element[1] << 8) +
+                    ((uint32_t) element[2] << 16) + ((uint32_t) element[3] << 24));
+        }
+        break;
+
+    case BATCH_VALUE_NORMALIZED:
+        /* same conversion as MeasuredValueNormalized_getValue */
+        for (i = 0; i < numberOfElements; i++) {
+            uint8_t* element = data + (i * stride);
+
+            value[i] = (double) ((float) ((int16_t) (element[0] + (element[1] << 8))) / 32767.f);
+        }
+        break;
+
+    case BATCH_VALUE_NORMALIZED_WITHOUT_QUALITY:
+        /* same conversion as MeasuredValueNormalizedWithoutQuality_getValue */
+        for (i = 0; i < numberOfElements; i++) {
+            uint8_t* element = data + (i * stride);
+
+            value[i] = (double) ((float) ((int16_t) (element[0] + (element[1] << 8)) + 0.5) / 32767.5f);
+        }
+        break;
+
+    case BATCH_VALUE_SCALED:
+        for (i = 0; i < numberOfElements; i++) {
+            uint8_t* element = data + (i * stride);
+
+            value[i] = (double) ((int16_t) (element[0] + (element[1] << 8)));
+        }
+        break;
+
+    case BATCH_VALUE_SHORT:
+        for (i = 0; i < numberOfElements; i++) {
+            uint8_t* element = data + (i * stride);
+
+            float floatValue;
+            uint8_t* valueBytes = (uint8_t*) &floatValue;
+
+#if (ORDER_LITTLE_ENDIAN == 1)
+            valueBytes[0] = element[0];
+            valueBytes[1] = element[1];
+            valueBytes[2] = element[2];
+            valueBytes[3] = element[3];
+#else
+            valueBytes[3] = element[0];
+            valueBytes[2] = element[1];
+            valueBytes[1] = element[2];
+            valueBytes[0] = element[3];
+#endif
+
+            value[i] = (double) floatValue;
+        }
+        break;
+    }
+}
+
+int
+ASDU_decodeBatch(ASDU self, int* ioa, double* value, QualityDescriptor* quality, uint64_t* timestamp, int maxElements)
+{
+    BatchValueType valueType;
+    int dataSize; /* size of value and quality (without IOA and time tag) */
+    bool hasTimestamp = false;
+
+    switch (ASDU_getTypeID(self)) {
+
+    case M_SP_TB_1: /* 30 */
+        hasTimestamp = true;
+        /* fall through */
+    case M_SP_NA_1: /* 1 */
+        valueType = BATCH_VALUE_SINGLE_POINT;
+        dataSize = 1;
+        break;
+
+    case M_DP_TB_1: /* 31 */
+        hasTimestamp = true;
+        /* fall through */
+    case M_DP_NA_1: /* 3 */
+        valueType = BATCH_VALUE_DOUBLE_POINT;
+        dataSize = 1;
+        break;
+
+    case M_BO_TB_1: /* 33 */
+        hasTimestamp = true;
+        /* fall through */
+    case M_BO_NA_1: /* 7 */
+        valueType = BATCH_VALUE_BITSTRING;
+        dataSize = 5;
+        break;
+
+    case M_ME_TD_1: /* 34 */
+        hasTimestamp = true;
+        /* fall through */
+    case M_ME_NA_1: /* 9 */
+        valueType = BATCH_VALUE_NORMALIZED;
+        dataSize = 3;
+        break;
+
+    case M_ME_ND_1: /* 21 - without quality */
+        valueType = BATCH_VALUE_NORMALIZED_WITHOUT_QUALITY;
+        dataSize = 2;
+        break;
+
+    case M_ME_TE_1: /* 35 */
+        hasTimestamp = true;
+        /* fall through */
+    case M_ME_NB_1: /* 11 */
+        valueType = BATCH_VALUE_SCALED;
+        dataSize = 3;
+        break;
+
+    case M_ME_TF_1: /* 36 */
+        hasTimestamp = true;
+        /* fall through */
+    case M_ME_NC_1: /* 13 */
+        valueType = BATCH_VALUE_SHORT;
+        dataSize = 5;
+        break;
+
+    default:
+        return -1;
+    }
+
+    int sizeOfIOA = self->parameters->sizeOfIOA;
+
+    int elementSize = dataSize + (hasTimestamp ? 7 : 0);
+
+    int numberOfElements = ASDU_getNumberOfElements(self);
+
+    int stride;
+    int availableElements;
+
+    if (ASDU_isSequence(self)) {
+        stride = elementSize;
+        availableElements = (self->payloadSize - sizeOfIOA) / elementSize;
+    }
+    else {
+        stride = sizeOfIOA + elementSize;
+        availableElements = self->payloadSize / stride;
+    }
+
+    /* don't read beyond the end of a malformed message */
+    if (numberOfElements > availableElements)
+        numberOfElements = availableElements;
+
+    if (numberOfElements > maxElements)
+        numberOfElements = maxElements;
+
+    if (numberOfElements <= 0)
+        return 0;
+
+    /* first value of the first element */
+    uint8_t* data = self->payload + sizeOfIOA;
+
+    int i;
+
+    if (ioa != NULL) {
+        if (ASDU_isSequence(self)) {
+            int firstIoa = InformationObject_ParseObjectAddress(self->parameters, self->payload, 0);
+
+            for (i = 0; i < numberOfElements; i++)
+                ioa[i] = firstIoa + i;
+        }
+        else {
+            for (i = 0; i < numberOfElements; i++)
+                ioa[i] = InformationObject_ParseObjectAddress(self->parameters, self->payload, i * stride);
+        }
+    }
+
+    bool decoded = false;
+
+    /* the elements of a sequence without time tag are stored without gaps (can use SIMD instructions) */
+    if (ASDU_isSequence(self) && (hasTimestamp == false) && (value != NULL) && (quality != NULL))
+        decoded = SequenceDecoder_decode(SequenceDecoder_getBestType(), ASDU_getTypeID(self), data,
+                numberOfElements, value, quality);
+
+    if ((value != NULL) && (decoded == false))
+        decodeBatchValues(valueType, data, stride, numberOfElements, value);
+
+    if ((quality != NULL) && (decoded == false)) {
+        if ((valueType == BATCH_VALUE_SINGLE_POINT) || (valueType == BATCH_VALUE_DOUBLE_POINT)) {
+            /* SIQ/DIQ: quality bits share the octet with the value */
+            for (i = 0; i < numberOfElements; i++)
+                quality[i] = (QualityDescriptor) (data[i * stride] & 0xf0);
+        }
+        else if (dataSize == 2) {
+            for (i = 0; i < numberOfElements; i++)
+                quality[i] = IEC60870_QUALITY_GOOD;
+        }
+        else {
+            for (i = 0; i < numberOfElements; i++)
+                quality[i] = (QualityDescriptor) data[(i * stride) + dataSize - 1];
+        }
+    }
+
+    if (timestamp != NULL) {
+        if (hasTimestamp) {
+            struct sCP56Time2a time;
+
+            for (i = 0; i < numberOfElements; i++) {
+                memcpy(time.encodedValue, data + (i * stride) + dataSize, 7);
+
+                timestamp[i] = CP56Time2a_toMsTimestamp(&time);
+            }
+        }
+        else {
+            for (i = 0; i < numberOfElements; i++)
+                timestamp[i] = 0;
+        }
+    }
+
+    return numberOfElements;
+}
+
 const char*
 TypeID_toString(TypeID self)
 {
@@ -281,12 +281,11 @@ SinglePointInformation_getFromBuffer(SinglePointInformation self, ConnectionPara
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (SinglePointInformation) GLOBAL_MALLOC(sizeof(struct sSinglePointInformation));
+    if (self == NULL)
+        self = (SinglePointInformation) GLOBAL_MALLOC(sizeof(struct sSinglePointInformation));
 
-        if (self != NULL)
-            SinglePointInformation_initialize(self);
-    }
+    if (self != NULL)
+        SinglePointInformation_initialize(self);
 
     if (self != NULL) {
 
@@ -437,12 +436,11 @@ StepPositionInformation_getFromBuffer(StepPositionInformation self, ConnectionPa
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (StepPositionInformation) GLOBAL_MALLOC(sizeof(struct sStepPositionInformation));
+    if (self == NULL)
+        self = (StepPositionInformation) GLOBAL_MALLOC(sizeof(struct sStepPositionInformation));
 
-        if (self != NULL)
-            StepPositionInformation_initialize(self);
-    }
+    if (self != NULL)
+        StepPositionInformation_initialize(self);
 
     if (self != NULL) {
 
@@ -562,12 +560,11 @@ StepPositionWithCP56Time2a_getFromBuffer(StepPositionWithCP56Time2a self, Connec
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (StepPositionWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sStepPositionWithCP56Time2a));
+    if (self == NULL)
+        self = (StepPositionWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sStepPositionWithCP56Time2a));
 
-        if (self != NULL)
-            StepPositionWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        StepPositionWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -691,12 +688,11 @@ StepPositionWithCP24Time2a_getFromBuffer(StepPositionWithCP24Time2a self, Connec
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (StepPositionWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sStepPositionWithCP24Time2a));
+    if (self == NULL)
+        self = (StepPositionWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sStepPositionWithCP24Time2a));
 
-        if (self != NULL)
-            StepPositionWithCP24Time2a_initialize(self);
-    }
+    if (self != NULL)
+        StepPositionWithCP24Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -806,12 +802,11 @@ DoublePointInformation_getFromBuffer(DoublePointInformation self, ConnectionPara
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (DoublePointInformation) GLOBAL_MALLOC(sizeof(struct sDoublePointInformation));
+    if (self == NULL)
+        self = (DoublePointInformation) GLOBAL_MALLOC(sizeof(struct sDoublePointInformation));
 
-        if (self != NULL)
-            DoublePointInformation_initialize(self);
-    }
+    if (self != NULL)
+        DoublePointInformation_initialize(self);
 
     if (self != NULL) {
 
@@ -922,12 +917,11 @@ DoublePointWithCP24Time2a_getFromBuffer(DoublePointWithCP24Time2a self, Connecti
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (DoublePointWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sDoublePointWithCP24Time2a));
+    if (self == NULL)
+        self = (DoublePointWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sDoublePointWithCP24Time2a));
 
-        if (self != NULL)
-            DoublePointWithCP24Time2a_initialize(self);
-    }
+    if (self != NULL)
+        DoublePointWithCP24Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -1043,12 +1037,11 @@ DoublePointWithCP56Time2a_getFromBuffer(DoublePointWithCP56Time2a self, Connecti
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (DoublePointWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sDoublePointWithCP56Time2a));
+    if (self == NULL)
+        self = (DoublePointWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sDoublePointWithCP56Time2a));
 
-        if (self != NULL)
-            DoublePointWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        DoublePointWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -1162,12 +1155,11 @@ SinglePointWithCP24Time2a_getFromBuffer(SinglePointWithCP24Time2a self, Connecti
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (SinglePointWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sSinglePointWithCP24Time2a));
+    if (self == NULL)
+        self = (SinglePointWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sSinglePointWithCP24Time2a));
 
-        if (self != NULL)
-            SinglePointWithCP24Time2a_initialize(self);
-    }
+    if (self != NULL)
+        SinglePointWithCP24Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -1284,12 +1276,11 @@ SinglePointWithCP56Time2a_getFromBuffer(SinglePointWithCP56Time2a self, Connecti
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (SinglePointWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sSinglePointWithCP56Time2a));
+    if (self == NULL)
+        self = (SinglePointWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sSinglePointWithCP56Time2a));
 
-        if (self != NULL)
-            SinglePointWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        SinglePointWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -1341,7 +1332,7 @@ BitString32_encode(BitString32 self, Frame frame, ConnectionParameters parameter
 
     InformationObject_encodeBase((InformationObject) self, frame, parameters, isSequence);
 
-    int value = self->value;
+    uint32_t value = self->value;
 
     Frame_setNextByte(frame, (uint8_t) (value % 0x100));
     Frame_setNextByte(frame, (uint8_t) ((value / 0x100) % 0x100));
@@ -1404,12 +1395,11 @@ BitString32_getFromBuffer(BitString32 self, ConnectionParameters parameters,
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (BitString32) GLOBAL_MALLOC(sizeof(struct sBitString32));
+    if (self == NULL)
+        self = (BitString32) GLOBAL_MALLOC(sizeof(struct sBitString32));
 
-        if (self != NULL)
-            BitString32_initialize(self);
-    }
+    if (self != NULL)
+        BitString32_initialize(self);
 
     if (self != NULL) {
 
@@ -1426,6 +1416,8 @@ BitString32_getFromBuffer(BitString32 self, ConnectionParameters parameters,
         value += ((uint32_t)msg [startIndex++] * 0x10000);
         value += ((uint32_t)msg [startIndex++] * 0x1000000);
 
+        self->value = value;
+
         /* quality */
         self->quality = (QualityDescriptor) msg [startIndex++];
     }
@@ -1461,7 +1453,7 @@ Bitstring32WithCP24Time2a_encode(Bitstring32WithCP24Time2a self, Frame frame, Co
 
     InformationObject_encodeBase((InformationObject) self, frame, parameters, isSequence);
 
-    int value = self->value;
+    uint32_t value = self->value;
 
     Frame_setNextByte(frame, (uint8_t) (value % 0x100));
     Frame_setNextByte(frame, (uint8_t) ((value / 0x100) % 0x100));
@@ -1522,12 +1514,11 @@ Bitstring32WithCP24Time2a_getFromBuffer(Bitstring32WithCP24Time2a self, Connecti
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (Bitstring32WithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sBitString32));
+    if (self == NULL)
+        self = (Bitstring32WithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sBitstring32WithCP24Time2a));
 
-        if (self != NULL)
-            Bitstring32WithCP24Time2a_initialize(self);
-    }
+    if (self != NULL)
+        Bitstring32WithCP24Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -1544,6 +1535,8 @@ Bitstring32WithCP24Time2a_getFromBuffer(Bitstring32WithCP24Time2a self, Connecti
         value += ((uint32_t)msg [startIndex++] * 0x10000);
         value += ((uint32_t)msg [startIndex++] * 0x1000000);
 
+        self->value = value;
+
         /* quality */
         self->quality = (QualityDescriptor) msg [startIndex++];
 
@@ -1582,7 +1575,7 @@ Bitstring32WithCP56Time2a_encode(Bitstring32WithCP56Time2a self, Frame frame, Co
 
     InformationObject_encodeBase((InformationObject) self, frame, parameters, isSequence);
 
-    int value = self->value;
+    uint32_t value = self->value;
 
     Frame_setNextByte(frame, (uint8_t) (value % 0x100));
     Frame_setNextByte(frame, (uint8_t) ((value / 0x100) % 0x100));
@@ -1644,12 +1637,11 @@ Bitstring32WithCP56Time2a_getFromBuffer(Bitstring32WithCP56Time2a self, Connecti
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (Bitstring32WithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sBitString32));
+    if (self == NULL)
+        self = (Bitstring32WithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sBitstring32WithCP56Time2a));
 
-        if (self != NULL)
-            Bitstring32WithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        Bitstring32WithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -1666,6 +1658,8 @@ Bitstring32WithCP56Time2a_getFromBuffer(Bitstring32WithCP56Time2a self, Connecti
         value += ((uint32_t)msg [startIndex++] * 0x10000);
         value += ((uint32_t)msg [startIndex++] * 0x1000000);
 
+        self->value = value;
+
         /* quality */
         self->quality = (QualityDescriptor) msg [startIndex++];
 
@@ -1809,12 +1803,11 @@ MeasuredValueNormalized_getFromBuffer(MeasuredValueNormalized self, ConnectionPa
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (MeasuredValueNormalized) GLOBAL_MALLOC(sizeof(struct sMeasuredValueNormalized));
+    if (self == NULL)
+        self = (MeasuredValueNormalized) GLOBAL_MALLOC(sizeof(struct sMeasuredValueNormalized));
 
-        if (self != NULL)
-            MeasuredValueNormalized_initialize(self);
-    }
+    if (self != NULL)
+        MeasuredValueNormalized_initialize(self);
 
     if (self != NULL) {
 
@@ -1978,12 +1971,11 @@ MeasuredValueNormalizedWithoutQuality_getFromBuffer(MeasuredValueNormalizedWitho
 {
     //TODO check message size
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (MeasuredValueNormalizedWithoutQuality) GLOBAL_MALLOC(sizeof(struct sMeasuredValueNormalizedWithoutQuality));
 
-        if (self != NULL)
-            MeasuredValueNormalizedWithoutQuality_initialize(self);
-    }
+    if (self != NULL)
+        MeasuredValueNormalizedWithoutQuality_initialize(self);
 
     if (self != NULL) {
 
@@ -2096,12 +2088,11 @@ MeasuredValueNormalizedWithCP24Time2a_getFromBuffer(MeasuredValueNormalizedWithC
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (MeasuredValueNormalizedWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueNormalizedWithCP24Time2a));
+    if (self == NULL)
+        self = (MeasuredValueNormalizedWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueNormalizedWithCP24Time2a));
 
-        if (self != NULL)
-            MeasuredValueNormalizedWithCP24Time2a_initialize(self);
-    }
+    if (self != NULL)
+        MeasuredValueNormalizedWithCP24Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -2220,12 +2211,11 @@ MeasuredValueNormalizedWithCP56Time2a_getFromBuffer(MeasuredValueNormalizedWithC
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (MeasuredValueNormalizedWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueNormalizedWithCP56Time2a));
+    if (self == NULL)
+        self = (MeasuredValueNormalizedWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueNormalizedWithCP56Time2a));
 
-        if (self != NULL)
-            MeasuredValueNormalizedWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        MeasuredValueNormalizedWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -2339,12 +2329,11 @@ MeasuredValueScaled_getFromBuffer(MeasuredValueScaled self, ConnectionParameters
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (MeasuredValueScaled) GLOBAL_MALLOC(sizeof(struct sMeasuredValueScaled));
+    if (self == NULL)
+        self = (MeasuredValueScaled) GLOBAL_MALLOC(sizeof(struct sMeasuredValueScaled));
 
-        if (self != NULL)
-            MeasuredValueScaled_initialize(self);
-    }
+    if (self != NULL)
+        MeasuredValueScaled_initialize(self);
 
     if (self != NULL) {
 
@@ -2508,12 +2497,11 @@ MeasuredValueScaledWithCP24Time2a_getFromBuffer(MeasuredValueScaledWithCP24Time2
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (MeasuredValueScaledWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueScaledWithCP24Time2a));
+    if (self == NULL)
+        self = (MeasuredValueScaledWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueScaledWithCP24Time2a));
 
-        if (self != NULL)
-            MeasuredValueScaledWithCP24Time2a_initialize(self);
-    }
+    if (self != NULL)
+        MeasuredValueScaledWithCP24Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -2630,12 +2618,11 @@ MeasuredValueScaledWithCP56Time2a_getFromBuffer(MeasuredValueScaledWithCP56Time2
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (MeasuredValueScaledWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueScaledWithCP56Time2a));
+    if (self == NULL)
+        self = (MeasuredValueScaledWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueScaledWithCP56Time2a));
 
-        if (self != NULL)
-            MeasuredValueScaledWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        MeasuredValueScaledWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -2760,12 +2747,11 @@ MeasuredValueShort_getFromBuffer(MeasuredValueShort self, ConnectionParameters p
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (MeasuredValueShort) GLOBAL_MALLOC(sizeof(struct sMeasuredValueShort));
+    if (self == NULL)
+        self = (MeasuredValueShort) GLOBAL_MALLOC(sizeof(struct sMeasuredValueShort));
 
-        if (self != NULL)
-            MeasuredValueShort_initialize(self);
-    }
+    if (self != NULL)
+        MeasuredValueShort_initialize(self);
 
     if (self != NULL) {
         if (!isSequence) {
@@ -2938,12 +2924,11 @@ MeasuredValueShortWithCP24Time2a_getFromBuffer(MeasuredValueShortWithCP24Time2a
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (MeasuredValueShortWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueShortWithCP24Time2a));
+    if (self == NULL)
+        self = (MeasuredValueShortWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueShortWithCP24Time2a));
 
-        if (self != NULL)
-            MeasuredValueShortWithCP24Time2a_initialize(self);
-    }
+    if (self != NULL)
+        MeasuredValueShortWithCP24Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -3069,12 +3054,11 @@ MeasuredValueShortWithCP56Time2a_getFromBuffer(MeasuredValueShortWithCP56Time2a
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (MeasuredValueShortWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueShortWithCP56Time2a));
+    if (self == NULL)
+        self = (MeasuredValueShortWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sMeasuredValueShortWithCP56Time2a));
 
-        if (self != NULL)
-            MeasuredValueShortWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        MeasuredValueShortWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -3193,12 +3177,11 @@ IntegratedTotals_getFromBuffer(IntegratedTotals self, ConnectionParameters param
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (IntegratedTotals) GLOBAL_MALLOC(sizeof(struct sIntegratedTotals));
+    if (self == NULL)
+        self = (IntegratedTotals) GLOBAL_MALLOC(sizeof(struct sIntegratedTotals));
 
-        if (self != NULL)
-            IntegratedTotals_initialize(self);
-    }
+    if (self != NULL)
+        IntegratedTotals_initialize(self);
 
     if (self != NULL) {
 
@@ -3309,12 +3292,11 @@ IntegratedTotalsWithCP24Time2a_getFromBuffer(IntegratedTotalsWithCP24Time2a self
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (IntegratedTotalsWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sIntegratedTotalsWithCP24Time2a));
+    if (self == NULL)
+        self = (IntegratedTotalsWithCP24Time2a) GLOBAL_MALLOC(sizeof(struct sIntegratedTotalsWithCP24Time2a));
 
-        if (self != NULL)
-            IntegratedTotalsWithCP24Time2a_initialize(self);
-    }
+    if (self != NULL)
+        IntegratedTotalsWithCP24Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -3427,12 +3409,11 @@ IntegratedTotalsWithCP56Time2a_getFromBuffer(IntegratedTotalsWithCP56Time2a self
 {
     //TODO check message size
 
-    if (self == NULL) {
-		self = (IntegratedTotalsWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sIntegratedTotalsWithCP56Time2a));
+    if (self == NULL)
+        self = (IntegratedTotalsWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sIntegratedTotalsWithCP56Time2a));
 
-        if (self != NULL)
-            IntegratedTotalsWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        IntegratedTotalsWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -3537,12 +3518,11 @@ EventOfProtectionEquipment_getFromBuffer(EventOfProtectionEquipment self, Connec
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 6))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (EventOfProtectionEquipment) GLOBAL_MALLOC(sizeof(struct sEventOfProtectionEquipment));
 
-        if (self != NULL)
-            EventOfProtectionEquipment_initialize(self);
-    }
+    if (self != NULL)
+        EventOfProtectionEquipment_initialize(self);
 
     if (self != NULL) {
 
@@ -3684,12 +3664,11 @@ EventOfProtectionEquipmentWithCP56Time2a_getFromBuffer(EventOfProtectionEquipmen
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 6))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (EventOfProtectionEquipmentWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sEventOfProtectionEquipmentWithCP56Time2a));
 
-        if (self != NULL)
-            EventOfProtectionEquipmentWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        EventOfProtectionEquipmentWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -3823,12 +3802,11 @@ PackedStartEventsOfProtectionEquipment_getFromBuffer(PackedStartEventsOfProtecti
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 7))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (PackedStartEventsOfProtectionEquipment) GLOBAL_MALLOC(sizeof(struct sPackedStartEventsOfProtectionEquipment));
 
-        if (self != NULL)
-            PackedStartEventsOfProtectionEquipment_initialize(self);
-    }
+    if (self != NULL)
+        PackedStartEventsOfProtectionEquipment_initialize(self);
 
     if (self != NULL) {
 
@@ -3965,12 +3943,11 @@ PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getFromBuffer(PackedStartEv
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 7))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (PackedStartEventsOfProtectionEquipmentWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sPackedStartEventsOfProtectionEquipmentWithCP56Time2a));
 
-        if (self != NULL)
-            PackedStartEventsOfProtectionEquipmentWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        PackedStartEventsOfProtectionEquipmentWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -4108,12 +4085,11 @@ PackedOutputCircuitInfo_getFromBuffer(PackedOutputCircuitInfo self, ConnectionPa
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 7))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (PackedOutputCircuitInfo) GLOBAL_MALLOC(sizeof(struct sPackedOutputCircuitInfo));
 
-        if (self != NULL)
-            PacketOutputCircuitInfo_initialize(self);
-    }
+    if (self != NULL)
+        PacketOutputCircuitInfo_initialize(self);
 
     if (self != NULL) {
 
@@ -4250,12 +4226,11 @@ PackedOutputCircuitInfoWithCP56Time2a_getFromBuffer(PackedOutputCircuitInfoWithC
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 7))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (PackedOutputCircuitInfoWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sPackedOutputCircuitInfoWithCP56Time2a));
 
-        if (self != NULL)
-            PackedOutputCircuitInfoWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        PackedOutputCircuitInfoWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -4371,12 +4346,11 @@ PackedSinglePointWithSCD_getFromBuffer(PackedSinglePointWithSCD self, Connection
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 5))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (PackedSinglePointWithSCD) GLOBAL_MALLOC(sizeof(struct sPackedSinglePointWithSCD));
 
-        if (self != NULL)
-            PackedSinglePointWithSCD_initialize(self);
-    }
+    if (self != NULL)
+        PackedSinglePointWithSCD_initialize(self);
 
     if (self != NULL) {
 
@@ -4498,12 +4472,11 @@ SingleCommand_getFromBuffer(SingleCommand self, ConnectionParameters parameters,
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 1))
         return NULL;
 
-    if (self == NULL) {
-		self = (SingleCommand) GLOBAL_MALLOC(sizeof(struct sSingleCommand));
+    if (self == NULL)
+        self = (SingleCommand) GLOBAL_MALLOC(sizeof(struct sSingleCommand));
 
-        if (self != NULL)
-            SingleCommand_initialize(self);
-    }
+    if (self != NULL)
+        SingleCommand_initialize(self);
 
     if (self != NULL) {
 
@@ -4609,12 +4582,11 @@ SingleCommandWithCP56Time2a_getFromBuffer(SingleCommandWithCP56Time2a self, Conn
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 1))
         return NULL;
 
-    if (self == NULL) {
-		self = (SingleCommandWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sSingleCommandWithCP56Time2a));
+    if (self == NULL)
+        self = (SingleCommandWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sSingleCommandWithCP56Time2a));
 
-        if (self != NULL)
-            SingleCommandWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        SingleCommandWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -4731,12 +4703,11 @@ DoubleCommand_getFromBuffer(DoubleCommand self, ConnectionParameters parameters,
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 1))
         return NULL;
 
-    if (self == NULL) {
-		self = (DoubleCommand) GLOBAL_MALLOC(sizeof(struct sDoubleCommand));
+    if (self == NULL)
+        self = (DoubleCommand) GLOBAL_MALLOC(sizeof(struct sDoubleCommand));
 
-        if (self != NULL)
-            DoubleCommand_initialize(self);
-    }
+    if (self != NULL)
+        DoubleCommand_initialize(self);
 
     if (self != NULL) {
 
@@ -4853,12 +4824,11 @@ DoubleCommandWithCP56Time2a_getFromBuffer(DoubleCommandWithCP56Time2a self, Conn
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 1))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (DoubleCommandWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sDoubleCommandWithCP56Time2a));
 
-        if (self != NULL)
-            DoubleCommandWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        DoubleCommandWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -4974,12 +4944,11 @@ StepCommand_getFromBuffer(StepCommand self, ConnectionParameters parameters,
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 1))
         return NULL;
 
-    if (self == NULL) {
-		self = (StepCommand) GLOBAL_MALLOC(sizeof(struct sStepCommand));
+    if (self == NULL)
+        self = (StepCommand) GLOBAL_MALLOC(sizeof(struct sStepCommand));
 
-        if (self != NULL)
-            StepCommand_initialize(self);
-    }
+    if (self != NULL)
+        StepCommand_initialize(self);
 
     if (self != NULL) {
 
@@ -5097,12 +5066,11 @@ StepCommandWithCP56Time2a_getFromBuffer(StepCommandWithCP56Time2a self, Connecti
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 8))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (StepCommandWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sStepCommandWithCP56Time2a));
 
-        if (self != NULL)
-            StepCommandWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        StepCommandWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -5226,12 +5194,11 @@ SetpointCommandNormalized_getFromBuffer(SetpointCommandNormalized self, Connecti
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 3))
         return NULL;
 
-    if (self == NULL) {
-		self = (SetpointCommandNormalized) GLOBAL_MALLOC(sizeof(struct sSetpointCommandNormalized));
+    if (self == NULL)
+        self = (SetpointCommandNormalized) GLOBAL_MALLOC(sizeof(struct sSetpointCommandNormalized));
 
-        if (self != NULL)
-            SetpointCommandNormalized_initialize(self);
-    }
+    if (self != NULL)
+        SetpointCommandNormalized_initialize(self);
 
     if (self != NULL) {
 
@@ -5355,12 +5322,11 @@ SetpointCommandNormalizedWithCP56Time2a_getFromBuffer(SetpointCommandNormalizedW
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 10))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (SetpointCommandNormalizedWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sSetpointCommandNormalizedWithCP56Time2a));
 
-        if (self != NULL)
-            SetpointCommandNormalizedWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        SetpointCommandNormalizedWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -5485,12 +5451,11 @@ SetpointCommandScaled_getFromBuffer(SetpointCommandScaled self, ConnectionParame
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 3))
         return NULL;
 
-    if (self == NULL) {
-		self = (SetpointCommandScaled) GLOBAL_MALLOC(sizeof(struct sSetpointCommandScaled));
+    if (self == NULL)
+        self = (SetpointCommandScaled) GLOBAL_MALLOC(sizeof(struct sSetpointCommandScaled));
 
-        if (self != NULL)
-            SetpointCommandScaled_initialize(self);
-    }
+    if (self != NULL)
+        SetpointCommandScaled_initialize(self);
 
     if (self != NULL) {
 
@@ -5612,12 +5577,11 @@ SetpointCommandScaledWithCP56Time2a_getFromBuffer(SetpointCommandScaledWithCP56T
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 10))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (SetpointCommandScaledWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sSetpointCommandScaledWithCP56Time2a));
 
-        if (self != NULL)
-            SetpointCommandScaledWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        SetpointCommandScaledWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -5750,12 +5714,11 @@ SetpointCommandShort_getFromBuffer(SetpointCommandShort self, ConnectionParamete
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 5))
         return NULL;
 
-    if (self == NULL) {
-		self = (SetpointCommandShort) GLOBAL_MALLOC(sizeof(struct sSetpointCommandShort));
+    if (self == NULL)
+        self = (SetpointCommandShort) GLOBAL_MALLOC(sizeof(struct sSetpointCommandShort));
 
-        if (self != NULL)
-            SetpointCommandShort_initialize(self);
-    }
+    if (self != NULL)
+        SetpointCommandShort_initialize(self);
 
     if (self != NULL) {
 
@@ -5890,12 +5853,11 @@ SetpointCommandShortWithCP56Time2a_getFromBuffer(SetpointCommandShortWithCP56Tim
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 10))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (SetpointCommandShortWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sSetpointCommandShortWithCP56Time2a));
 
-        if (self != NULL)
-            SetpointCommandShortWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        SetpointCommandShortWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -6017,12 +5979,11 @@ Bitstring32Command_getFromBuffer(Bitstring32Command self, ConnectionParameters p
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 4))
         return NULL;
 
-    if (self == NULL) {
-		self = (Bitstring32Command) GLOBAL_MALLOC(sizeof(struct sBitstring32Command));
+    if (self == NULL)
+        self = (Bitstring32Command) GLOBAL_MALLOC(sizeof(struct sBitstring32Command));
 
-        if (self != NULL)
-            Bitstring32Command_initialize(self);
-    }
+    if (self != NULL)
+        Bitstring32Command_initialize(self);
 
     if (self != NULL) {
 
@@ -6139,12 +6100,11 @@ Bitstring32CommandWithCP56Time2a_getFromBuffer(Bitstring32CommandWithCP56Time2a
     if ((msgSize - startIndex) < (parameters->sizeOfIOA + 11))
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (Bitstring32CommandWithCP56Time2a) GLOBAL_MALLOC(sizeof(struct sBitstring32CommandWithCP56Time2a));
 
-        if (self != NULL)
-            Bitstring32CommandWithCP56Time2a_initialize(self);
-    }
+    if (self != NULL)
+        Bitstring32CommandWithCP56Time2a_initialize(self);
 
     if (self != NULL) {
 
@@ -6243,12 +6203,11 @@ ReadCommand_getFromBuffer(ReadCommand self, ConnectionParameters parameters,
     if ((msgSize - startIndex) < (parameters->sizeOfIOA))
         return NULL;
 
-    if (self == NULL) {
-		self = (ReadCommand) GLOBAL_MALLOC(sizeof(struct sReadCommand));
+    if (self == NULL)
+        self = (ReadCommand) GLOBAL_MALLOC(sizeof(struct sReadCommand));
 
-        if (self != NULL)
-            ReadCommand_initialize(self);
-    }
+    if (self != NULL)
+        ReadCommand_initialize(self);
 
     if (self != NULL) {
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
@@ -6336,12 +6295,11 @@ ClockSynchronizationCommand_getFromBuffer(ClockSynchronizationCommand self, Conn
     if ((msgSize - startIndex) < (parameters->sizeOfIOA) + 7)
         return NULL;
 
-    if (self == NULL) {
-		self = (ClockSynchronizationCommand) GLOBAL_MALLOC(sizeof(struct sClockSynchronizationCommand));
+    if (self == NULL)
+        self = (ClockSynchronizationCommand) GLOBAL_MALLOC(sizeof(struct sClockSynchronizationCommand));
 
-        if (self != NULL)
-            ClockSynchronizationCommand_initialize(self);
-    }
+    if (self != NULL)
+        ClockSynchronizationCommand_initialize(self);
 
     if (self != NULL) {
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
@@ -6435,12 +6393,11 @@ InterrogationCommand_getFromBuffer(InterrogationCommand self, ConnectionParamete
     if ((msgSize - startIndex) < (parameters->sizeOfIOA) + 1)
         return NULL;
 
-    if (self == NULL) {
-		self = (InterrogationCommand) GLOBAL_MALLOC(sizeof(struct sInterrogationCommand));
+    if (self == NULL)
+        self = (InterrogationCommand) GLOBAL_MALLOC(sizeof(struct sInterrogationCommand));
 
-        if (self != NULL)
-            InterrogationCommand_initialize(self);
-    }
+    if (self != NULL)
+        InterrogationCommand_initialize(self);
 
     if (self != NULL) {
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
@@ -6534,12 +6491,11 @@ CounterInterrogationCommand_getFromBuffer(CounterInterrogationCommand self, Conn
     if ((msgSize - startIndex) < (parameters->sizeOfIOA) + 1)
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (CounterInterrogationCommand) GLOBAL_MALLOC(sizeof(struct sCounterInterrogationCommand));
 
-        if (self != NULL)
-            CounterInterrogationCommand_initialize(self);
-    }
+    if (self != NULL)
+        CounterInterrogationCommand_initialize(self);
 
     if (self != NULL) {
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
@@ -6633,12 +6589,11 @@ ResetProcessCommand_getFromBuffer(ResetProcessCommand self, ConnectionParameters
     if ((msgSize - startIndex) < (parameters->sizeOfIOA) + 1)
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (ResetProcessCommand) GLOBAL_MALLOC(sizeof(struct sResetProcessCommand));
 
-        if (self != NULL)
-            ResetProcessCommand_initialize(self);
-    }
+    if (self != NULL)
+        ResetProcessCommand_initialize(self);
 
     if (self != NULL) {
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
@@ -6732,12 +6687,11 @@ DelayAcquisitionCommand_getFromBuffer(DelayAcquisitionCommand self, ConnectionPa
     if ((msgSize - startIndex) < (parameters->sizeOfIOA) + 1)
         return NULL;
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (DelayAcquisitionCommand) GLOBAL_MALLOC(sizeof(struct sDelayAcquisitionCommand));
 
-        if (self != NULL)
-            DelayAcquisitionCommand_initialize(self);
-    }
+    if (self != NULL)
+        DelayAcquisitionCommand_initialize(self);
 
     if (self != NULL) {
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
@@ -6829,12 +6783,11 @@ ParameterActivation_getFromBuffer(ParameterActivation self, ConnectionParameters
 {
     //TODO check message size
 
-    if (self == NULL) {
+    if (self == NULL)
         self = (ParameterActivation) GLOBAL_MALLOC(sizeof(struct sParameterActivation));
 
-        if (self != NULL)
-            ParameterActivation_initialize(self);
-    }
+    if (self != NULL)
+        ParameterActivation_initialize(self);
 
     if (self != NULL) {
 
@@ -6929,12 +6882,11 @@ EndOfInitialization_getFromBuffer(EndOfInitialization self, ConnectionParameters
     if ((msgSize - startIndex) < (parameters->sizeOfIOA) + 1)
         return NULL;
 
-    if (self == NULL) {
-       self = (EndOfInitialization) GLOBAL_MALLOC(sizeof(struct sEndOfInitialization));
+    if (self == NULL)
+        self = (EndOfInitialization) GLOBAL_MALLOC(sizeof(struct sEndOfInitialization));
 
-        if (self != NULL)
-            EndOfInitialization_initialize(self);
-    }
+    if (self != NULL)
+        EndOfInitialization_initialize(self);
 
     if (self != NULL) {
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
@@ -6987,8 +6939,27 @@ union uInformationObject {
     struct sParameterActivation m36;
     struct sEventOfProtectionEquipmentWithCP56Time2a m37;
     struct sStepCommandWithCP56Time2a m38;
+    struct sBitstring32CommandWithCP56Time2a m39;
+    struct sCounterInterrogationCommand m40;
+    struct sDelayAcquisitionCommand m41;
+    struct sDoubleCommandWithCP56Time2a m42;
+    struct sEndOfInitialization m43;
+    struct sEventOfProtectionEquipment m44;
+    struct sMeasuredValueNormalizedWithoutQuality m45;
+    struct sPackedOutputCircuitInfo m46;
+    struct sPackedOutputCircuitInfoWithCP56Time2a m47;
+    struct sPackedSinglePointWithSCD m48;
+    struct sPackedStartEventsOfProtectionEquipment m49;
+    struct sPackedStartEventsOfProtectionEquipmentWithCP56Time2a m50;
+    struct sResetProcessCommand m51;
+    struct sSetpointCommandNormalizedWithCP56Time2a m52;
+    struct sSetpointCommandScaledWithCP56Time2a m53;
+    struct sSetpointCommandShortWithCP56Time2a m54;
 };
 
+/* compile time check that StaticInformationObject can hold every information object type */
+typedef char StaticInformationObjectSizeCheck[(sizeof(union uInformationObject) <= sizeof(union uStaticInformationObject)) ? 1 : -1];
+
 int
 InformationObject_getMaxSizeInMemory()
 {
@@ -0,0 +1,387 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "sequence_decoder.h"
+#include "platform_endian.h"
+#include "lib60870_internal.h"
+
+#if (CONFIG_USE_SIMD_DECODER == 1) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && (ORDER_LITTLE_ENDIAN == 1)
+#define SEQUENCE_DECODER_X86 1
+#include <immintrin.h>
+
+/* the library is not compiled for SSE4.1/AVX2 - only the decode functions use these instructions */
+#define SSE41_FUNCTION __attribute__((target("sse4.1")))
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#else
+#define SEQUENCE_DECODER_X86 0
+#endif
+
+/*
+ * Element sizes:
+ * M_SP_NA_1/M_DP_NA_1: SIQ/DIQ (1 byte)
+ * M_ME_NA_1/M_ME_NB_1: value (2 byte) + QDS
+ * M_ME_NC_1: value (4 byte float) + QDS
+ */
+
+static void
+decodePointsScalar(const uint8_t* data, int numberOfElements, uint8_t valueMask,
+        double* value, QualityDescriptor* quality)
+{
+    int i;
+
+    for (i = 0; i < numberOfElements; i++) {
+        value[i] = (double) (data[i] & valueMask);
+        quality[i] = (QualityDescriptor) (data[i] & 0xf0);
+    }
+}
+
+static void
+decodeScaledScalar(const uint8_t* data, int numberOfElements, bool normalized,
+        double* value, QualityDescriptor* quality)
+{
+    int i;
+
+    for (i = 0; i < numberOfElements; i++) {
+        const uint8_t* element = data + (i * 3);
+
+        int16_t scaledValue = (int16_t) (element[0] + (element[1] << 8));
+
+        if (normalized)
+            value[i] = (double) ((float) scaledValue / 32767.f);
+        else
+            value[i] = (double) scaledValue;
+
+        quality[i] = (QualityDescriptor) element[2];
+    }
+}
+
+static void
+decodeShortScalar(const uint8_t* data, int numberOfElements, double* value, QualityDescriptor* quality)
+{
+    int i;
+
+    for (i = 0; i < numberOfElements; i++) {
+        const uint8_t* element = data + (i * 5);
+
+        float floatValue;
+        uint8_t* valueBytes = (uint8_t*) &floatValue;
+
+#if (ORDER_LITTLE_ENDIAN == 1)
+        valueBytes[0] = element[0];
+        valueBytes[1] = element[1];
+        valueBytes[2] = element[2];
+        valueBytes[3] = element[3];
+#else
+        valueBytes[3] = element[0];
+        valueBytes[2] = element[1];
+        valueBytes[1] = element[2];
+        valueBytes[0] = element[3];
+#endif
+
+        value[i] = (double) floatValue;
+        quality[i] = (QualityDescriptor) element[4];
+    }
+}
+
+#if (SEQUENCE_DECODER_X86 == 1)
+
+/*
+ * The SIMD functions decode as many elements as possible in blocks and return the number of
+ * decoded elements. The remaining elements are decoded by the scalar functions. The blocks
+ * are only read when all bytes belong to the elements of the sequence.
+ */
+
+SSE41_FUNCTION static void
+storeIntegersSse41(double* value, __m128i integers)
+{
+    _mm_storeu_pd(value, _mm_cvtepi32_pd(integers));
+    _mm_storeu_pd(value + 2, _mm_cvtepi32_pd(_mm_srli_si128(integers, 8)));
+}
+
+SSE41_FUNCTION static int
+decodePointsSse41(const uint8_t* data, int numberOfElements, uint8_t valueMask,
+        double* value, QualityDescriptor* quality)
+{
+    const __m128i valueMaskVector = _mm_set1_epi8((char) valueMask);
+    const __m128i qualityMask = _mm_set1_epi8((char) 0xf0);
+
+    int i;
+
+    for (i = 0; i + 16 <= numberOfElements; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (data + i));
+
+        _mm_storeu_si128((__m128i*) (quality + i), _mm_and_si128(bytes, qualityMask));
+
+        __m128i values = _mm_and_si128(bytes, valueMaskVector);
+
+        storeIntegersSse41(value + i, _mm_cvtepu8_epi32(values));
+        storeIntegersSse41(value + i + 4, _mm_cvtepu8_epi32(_mm_srli_si128(values, 4)));
+        storeIntegersSse41(value + i + 8, _mm_cvtepu8_epi32(_mm_srli_si128(values, 8)));
+        storeIntegersSse41(value + i + 12, _mm_cvtepu8_epi32(_mm_srli_si128(values, 12)));
+    }
+
+    return i;
+}
+
+SSE41_FUNCTION static int
+decodeScaledSse41(const uint8_t* data, int numberOfElements, bool normalized,
+        double* value, QualityDescriptor* quality)
+{
+    /* 4 elements: values (int16) in bytes 0-7, quality in bytes 8-11 */
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 2, 5, 8, 11, -1, -1, -1, -1);
+    const __m128 scale = _mm_set1_ps(32767.f);
+
+    int i;
+
+    /* 16 bytes are read for 4 elements (12 bytes) */
+    for (i = 0; i + 6 <= numberOfElements; i += 4) {
+        __m128i elements = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + (i * 3))), shuffle);
+
+        __m128i integers = _mm_cvtepi16_epi32(elements);
+
+        if (normalized) {
+            __m128 floats = _mm_div_ps(_mm_cvtepi32_ps(integers), scale);
+
+            _mm_storeu_pd(value + i, _mm_cvtps_pd(floats));
+            _mm_storeu_pd(value + i + 2, _mm_cvtps_pd(_mm_movehl_ps(floats, floats)));
+        }
+        else
+            storeIntegersSse41(value + i, integers);
+
+        uint32_t qualities = (uint32_t) _mm_cvtsi128_si32(_mm_srli_si128(elements, 8));
+        memcpy(quality + i, &qualities, 4);
+    }
+
+    return i;
+}
+
+SSE41_FUNCTION static int
+decodeShortSse41(const uint8_t* data, int numberOfElements, double* value, QualityDescriptor* quality)
+{
+    /* 4 elements (20 bytes) from two overlapping blocks (bytes 0-15 and 4-19) */
+    const __m128i valuesFirst = _mm_setr_epi8(0, 1, 2, 3, 5, 6, 7, 8, 10, 11, 12, 13, -1, -1, -1, -1);
+    const __m128i valuesSecond = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 11, 12, 13, 14);
+    const __m128i qualityFirst = _mm_setr_epi8(4, 9, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i qualitySecond = _mm_setr_epi8(-1, -1, -1, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+
+    int i;
+
+    for (i = 0; i + 4 <= numberOfElements; i += 4) {
+        __m128i first = _mm_loadu_si128((const __m128i*) (data + (i * 5)));
+        __m128i second = _mm_loadu_si128((const __m128i*) (data + (i * 5) + 4));
+
+        __m128 floats = _mm_castsi128_ps(_mm_or_si128(_mm_shuffle_epi8(first, valuesFirst),
+                _mm_shuffle_epi8(second, valuesSecond)));
+
+        _mm_storeu_pd(value + i, _mm_cvtps_pd(floats));
+        _mm_storeu_pd(value + i + 2, _mm_cvtps_pd(_mm_movehl_ps(floats, floats)));
+
+        uint32_t qualities = (uint32_t) _mm_cvtsi128_si32(_mm_or_si128(_mm_shuffle_epi8(first, qualityFirst),
+                _mm_shuffle_epi8(second, qualitySecond)));
+        memcpy(quality + i, &qualities, 4);
+    }
+
+    return i;
+}
+
+AVX2_FUNCTION static void
+storeIntegersAvx2(double* value, __m256i integers)
+{
+    _mm256_storeu_pd(value, _mm256_cvtepi32_pd(_mm256_castsi256_si128(integers)));
+    _mm256_storeu_pd(value + 4, _mm256_cvtepi32_pd(_mm256_extracti128_si256(integers, 1)));
+}
+
+AVX2_FUNCTION static int
+decodePointsAvx2(const uint8_t* data, int numberOfElements, uint8_t valueMask,
+        double* value, QualityDescriptor* quality)
+{
+    const __m128i valueMaskVector = _mm_set1_epi8((char) valueMask);
+    const __m128i qualityMask = _mm_set1_epi8((char) 0xf0);
+
+    int i;
+
+    for (i = 0; i + 16 <= numberOfElements; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (data + i));
+
+        _mm_storeu_si128((__m128i*) (quality + i), _mm_and_si128(bytes, qualityMask));
+
+        __m128i values = _mm_and_si128(bytes, valueMaskVector);
+
+        storeIntegersAvx2(value + i, _mm256_cvtepu8_epi32(values));
+        storeIntegersAvx2(value + i + 8, _mm256_cvtepu8_epi32(_mm_srli_si128(values, 8)));
+    }
+
+    return i;
+}
+
+AVX2_FUNCTION static int
+decodeScaledAvx2(const uint8_t* data, int numberOfElements, bool normalized,
+        double* value, QualityDescriptor* quality)
+{
+    /* per 128 bit lane 4 elements: values (int16) in bytes 0-7, quality in bytes 8-11 */
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 2, 5, 8, 11, -1, -1, -1, -1,
+            0, 1, 3, 4, 6, 7, 9, 10, 2, 5, 8, 11, -1, -1, -1, -1);
+    const __m256 scale = _mm256_set1_ps(32767.f);
+
+    int i;
+
+    /* the second block (elements 4-7) reads 16 bytes starting at element 4 */
+    for (i = 0; i + 10 <= numberOfElements; i += 8) {
+        __m128i first = _mm_loadu_si128((const __m128i*) (data + (i * 3)));
+        __m128i second = _mm_loadu_si128((const __m128i*) (data + (i * 3) + 12));
+
+        __m256i elements = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1), shuffle);
+
+        /* values of both lanes to the lower half, quality to the upper half */
+        elements = _mm256_permute4x64_epi64(elements, 0xd8);
+
+        __m256i integers = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(elements));
+
+        if (normalized) {
+            __m256 floats = _mm256_div_ps(_mm256_cvtepi32_ps(integers), scale);
+
+            _mm256_storeu_pd(value + i, _mm256_cvtps_pd(_mm256_castps256_ps128(floats)));
+            _mm256_storeu_pd(value + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(floats, 1)));
+        }
+        else
+            storeIntegersAvx2(value + i, integers);
+
+        __m128i qualityBytes = _mm256_extracti128_si256(elements, 1);
+
+        uint32_t qualities[2];
+        qualities[0] = (uint32_t) _mm_cvtsi128_si32(qualityBytes);
+        qualities[1] = (uint32_t) _mm_extract_epi32(qualityBytes, 2);
+        memcpy(quality + i, qualities, 8);
+    }
+
+    return i;
+}
+
+#endif /* (SEQUENCE_DECODER_X86 == 1) */
+
+bool
+SequenceDecoder_isSupported(SequenceDecoderType type)
+{
+    if (type == SEQUENCE_DECODER_SCALAR)
+        return true;
+
+#if (SEQUENCE_DECODER_X86 == 1)
+    if (type == SEQUENCE_DECODER_SSE41)
+        return __builtin_cpu_supports("sse4.1");
+
+    if (type == SEQUENCE_DECODER_AVX2)
+        return __builtin_cpu_supports("avx2");
+#endif
+
+    return false;
+}
+
+SequenceDecoderType
+SequenceDecoder_getBestType(void)
+{
+    if (SequenceDecoder_isSupported(SEQUENCE_DECODER_AVX2))
+        return SEQUENCE_DECODER_AVX2;
+
+    if (SequenceDecoder_isSupported(SEQUENCE_DECODER_SSE41))
+        return SEQUENCE_DECODER_SSE41;
+
+    return SEQUENCE_DECODER_SCALAR;
+}
+
+bool
+SequenceDecoder_decode(SequenceDecoderType type, TypeID typeId, const uint8_t* data, int numberOfElements,
+        double* value, QualityDescriptor* quality)
+{
+    int elementSize;
+    uint8_t valueMask = 0;
+    bool normalized = false;
+
+    switch (typeId) {
+
+    case M_SP_NA_1:
+        elementSize = 1;
+        valueMask = 0x01;
+        break;
+
+    case M_DP_NA_1:
+        elementSize = 1;
+        valueMask = 0x03;
+        break;
+
+    case M_ME_NA_1:
+        elementSize = 3;
+        normalized = true;
+        break;
+
+    case M_ME_NB_1:
+        elementSize = 3;
+        break;
+
+    case M_ME_NC_1:
+        elementSize = 5;
+        break;
+
+    default:
+        return false;
+    }
+
+    /* elements decoded with SIMD instructions */
+    int decoded = 0;
+
+#if (SEQUENCE_DECODER_X86 == 1)
+    if (type == SEQUENCE_DECODER_AVX2) {
+        if (elementSize == 1)
+            decoded = decodePointsAvx2(data, numberOfElements, valueMask, value, quality);
+        else if (elementSize == 3)
+            decoded = decodeScaledAvx2(data, numberOfElements, normalized, value, quality);
+        else /* AVX2 gather instructions are slower than the SSE4.1 shuffles */
+            decoded = decodeShortSse41(data, numberOfElements, value, quality);
+    }
+    else if (type == SEQUENCE_DECODER_SSE41) {
+        if (elementSize == 1)
+            decoded = decodePointsSse41(data, numberOfElements, valueMask, value, quality);
+        else if (elementSize == 3)
+            decoded = decodeScaledSse41(data, numberOfElements, normalized, value, quality);
+        else
+            decoded = decodeShortSse41(data, numberOfElements, value, quality);
+    }
+#else
+    (void) type;
+#endif
+
+    data += decoded * elementSize;
+    numberOfElements -= decoded;
+    value += decoded;
+    quality += decoded;
+
+    if (elementSize == 1)
+        decodePointsScalar(data, numberOfElements, valueMask, value, quality);
+    else if (elementSize == 3)
+        decodeScaledScalar(data, numberOfElements, normalized, value, quality);
+    else
+        decodeShortScalar(data, numberOfElements, value, quality);
+
+    return true;
+}
@@ -0,0 +1,1058 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include <string.h>
+#include <limits.h>
+
+#include "iec60870_process_image.h"
+#include "process_image_internal.h"
+#include "apl_types_internal.h"
+#include "hal_thread.h"
+#include "hal_time.h"
+#include "lib_memory.h"
+#include "lib60870_config.h"
+#include "lib60870_internal.h"
+#include "platform_endian.h"
+
+/* size of the encoded CP56Time2a time tag */
+#define TIME_TAG_SIZE 7
+
+/* maximum number of information objects of an ASDU (7 bit of the variable structure qualifier) */
+#define MAX_NUMBER_OF_OBJECTS 127
+
+/* points of the same type with consecutive IOAs */
+struct sProcessImageBlock {
+    int ca;
+    int startIoa;
+    int numberOfPoints;
+
+    TypeID typeId;
+    int group; /* interrogation group (0 = station interrogation only) */
+
+    int elementSize; /* size of an encoded information element (without IOA) */
+    uint8_t* elements; /* the encoded information elements of all points */
+};
+
+typedef struct sProcessImageBlock* ProcessImageBlock;
+
+/*
+ * Encoded interrogation response of a CA and interrogation group. The snapshot is not changed
+ * after it has been created and is shared by all interrogations that arrive until a point of the
+ * snapshot changes.
+ */
+typedef struct sInterrogationSnapshot* InterrogationSnapshot;
+
+struct sInterrogationSnapshot {
+    int ca;
+    int group; /* 0 for station interrogation */
+
+    int refCount; /* process image and interrogation streams (protected by the lock of the process image) */
+
+    int size;
+    uint8_t* asdus; /* encoded ASDUs (OA = 0), each ASDU starts with a size byte */
+
+    InterrogationSnapshot next;
+};
+
+struct sProcessImage {
+    Slave slave;
+    ConnectionParameters parameters;
+
+    bool useEventTimestamps;
+
+    int numberOfBlocks;
+    int maxNumberOfBlocks;
+    struct sProcessImageBlock* blocks; /* sorted by CA and start IOA */
+
+    InterrogationSnapshot snapshots; /* valid snapshots of interrogation responses */
+    int numberOfSnapshots; /* valid snapshots and snapshots that are still used by streams */
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore lock;
+
+    /*
+     * Serializes the value updates so that the events are queued in the order the values are
+     * stored. Taken before the lock; the interrogations only take the lock and are not blocked
+     * by a producer that waits for the event queue.
+     */
+    Semaphore updateLock;
+#endif
+};
+
+/* size of the information element of the type (0 if the type is not supported) */
+static int
+getElementSize(TypeID typeId)
+{
+    switch (typeId) {
+    case M_SP_NA_1:
+    case M_DP_NA_1:
+        return 1;
+    case M_ST_NA_1:
+        return 2;
+    case M_ME_NA_1:
+    case M_ME_NB_1:
+        return 3;
+    case M_ME_NC_1:
+        return 5;
+    default:
+        return 0;
+    }
+}
+
+/* type of the events with time tag CP56Time2a */
+static TypeID
+getTimeTaggedType(TypeID typeId)
+{
+    switch (typeId) {
+    case M_SP_NA_1:
+        return M_SP_TB_1;
+    case M_DP_NA_1:
+        return M_DP_TB_1;
+    case M_ST_NA_1:
+        return M_ST_TB_1;
+    case M_ME_NA_1:
+        return M_ME_TD_1;
+    case M_ME_NB_1:
+        return M_ME_TE_1;
+    default:
+        return M_ME_TF_1;
+    }
+}
+
+static void
+ProcessImage_lock(ProcessImage self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->lock);
+#endif
+}
+
+static void
+ProcessImage_unlock(ProcessImage self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->lock);
+#endif
+}
+
+/* has to be called with the lock held */
+static void
+releaseSnapshot(ProcessImage self, InterrogationSnapshot snapshot)
+{
+    snapshot->refCount--;
+
+    if (snapshot->refCount == 0) {
+        GLOBAL_FREEMEM(snapshot->asdus);
+        GLOBAL_FREEMEM(snapshot);
+
+        self->numberOfSnapshots--;
+    }
+}
+
+/*
+ * Remove the snapshots that contain points of the CA and group (-1 for all groups) from the process image.
+ * Streams that are sending a removed snapshot keep it until they are finished. Has to be called with the lock held.
+ */
+static void
+invalidateSnapshots(ProcessImage self, int ca, int group)
+{
+    InterrogationSnapshot* link = &(self->snapshots);
+
+    while (*link != NULL) {
+        InterrogationSnapshot snapshot = *link;
+
+        if ((snapshot->ca == ca) && ((group == -1) || (snapshot->group == 0) || (snapshot->group == group))) {
+            *link = snapshot->next;
+            releaseSnapshot(self, snapshot);
+        }
+        else
+            link = &(snapshot->next);
+    }
+}
+
+ProcessImage
+ProcessImage_create(Slave slave)
+{
+    ProcessImage self = (ProcessImage) GLOBAL_MALLOC(sizeof(struct sProcessImage));
+
+    if (self != NULL) {
+        self->slave = slave;
+        self->parameters = Slave_getConnectionParameters(slave);
+        self->useEventTimestamps = false;
+
+        self->numberOfBlocks = 0;
+        self->maxNumberOfBlocks = 0;
+        self->blocks = NULL;
+
+        self->snapshots = NULL;
+        self->numberOfSnapshots = 0;
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+        self->lock = Semaphore_create(1);
+        self->updateLock = Semaphore_create(1);
+#endif
+    }
+
+    return self;
+}
+
+void
+ProcessImage_destroy(ProcessImage self)
+{
+    if (self != NULL) {
+        int i;
+
+        for (i = 0; i < self->numberOfBlocks; i++)
+            GLOBAL_FREEMEM(self->blocks[i].elements);
+
+        if (self->blocks != NULL)
+            GLOBAL_FREEMEM(self->blocks);
+
+        while (self->snapshots != NULL) {
+            InterrogationSnapshot snapshot = self->snapshots;
+
+            self->snapshots = snapshot->next;
+            releaseSnapshot(self, snapshot);
+        }
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+        Semaphore_destroy(self->lock);
+        Semaphore_destroy(self->updateLock);
+#endif
+
+        GLOBAL_FREEMEM(self);
+    }
+}
+
+/* Get the index of the first block with (ca, startIoa) greater than (ca, ioa) */
+static int
+getUpperBound(ProcessImage self, int ca, int ioa)
+{
+    int low = 0;
+    int high = self->numberOfBlocks;
+
+    while (low < high) {
+        int mid = (low + high) / 2;
+
+        ProcessImageBlock block = &(self->blocks[mid]);
+
+        if ((block->ca < ca) || ((block->ca == ca) && (block->startIoa <= ioa)))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+/* Get the block that contains the point (has to be called with the lock held) */
+static ProcessImageBlock
+findBlock(ProcessImage self, int ca, int ioa)
+{
+    int index = getUpperBound(self, ca, ioa) - 1;
+
+    if (index < 0)
+        return NULL;
+
+    ProcessImageBlock block = &(self->blocks[index]);
+
+    if ((block->ca != ca) || (ioa >= (block->startIoa + block->numberOfPoints)))
+        return NULL;
+
+    return block;
+}
+
+bool
+ProcessImage_addPoints(ProcessImage self, int ca, TypeID typeId, int startIoa, int numberOfPoints)
+{
+    int elementSize = getElementSize(typeId);
+
+    if ((elementSize == 0) || (numberOfPoints < 1))
+        return false;
+
+    bool added = false;
+
+    ProcessImage_lock(self);
+
+    int index = getUpperBound(self, ca, startIoa);
+
+    /* the IOAs must not overlap with the neighbor blocks */
+    if (index > 0) {
+        ProcessImageBlock previous = &(self->blocks[index - 1]);
+
+        if ((previous->ca == ca) && ((previous->startIoa + previous->numberOfPoints) > startIoa))
+            goto exit_function;
+    }
+
+    if (index < self->numberOfBlocks) {
+        ProcessImageBlock next = &(self->blocks[index]);
+
+        if ((next->ca == ca) && (next->startIoa < (startIoa + numberOfPoints)))
+            goto exit_function;
+    }
+
+    if (self->numberOfBlocks == self->maxNumberOfBlocks) {
+        int maxNumberOfBlocks = (self->maxNumberOfBlocks == 0) ? 16 : (self->maxNumberOfBlocks * 2);
+
+        struct sProcessImageBlock* blocks =
+                (struct sProcessImageBlock*) GLOBAL_MALLOC(maxNumberOfBlocks * sizeof(struct sProcessImageBlock));
+
+        if (blocks == NULL)
+            goto exit_function;
+
+        if (self->blocks != NULL) {
+            memcpy(blocks, self->blocks, self->numberOfBlocks * sizeof(struct sProcessImageBlock));
+            GLOBAL_FREEMEM(self->blocks);
+        }
+
+        self->blocks = blocks;
+        self->maxNumberOfBlocks = maxNumberOfBlocks;
+    }
+
+    uint8_t* elements = (uint8_t*) GLOBAL_CALLOC(numberOfPoints, elementSize);
+
+    if (elements == NULL)
+        goto exit_function;
+
+    /* the quality descriptor is the last byte (or part of the last byte) of the information element */
+    int i;
+
+    for (i = 0; i < numberOfPoints; i++)
+        elements[(i * elementSize) + elementSize - 1] = IEC60870_QUALITY_INVALID;
+
+    memmove(&(self->blocks[index + 1]), &(self->blocks[index]),
+            (self->numberOfBlocks - index) * sizeof(struct sProcessImageBlock));
+
+    ProcessImageBlock block = &(self->blocks[index]);
+
+    block->ca = ca;
+    block->startIoa = startIoa;
+    block->numberOfPoints = numberOfPoints;
+    block->typeId = typeId;
+    block->group = 0;
+    block->elementSize = elementSize;
+    block->elements = elements;
+
+    self->numberOfBlocks++;
+
+    invalidateSnapshots(self, ca, -1);
+
+    added = true;
+
+exit_function:
+    ProcessImage_unlock(self);
+
+    return added;
+}
+
+bool
+ProcessImage_setInterrogationGroup(ProcessImage self, int ca, int startIoa, int group)
+{
+    bool found = false;
+
+    ProcessImage_lock(self);
+
+    ProcessImageBlock block = findBlock(self, ca, startIoa);
+
+    if ((block != NULL) && (block->startIoa == startIoa)) {
+        block->group = group;
+        found = true;
+
+        invalidateSnapshots(self, ca, -1);
+    }
+
+    ProcessImage_unlock(self);
+
+    return found;
+}
+
+void
+ProcessImage_setEventTimestamps(ProcessImage self, bool enable)
+{
+    self->useEventTimestamps = enable;
+}
+
+static int
+encodeIOA(ProcessImage self, uint8_t* buffer, int ioa)
+{
+    buffer[0] = (uint8_t) (ioa & 0xff);
+
+    if (self->parameters->sizeOfIOA > 1)
+        buffer[1] = (uint8_t) ((ioa / 0x100) & 0xff);
+
+    if (self->parameters->sizeOfIOA > 2)
+        buffer[2] = (uint8_t) ((ioa / 0x10000) & 0xff);
+
+    return self->parameters->sizeOfIOA;
+}
+
+static void
+ProcessImage_lockUpdates(ProcessImage self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->updateLock);
+#endif
+}
+
+static void
+ProcessImage_unlockUpdates(ProcessImage self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->updateLock);
+#endif
+}
+
+/*
+ * Store the encoded information element of the point. When the element has changed a
+ * spontaneous event is added to the event queue of the slave. The event is queued before
+ * another update of the process image is stored, so the last event of a point always has
+ * the stored value.
+ */
+static bool
+updatePoint(ProcessImage self, int ca, int ioa, TypeID typeId, const uint8_t* element)
+{
+    uint8_t event[16];
+    int eventSize = 0;
+
+    TypeID eventType = typeId;
+
+    ProcessImage_lockUpdates(self);
+    ProcessImage_lock(self);
+
+    ProcessImageBlock block = findBlock(self, ca, ioa);
+
+    if ((block == NULL) || (block->typeId != typeId)) {
+        ProcessImage_unlock(self);
+        ProcessImage_unlockUpdates(self);
+        return false;
+    }
+
+    uint8_t* storedElement = block->elements + ((ioa - block->startIoa) * block->elementSize);
+
+    if (memcmp(storedElement, element, block->elementSize) != 0) {
+        memcpy(storedElement, element, block->elementSize);
+
+        if (self->snapshots != NULL)
+            invalidateSnapshots(self, ca, block->group);
+
+        eventSize = encodeIOA(self, event, ioa);
+
+        memcpy(event + eventSize, element, block->elementSize);
+        eventSize += block->elementSize;
+    }
+
+    ProcessImage_unlock(self);
+
+    if ((eventSize > 0) && (self->slave != NULL)) {
+
+        if (self->useEventTimestamps) {
+            struct sCP56Time2a timestamp;
+
+            CP56Time2a_createFromMsTimestamp(&timestamp, Hal_getTimeInMs());
+
+            memcpy(event + eventSize, timestamp.encodedValue, TIME_TAG_SIZE);
+            eventSize += TIME_TAG_SIZE;
+
+            eventType = getTimeTaggedType(typeId);
+        }
+
+        struct sStaticASDU asduMemory;
+
+        ASDU asdu = ASDU_initializeStatic(&asduMemory, self->parameters, eventType, false, SPONTANEOUS, 0, ca, false, false);
+
+        ASDU_addEncodedObjects(asdu, event, eventSize, 1);
+
+        Slave_enqueueASDU(self->slave, asdu);
+    }
+
+    ProcessImage_unlockUpdates(self);
+
+    return true;
+}
+
+bool
+ProcessImage_updateSinglePoint(ProcessImage self, int ca, int ioa, bool value, QualityDescriptor quality)
+{
+    uint8_t element = (uint8_t) (quality & 0xf0);
+
+    if (value)
+        element |= 0x01;
+
+    return updatePoint(self, ca, ioa, M_SP_NA_1, &element);
+}
+
+bool
+ProcessImage_updateDoublePoint(ProcessImage self, int ca, int ioa, DoublePointValue value, QualityDescriptor quality)
+{
+    uint8_t element = (uint8_t) ((quality & 0xf0) | (value & 0x03));
+
+    return updatePoint(self, ca, ioa, M_DP_NA_1, &element);
+}
+
+bool
+ProcessImage_updateStepPosition(ProcessImage self, int ca, int ioa, int value, bool isTransient,
+        QualityDescriptor quality)
+{
+    if (value > 63)
+        value = 63;
+    else if (value < -64)
+        value = -64;
+
+    uint8_t element[2];
+
+    element[0] = (uint8_t) (value & 0x7f);
+
+    if (isTransient)
+        element[0] |= 0x80;
+
+    element[1] = (uint8_t) quality;
+
+    return updatePoint(self, ca, ioa, M_ST_NA_1, element);
+}
+
+bool
+ProcessImage_updateNormalizedValue(ProcessImage self, int ca, int ioa, float value, QualityDescriptor quality)
+{
+    if (value > 1.0f)
+        value = 1.0f;
+    else if (value < -1.0f)
+        value = -1.0f;
+
+    int scaledValue = (int) (value * 32767.f);
+
+    uint8_t element[3];
+
+    element[0] = (uint8_t) (scaledValue & 0xff);
+    element[1] = (uint8_t) ((scaledValue >> 8) & 0xff);
+    element[2] = (uint8_t) quality;
+
+    return updatePoint(self, ca, ioa, M_ME_NA_1, element);
+}
+
+bool
+ProcessImage_updateScaledValue(ProcessImage self, int ca, int ioa, int value, QualityDescriptor quality)
+{
+    uint8_t element[3];
+
+    element[0] = (uint8_t) (value & 0xff);
+    element[1] = (uint8_t) ((value >> 8) & 0xff);
+    element[2] = (uint8_t) quality;
+
+    return updatePoint(self, ca, ioa, M_ME_NB_1, element);
+}
+
+bool
+ProcessImage_updateShortFloat(ProcessImage self, int ca, int ioa, float value, QualityDescriptor quality)
+{
+    uint8_t element[5];
+
+    uint8_t* valueBytes = (uint8_t*) &value;
+
+#if (ORDER_LITTLE_ENDIAN == 1)
+    memcpy(element, valueBytes, 4);
+#else
+    element[0] = valueBytes[3];
+    element[1] = valueBytes[2];
+    element[2] = valueBytes[1];
+    element[3] = valueBytes[0];
+#endif
+
+    element[4] = (uint8_t) quality;
+
+    return updatePoint(self, ca, ioa, M_ME_NC_1, element);
+}
+
+static bool
+isBroadcastAddress(ProcessImage self, int ca)
+{
+    if (self->parameters->sizeOfCA > 1)
+        return (ca == 0xffff);
+    else
+        return (ca == 0xff);
+}
+
+/* create the ACT_CON or ACT_TERM message of an interrogation for the CA */
+static ASDU
+createInterrogationResponse(ProcessImage self, int oa, int ca, uint8_t qoi, CauseOfTransmission cot)
+{
+    ASDU response = ASDU_create(self->parameters, C_IC_NA_1, false, cot, oa, ca, false, false);
+
+    if (response != NULL) {
+        /* IOA 0 and QOI */
+        uint8_t object[4];
+
+        int size = encodeIOA(self, object, 0);
+
+        object[size++] = qoi;
+
+        ASDU_addEncodedObjects(response, object, size, 1);
+    }
+
+    return response;
+}
+
+/*
+ * Encode the points of the CA and group as sequences of information elements (SQ=1) with as
+ * many information objects per ASDU as possible. Has to be called with the lock held.
+ */
+static InterrogationSnapshot
+createSnapshot(ProcessImage self, int ca, int group)
+{
+    InterrogationSnapshot snapshot = (InterrogationSnapshot) GLOBAL_MALLOC(sizeof(struct sInterrogationSnapshot));
+
+    if (snapshot == NULL)
+        return NULL;
+
+    snapshot->ca = ca;
+    snapshot->group = group;
+    snapshot->refCount = 1;
+    snapshot->next = NULL;
+
+    int headerSize = 2 + self->parameters->sizeOfCOT + self->parameters->sizeOfCA;
+
+    /* first pass: size of the encoded ASDUs */
+    int size = 0;
+
+    int index = getUpperBound(self, ca, -1);
+    int firstIndex = index;
+
+    while ((index < self->numberOfBlocks) && (self->blocks[index].ca == ca)) {
+        ProcessImageBlock block = &(self->blocks[index]);
+
+        if ((group == 0) || (block->group == group)) {
+            int maxPointsPerAsdu = (IEC60870_5_104_MAX_ASDU_LENGTH - headerSize - self->parameters->sizeOfIOA) / block->elementSize;
+
+            if (maxPointsPerAsdu > MAX_NUMBER_OF_OBJECTS)
+                maxPointsPerAsdu = MAX_NUMBER_OF_OBJECTS;
+
+            int numberOfAsdus = (block->numberOfPoints + maxPointsPerAsdu - 1) / maxPointsPerAsdu;
+
+            size += numberOfAsdus * (1 + headerSize + self->parameters->sizeOfIOA);
+            size += block->numberOfPoints * block->elementSize;
+        }
+
+        index++;
+    }
+
+    snapshot->size = size;
+    snapshot->asdus = (uint8_t*) GLOBAL_MALLOC((size > 0) ? size : 1);
+
+    if (snapshot->asdus == NULL) {
+        GLOBAL_FREEMEM(snapshot);
+        return NULL;
+    }
+
+    self->numberOfSnapshots++;
+
+    /* second pass: encode the ASDUs */
+    uint8_t* buffer = snapshot->asdus;
+
+    CauseOfTransmission cot = (CauseOfTransmission) (INTERROGATED_BY_STATION + group);
+
+    for (index = firstIndex; (index < self->numberOfBlocks) && (self->blocks[index].ca == ca); index++) {
+        ProcessImageBlock block = &(self->blocks[index]);
+
+        if ((group != 0) && (block->group != group))
+            continue;
+
+        int maxPointsPerAsdu = (IEC60870_5_104_MAX_ASDU_LENGTH - headerSize - self->parameters->sizeOfIOA) / block->elementSize;
+
+        if (maxPointsPerAsdu > MAX_NUMBER_OF_OBJECTS)
+            maxPointsPerAsdu = MAX_NUMBER_OF_OBJECTS;
+
+        int sentPoints = 0;
+
+        while (sentPoints < block->numberOfPoints) {
+
+            int numberOfPoints = block->numberOfPoints - sentPoints;
+
+            if (numberOfPoints > maxPointsPerAsdu)
+                numberOfPoints = maxPointsPerAsdu;
+
+            int asduSize = headerSize + self->parameters->sizeOfIOA + (numberOfPoints * block->elementSize);
+
+            buffer[0] = (uint8_t) asduSize;
+
+            uint8_t* asdu = buffer + 1;
+
+            /* header: type ID, VSQ (SQ=1), COT, (OA), CA */
+            int pos = 0;
+
+            asdu[pos++] = (uint8_t) block->typeId;
+            asdu[pos++] = (uint8_t) (0x80 | numberOfPoints);
+            asdu[pos++] = (uint8_t) cot;
+
+            if (self->parameters->sizeOfCOT > 1)
+                asdu[pos++] = 0;
+
+            asdu[pos++] = (uint8_t) (ca & 0xff);
+
+            if (self->parameters->sizeOfCA > 1)
+                asdu[pos++] = (uint8_t) ((ca / 0x100) & 0xff);
+
+            pos += encodeIOA(self, asdu + pos, block->startIoa + sentPoints);
+
+            memcpy(asdu + pos, block->elements + (sentPoints * block->elementSize), numberOfPoints * block->elementSize);
+
+            buffer += 1 + asduSize;
+
+            sentPoints += numberOfPoints;
+        }
+    }
+
+    return snapshot;
+}
+
+int
+ProcessImage_getNumberOfCachedSnapshots(ProcessImage self)
+{
+    int numberOfSnapshots = 0;
+
+    ProcessImage_lock(self);
+
+    InterrogationSnapshot snapshot = self->snapshots;
+
+    while (snapshot != NULL) {
+        numberOfSnapshots++;
+        snapshot = snapshot->next;
+    }
+
+    ProcessImage_unlock(self);
+
+    return numberOfSnapshots;
+}
+
+int
+ProcessImage_getNumberOfAllocatedSnapshots(ProcessImage self)
+{
+    ProcessImage_lock(self);
+
+    int numberOfSnapshots = self->numberOfSnapshots;
+
+    ProcessImage_unlock(self);
+
+    return numberOfSnapshots;
+}
+
+/* Get the current snapshot for the CA and group (or create it). Has to be called with the lock held. */
+static InterrogationSnapshot
+acquireSnapshot(ProcessImage self, int ca, int group)
+{
+    InterrogationSnapshot snapshot = self->snapshots;
+
+    while (snapshot != NULL) {
+        if ((snapshot->ca == ca) && (snapshot->group == group))
+            break;
+
+        snapshot = snapshot->next;
+    }
+
+    if (snapshot == NULL) {
+        snapshot = createSnapshot(self, ca, group);
+
+        if (snapshot == NULL)
+            return NULL;
+
+        snapshot->next = self->snapshots;
+        self->snapshots = snapshot;
+    }
+
+    snapshot->refCount++;
+
+    return snapshot;
+}
+
+typedef enum {
+    STREAM_CONFIRMATION, /* send ACT_CON for the current CA */
+    STREAM_POINTS, /* send the points of the current CA */
+    STREAM_TERMINATION, /* send ACT_TERM for the current CA */
+    STREAM_DONE
+} InterrogationStreamState;
+
+/* cursor of an interrogation response that is sent by a response stream of the connection */
+typedef struct sInterrogationStream* InterrogationStream;
+
+struct sInterrogationStream {
+    ProcessImage image;
+
+    int oa;
+    uint8_t qoi;
+    int group; /* 0 for station interrogation */
+    bool isBroadcast; /* all CAs are answered -> ACT_CON/ACT_TERM for each CA are part of the stream */
+
+    InterrogationStreamState state;
+    int ca; /* current CA */
+
+    InterrogationSnapshot snapshot; /* snapshot of the current CA (NULL when not yet acquired) */
+    int position; /* position of the next ASDU in the snapshot */
+
+    struct sStaticASDU asdu; /* memory of the ASDU that is returned to the connection */
+};
+
+/*
+ * Create the next ASDU with the points of the current CA from the snapshot.
+ * Returns NULL when all points of the CA have been sent.
+ */
+static ASDU
+createNextPointsASDU(ProcessImage self, InterrogationStream stream)
+{
+    if (stream->snapshot == NULL) {
+        ProcessImage_lock(self);
+        stream->snapshot = acquireSnapshot(self, stream->ca, stream->group);
+        ProcessImage_unlock(self);
+
+        stream->position = 0;
+
+        if (stream->snapshot == NULL) {
+            DEBUG_PRINT("Process image: failed to create interrogation snapshot\n");
+            return NULL;
+        }
+    }
+
+    InterrogationSnapshot snapshot = stream->snapshot;
+
+    if (stream->position >= snapshot->size) {
+        ProcessImage_lock(self);
+        releaseSnapshot(self, snapshot);
+        ProcessImage_unlock(self);
+
+        stream->snapshot = NULL;
+
+        return NULL;
+    }
+
+    /* the snapshot is not changed -> no lock required */
+    int asduSize = snapshot->asdus[stream->position];
+
+    ASDU asdu = ASDU_initializeStaticFromBuffer(&(stream->asdu), self->parameters,
+            snapshot->asdus + stream->position + 1, asduSize);
+
+    stream->position += 1 + asduSize;
+
+    /* the snapshot is shared by all clients -> set the OA of the request */
+    if (self->parameters->sizeOfCOT > 1)
+        stream->asdu.encodedData[3] = (uint8_t) stream->oa;
+
+    return asdu;
+}
+
+/* response producer of the interrogation stream */
+static ASDU
+produceInterrogationResponse(void* parameter, MasterConnection connection)
+{
+    InterrogationStream stream = (InterrogationStream) parameter;
+    ProcessImage self = stream->image;
+
+    ASDU asdu = NULL;
+
+    while ((asdu == NULL) && (stream->state != STREAM_DONE)) {
+
+        switch (stream->state) {
+
+        case STREAM_CONFIRMATION:
+            asdu = createInterrogationResponse(self, stream->oa, stream->ca, stream->qoi, ACTIVATION_CON);
+            stream->state = STREAM_POINTS;
+            break;
+
+        case STREAM_POINTS:
+            asdu = createNextPointsASDU(self, stream);
+
+            /* the ACT_TERM of a single CA is sent by the connection */
+            if (asdu == NULL)
+                stream->state = stream->isBroadcast ? STREAM_TERMINATION : STREAM_DONE;
+            break;
+
+        case STREAM_TERMINATION:
+            asdu = createInterrogationResponse(self, stream->oa, stream->ca, stream->qoi, ACTIVATION_TERMINATION);
+
+            ProcessImage_lock(self);
+
+            {
+                /* continue with the next CA */
+                int index = getUpperBound(self, stream->ca, INT_MAX);
+
+                if (index < self->numberOfBlocks) {
+                    stream->ca = self->blocks[index].ca;
+                    stream->state = STREAM_CONFIRMATION;
+                }
+                else
+                    stream->state = STREAM_DONE;
+            }
+
+            ProcessImage_unlock(self);
+            break;
+
+        default:
+            stream->state = STREAM_DONE;
+            break;
+        }
+    }
+
+    return asdu;
+}
+
+static void
+interrogationStreamFinished(void* parameter, MasterConnection connection, bool completed)
+{
+    InterrogationStream stream = (InterrogationStream) parameter;
+
+    if (completed == false)
+        DEBUG_PRINT("Process image: interrogation response stopped\n");
+
+    if (stream->snapshot != NULL) {
+        ProcessImage_lock(stream->image);
+        releaseSnapshot(stream->image, stream->snapshot);
+        ProcessImage_unlock(stream->image);
+    }
+
+    GLOBAL_FREEMEM(stream);
+}
+
+bool
+ProcessImage_interrogationHandler(void* parameter, MasterConnection connection, ASDU asdu, uint8_t qoi)
+{
+    ProcessImage self = (ProcessImage) parameter;
+
+    if (ASDU_getCOT(asdu) != ACTIVATION) {
+        /* stop the response that is sent */
+        bool stopped = MasterConnection_stopResponseStream(connection);
+
+        ASDU_setCOT(asdu, DEACTIVATION_CON);
+        ASDU_setNegative(asdu, (stopped == false));
+        MasterConnection_sendASDU(connection, asdu);
+
+        return true;
+    }
+
+    if ((qoi < INTERROGATED_BY_STATION) || (qoi > INTERROGATED_BY_GROUP_16)) {
+        MasterConnection_sendACT_CON(connection, asdu, true);
+
+        return true;
+    }
+
+    int requestedCa = ASDU_getCA(asdu);
+
+    bool isBroadcast = isBroadcastAddress(self, requestedCa);
+
+    ProcessImage_lock(self);
+
+    /* first block of the CA (or first block at all for broadcast) */
+    int index = 0;
+
+    if (isBroadcast == false)
+        index = getUpperBound(self, requestedCa, -1);
+
+    bool caFound = ((index < self->numberOfBlocks) && (isBroadcast || (self->blocks[index].ca == requestedCa)));
+
+    int firstCa = caFound ? self->blocks[index].ca : requestedCa;
+
+    ProcessImage_unlock(self);
+
+    if (caFound == false) {
+        ASDU_setCOT(asdu, UNKNOWN_COMMON_ADDRESS_OF_ASDU);
+        ASDU_setNegative(asdu, true);
+        MasterConnection_sendASDU(connection, asdu);
+
+        return true;
+    }
+
+    InterrogationStream stream = (InterrogationStream) GLOBAL_MALLOC(sizeof(struct sInterrogationStream));
+
+    if (stream == NULL) {
+        MasterConnection_sendACT_CON(connection, asdu, true);
+
+        return true;
+    }
+
+    stream->image = self;
+    stream->oa = ASDU_getOA(asdu);
+    stream->qoi = qoi;
+    stream->group = qoi - INTERROGATED_BY_STATION;
+    stream->isBroadcast = isBroadcast;
+    stream->state = isBroadcast ? STREAM_CONFIRMATION : STREAM_POINTS;
+    stream->ca = firstCa;
+    stream->snapshot = NULL;
+    stream->position = 0;
+
+    /* for a single CA the connection terminates the response with ACT_TERM of the request */
+    if (MasterConnection_startResponseStream(connection, isBroadcast ? NULL : asdu,
+            produceInterrogationResponse, interrogationStreamFinished, stream) == false) {
+
+        /* another response is sent */
+        GLOBAL_FREEMEM(stream);
+
+        MasterConnection_sendACT_CON(connection, asdu, true);
+
+        return true;
+    }
+
+    /* sent before the first ASDU of the stream */
+    if (isBroadcast == false)
+        MasterConnection_sendACT_CON(connection, asdu, false);
+
+    return true;
+}
+
+bool
+ProcessImage_readHandler(void* parameter, MasterConnection connection, ASDU asdu, int ioa)
+{
+    ProcessImage self = (ProcessImage) parameter;
+
+    int ca = ASDU_getCA(asdu);
+
+    uint8_t object[16];
+    int size = 0;
+
+    TypeID typeId = M_SP_NA_1;
+
+    ProcessImage_lock(self);
+
+    ProcessImageBlock block = findBlock(self, ca, ioa);
+
+    if (block != NULL) {
+        typeId = block->typeId;
+
+        size = encodeIOA(self, object, ioa);
+
+        memcpy(object + size, block->elements + ((ioa - block->startIoa) * block->elementSize), block->elementSize);
+        size += block->elementSize;
+    }
+
+    ProcessImage_unlock(self);
+
+    if (block == NULL) {
+        ASDU_setCOT(asdu, UNKNOWN_INFORMATION_OBJECT_ADDRESS);
+        ASDU_setNegative(asdu, true);
+        MasterConnection_sendASDU(connection, asdu);
+
+        return true;
+    }
+
+    ASDU response = ASDU_create(self->parameters, typeId, false, REQUEST, ASDU_getOA(asdu), ca, false, false);
+
+    if (response != NULL) {
+        ASDU_addEncodedObjects(response, object, size, 1);
+
+        MasterConnection_sendASDU(connection, response);
+    }
+
+    return true;
+}
@@ -0,0 +1,169 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include <string.h>
+
+#include "t104_asdu_packer.h"
+#include "hal_time.h"
+#include "lib_memory.h"
+#include "lib60870_internal.h"
+
+/* maximum number of information objects of an ASDU (7 bit of the variable structure qualifier) */
+#define MAX_NUMBER_OF_OBJECTS 127
+
+struct sAsduPacker {
+    int headerSize; /* size of the data unit identifier */
+    int sizeOfIOA;
+
+    int maxDelay; /* in ms */
+
+    uint64_t entrySeqNo; /* sequence number of the newest entry that has been added */
+    uint64_t entryTime; /* time when the entry has been added */
+};
+
+AsduPacker
+AsduPacker_create(ConnectionParameters parameters, int maxDelayInMs)
+{
+    AsduPacker self = (AsduPacker) GLOBAL_MALLOC(sizeof(struct sAsduPacker));
+
+    if (self != NULL) {
+        self->headerSize = 2 + parameters->sizeOfCOT + parameters->sizeOfCA;
+        self->sizeOfIOA = parameters->sizeOfIOA;
+        self->maxDelay = maxDelayInMs;
+        self->entrySeqNo = 0;
+        self->entryTime = 0;
+    }
+
+    return self;
+}
+
+void
+AsduPacker_destroy(AsduPacker self)
+{
+    if (self != NULL)
+        GLOBAL_FREEMEM(self);
+}
+
+/* process information in monitor direction without a sequence of elements */
+static bool
+isPackable(AsduPacker self, const uint8_t* asdu, int asduSize)
+{
+    if (asduSize < (self->headerSize + self->sizeOfIOA))
+        return false;
+
+    if ((asdu[0] < M_SP_NA_1) || (asdu[0] > M_EP_TF_1))
+        return false;
+
+    if (((asdu[1] & 0x80) != 0) || ((asdu[1] & 0x7f) == 0))
+        return false;
+
+    return true;
+}
+
+/* check if another information object of the same size fits into the entry */
+static bool
+canGrow(AsduPacker self, const uint8_t* entry, int entrySize)
+{
+    int numberOfObjects = entry[1] & 0x7f;
+
+    if (numberOfObjects >= MAX_NUMBER_OF_OBJECTS)
+        return false;
+
+    int objectSize = (entrySize - self->headerSize) / numberOfObjects;
+
+    return ((entrySize + objectSize) <= IEC60870_5_104_MAX_ASDU_LENGTH);
+}
+
+bool
+AsduPacker_pack(AsduPacker self, MessageRing ring, uint64_t firstUnsentSeqNo, const uint8_t* asdu, int asduSize)
+{
+    if (isPackable(self, asdu, asduSize) == false)
+        return false;
+
+    int entrySize;
+    uint8_t* entry = MessageRing_getNewest(ring, &entrySize);
+
+    if (entry == NULL)
+        return false;
+
+    /* the newest entry has already been sent */
+    if ((ring->committedSeqNo - 1) < firstUnsentSeqNo)
+        return false;
+
+    if (isPackable(self, entry, entrySize) == false)
+        return false;
+
+    /* same type ID, cause of transmission, originator address, and CA */
+    if ((entry[0] != asdu[0]) || (memcmp(entry + 2, asdu + 2, self->headerSize - 2) != 0))
+        return false;
+
+    int numberOfObjects = (entry[1] & 0x7f) + (asdu[1] & 0x7f);
+
+    if (numberOfObjects > MAX_NUMBER_OF_OBJECTS)
+        return false;
+
+    int objectsSize = asduSize - self->headerSize;
+
+    if ((entrySize + objectsSize) > IEC60870_5_104_MAX_ASDU_LENGTH)
+        return false;
+
+    uint8_t* objects = MessageRing_extendNewest(ring, objectsSize);
+
+    if (objects == NULL)
+        return false;
+
+    memcpy(objects, asdu + self->headerSize, objectsSize);
+
+    entry[1] = (uint8_t) numberOfObjects;
+
+    return true;
+}
+
+void
+AsduPacker_entryAdded(AsduPacker self, uint64_t seqNo)
+{
+    self->entrySeqNo = seqNo;
+    self->entryTime = Hal_getTimeInMs();
+}
+
+int
+AsduPacker_getSendDelay(AsduPacker self, MessageRing ring, uint64_t seqNo)
+{
+    if ((self->maxDelay <= 0) || (seqNo != self->entrySeqNo))
+        return 0;
+
+    int entrySize;
+    uint8_t* entry = MessageRing_getNewest(ring, &entrySize);
+
+    /* only the newest entry can grow */
+    if ((entry == NULL) || (seqNo != (ring->committedSeqNo - 1)))
+        return 0;
+
+    if ((isPackable(self, entry, entrySize) == false) || (canGrow(self, entry, entrySize) == false))
+        return 0;
+
+    uint64_t elapsed = Hal_getTimeInMs() - self->entryTime;
+
+    if (elapsed >= (uint64_t) self->maxDelay)
+        return 0;
+
+    return self->maxDelay - (int) elapsed;
+}
@@ -0,0 +1,184 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include "t104_coalescing_index.h"
+#include "lib_memory.h"
+
+struct sCoalescingIndexSlot {
+    uint64_t key;
+    uint64_t seqNo;
+    uint8_t* entry;
+};
+
+struct sCoalescingIndex {
+    int sizeOfCOT;
+    int sizeOfCA;
+    int sizeOfIOA;
+
+    int size; /* number of slots - always a power of two */
+
+    struct sCoalescingIndexSlot* slots;
+};
+
+CoalescingIndex
+CoalescingIndex_create(ConnectionParameters parameters, int minSize)
+{
+    CoalescingIndex self = (CoalescingIndex) GLOBAL_MALLOC(sizeof(struct sCoalescingIndex));
+
+    if (self != NULL) {
+        int size = 1;
+
+        while (size < minSize)
+            size = size * 2;
+
+        self->slots = (struct sCoalescingIndexSlot*) GLOBAL_CALLOC(size, sizeof(struct sCoalescingIndexSlot));
+
+        if (self->slots == NULL) {
+            GLOBAL_FREEMEM(self);
+            return NULL;
+        }
+
+        self->size = size;
+        self->sizeOfCOT = parameters->sizeOfCOT;
+        self->sizeOfCA = parameters->sizeOfCA;
+        self->sizeOfIOA = parameters->sizeOfIOA;
+    }
+
+    return self;
+}
+
+void
+CoalescingIndex_destroy(CoalescingIndex self)
+{
+    if (self != NULL) {
+        GLOBAL_FREEMEM(self->slots);
+        GLOBAL_FREEMEM(self);
+    }
+}
+
+static bool
+isMeasuredValue(int typeId)
+{
+    switch (typeId) {
+    case M_ME_NA_1:
+    case M_ME_TA_1:
+    case M_ME_NB_1:
+    case M_ME_TB_1:
+    case M_ME_NC_1:
+    case M_ME_TC_1:
+    case M_ME_ND_1:
+    case M_ME_TD_1:
+    case M_ME_TE_1:
+    case M_ME_TF_1:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*
+ * Get the key of an encoded ASDU. Returns 0 when the ASDU cannot be replaced.
+ *
+ * key: type ID (8 bit), cause of transmission (6 bit), CA (16 bit), IOA (24 bit)
+ */
+static uint64_t
+getKey(CoalescingIndex self, const uint8_t* asdu, int asduSize)
+{
+    int headerSize = 2 + self->sizeOfCOT + self->sizeOfCA;
+
+    if (asduSize < (headerSize + self->sizeOfIOA))
+        return 0;
+
+    /* only measured values with a single information object (no test messages) */
+    if ((isMeasuredValue(asdu[0]) == false) || (asdu[1] != 1) || ((asdu[2] & 0x80) != 0))
+        return 0;
+
+    uint64_t key = asdu[0];
+
+    key = (key << 6) | (asdu[2] & 0x3f);
+
+    int ca = asdu[2 + self->sizeOfCOT];
+
+    if (self->sizeOfCA > 1)
+        ca += (asdu[3 + self->sizeOfCOT] * 0x100);
+
+    key = (key << 16) | (uint64_t) ca;
+
+    int ioa = 0;
+    int i;
+
+    for (i = 0; i < self->sizeOfIOA; i++)
+        ioa += (asdu[headerSize + i] << (i * 8));
+
+    key = (key << 24) | (uint64_t) ioa;
+
+    return key;
+}
+
+static struct sCoalescingIndexSlot*
+getSlot(CoalescingIndex self, uint64_t key)
+{
+    /* Fibonacci hashing */
+    uint64_t hash = key * 0x9e3779b97f4a7c15ull;
+
+    return &(self->slots[(hash >> 32) & (uint64_t) (self->size - 1)]);
+}
+
+uint8_t*
+CoalescingIndex_lookup(CoalescingIndex self, MessageRing ring, uint64_t firstUnsentSeqNo,
+        const uint8_t* asdu, int asduSize)
+{
+    uint64_t key = getKey(self, asdu, asduSize);
+
+    if (key == 0)
+        return NULL;
+
+    struct sCoalescingIndexSlot* slot = getSlot(self, key);
+
+    if ((slot->entry == NULL) || (slot->key != key))
+        return NULL;
+
+    /* the entry has to be committed, not yet sent, and not yet removed */
+    if ((slot->seqNo < firstUnsentSeqNo) || (slot->seqNo < ring->oldestSeqNo) ||
+            (slot->seqNo >= ring->committedSeqNo))
+        return NULL;
+
+    /* other information objects have been packed into the entry */
+    if (slot->entry[1] != 1)
+        return NULL;
+
+    return slot->entry;
+}
+
+void
+CoalescingIndex_add(CoalescingIndex self, uint8_t* entry, int entrySize, uint64_t seqNo)
+{
+    uint64_t key = getKey(self, entry, entrySize);
+
+    if (key == 0)
+        return;
+
+    struct sCoalescingIndexSlot* slot = getSlot(self, key);
+
+    slot->key = key;
+    slot->seqNo = seqNo;
+    slot->entry = entry;
+}
@@ -30,8 +30,10 @@
 #include "hal_socket.h"
 #include "hal_time.h"
 #include "lib_memory.h"
+#include "timer_wheel.h"
 
 #include "t104_connection.h"
+#include "t104_receive_buffer.h"
 #include "apl_types_internal.h"
 #include "information_objects_internal.h"
 #include "lib60870_internal.h"
@@ -86,11 +88,16 @@ struct sT104Connection {
     int unconfirmedReceivedIMessages;
     uint64_t lastConfirmationTime;
 
-    uint64_t nextT3Timeout;
     int outstandingTestFCConMessages;
 
     uint64_t uMessageTimeout;
 
+    TimerWheel timerWheel; /* only used by the connection handling thread */
+    struct sTimerWheelTimer t1Timer; /* timeout for confirmation of sent I and U messages */
+    struct sTimerWheelTimer t2Timer; /* timeout for sending confirmation of received I messages */
+    struct sTimerWheelTimer t3Timer; /* timeout for sending test frames */
+    bool timeoutDetected;
+
     Socket socket;
     bool running;
     bool failure;
@@ -176,6 +183,8 @@ T104Connection_create(const char* hostname, int tcpPort)
 
         self->sentASDUs = NULL;
 
+        self->timerWheel = NULL;
+
         prepareSMessage(self->sMessage);
     }
 
@@ -209,11 +218,13 @@ resetConnection(T104Connection self)
 
     self->outstandingTestFCConMessages = 0;
     self->uMessageTimeout = 0;
+    self->timeoutDetected = false;
 }
 
 static void
-resetT3Timeout(T104Connection self) {
-    self->nextT3Timeout = Hal_getTimeInMs() + (self->parameters.t3 * 1000);
+resetT3Timeout(T104Connection self, uint64_t currentTime)
+{
+    TimerWheel_arm(self->timerWheel, &(self->t3Timer), currentTime + (uint64_t) (self->parameters.t3 * 1000));
 }
 
 static bool
@@ -357,38 +368,6 @@ T104Connection_getConnectionParameters(T104Connection self)
     return &(self->parameters);
 }
 
-static int
-receiveMessage(Socket socket, uint8_t* buffer)
-{
-    int readFirst = Socket_read(socket, buffer, 1);
-
-    if (readFirst < 1)
-        return readFirst;
-
-    if (buffer[0] != 0x68)
-        return -1; /* message error */
-
-    if (Socket_read(socket, buffer + 1, 1) != 1)
-        return -1;
-
-    int length = buffer[1];
-
-    /* read remaining frame */
-    if (Socket_read(socket, buffer + 2, length) != length)
-        return -1;
-
-    return length + 2;
-}
-
-static bool
-checkConfirmTimeout(T104Connection self, long currentTime)
-{
-    if ((currentTime - self->lastConfirmationTime) >= (uint32_t) (self->parameters.t2 * 1000))
-        return true;
-    else
-        return false;
-}
-
 static bool
 checkMessage(T104Connection self, uint8_t* buffer, int msgSize)
 {
@@ -421,13 +400,19 @@ checkMessage(T104Connection self, uint8_t* buffer, int msgSize)
         self->receiveCount = (self->receiveCount + 1) % 32768;
         self->unconfirmedReceivedIMessages++;
 
-        ASDU asdu = ASDU_createFromBuffer((ConnectionParameters)&(self->parameters), buffer + 6, msgSize - 6);
+        /* start timeout T2 */
+        if (TimerWheelTimer_isArmed(&(self->t2Timer)) == false)
+            TimerWheel_arm(self->timerWheel, &(self->t2Timer),
+                    self->lastConfirmationTime + (uint64_t) (self->parameters.t2 * 1000));
+
+        /* the ASDU refers to the receive buffer (nothing is allocated) */
+        struct sASDU asduMemory;
+
+        ASDU asdu = ASDU_initializeFromBuffer(&asduMemory, (ConnectionParameters)&(self->parameters), buffer + 6, msgSize - 6);
 
         if (asdu != NULL) {
             if (self->receivedHandler != NULL)
                 self->receivedHandler(self->receivedHandlerParameter, asdu);
-
-            ASDU_destroy(asdu);
         }
         else
             return false;
@@ -475,75 +460,89 @@ checkMessage(T104Connection self, uint8_t* buffer, int msgSize)
     }
 
 
-    resetT3Timeout(self);
+    resetT3Timeout(self, Hal_getTimeInMs());
 
     return true;
 }
 
-static bool
-handleTimeouts(T104Connection self)
+static void
+handleT1Timeout(void* parameter)
 {
-    bool retVal = true;
-
-    uint64_t currentTime = Hal_getTimeInMs();
+    T104Connection self = (T104Connection) parameter;
 
-    if (currentTime > self->nextT3Timeout) {
+    DEBUG_PRINT("T1 timeout (I or U message not confirmed)\n");
 
-        if (self->outstandingTestFCConMessages > 2) {
-            DEBUG_PRINT("Timeout for TESTFR_CON message\n");
+    /* close connection */
+    self->timeoutDetected = true;
+}
 
-            /* close connection */
-            retVal = false;
-            goto exit_function;
-        }
-        else {
-            DEBUG_PRINT("U message T3 timeout\n");
+static void
+handleT2Timeout(void* parameter)
+{
+    T104Connection self = (T104Connection) parameter;
 
-            Socket_write(self->socket, TESTFR_ACT_MSG, TESTFR_ACT_MSG_SIZE);
-            self->uMessageTimeout = currentTime + (self->parameters.t1 * 1000);
-            self->outstandingTestFCConMessages++;
+    if (self->unconfirmedReceivedIMessages > 0) {
+        self->lastConfirmationTime = Hal_getTimeInMs();
+        self->unconfirmedReceivedIMessages = 0;
 
-            resetT3Timeout(self);
-        }
+        sendSMessage(self); /* send confirmation message */
     }
+}
 
-    if (self->unconfirmedReceivedIMessages > 0) {
-
-        if (checkConfirmTimeout(self, currentTime)) {
+static void
+handleT3Timeout(void* parameter)
+{
+    T104Connection self = (T104Connection) parameter;
 
-            self->lastConfirmationTime = currentTime;
-            self->unconfirmedReceivedIMessages = 0;
+    if (self->outstandingTestFCConMessages > 2) {
+        DEBUG_PRINT("Timeout for TESTFR_CON message\n");
 
-            sendSMessage(self); /* send confirmation message */
-        }
+        /* close connection */
+        self->timeoutDetected = true;
     }
+    else {
+        DEBUG_PRINT("U message T3 timeout\n");
 
-    if (self->uMessageTimeout != 0) {
-        if (currentTime > self->uMessageTimeout) {
-            DEBUG_PRINT("U message T1 timeout\n");
-            retVal = false;
-            goto exit_function;
-        }
+        uint64_t currentTime = Hal_getTimeInMs();
+
+        Socket_write(self->socket, TESTFR_ACT_MSG, TESTFR_ACT_MSG_SIZE);
+        self->uMessageTimeout = currentTime + (self->parameters.t1 * 1000);
+        self->outstandingTestFCConMessages++;
+
+        resetT3Timeout(self, currentTime);
     }
+}
+
+/**
+ * Start, restart, or stop timeout T1 according to the oldest unconfirmed I message and the
+ * outstanding U message confirmation
+ */
+static void
+updateT1Timeout(T104Connection self)
+{
+    uint64_t expiryTime = self->uMessageTimeout;
 
-    /* check if counterpart confirmed I messages */
 #if (CONFIG_MASTER_USING_THREADS == 1)
     Semaphore_wait(self->sentASDUsLock);
 #endif
+
     if (self->oldestSentASDU != -1) {
-        if ((currentTime - self->sentASDUs[self->oldestSentASDU].sentTime) >= (uint64_t) (self->parameters.t1 * 1000)) {
-            DEBUG_PRINT("I message timeout\n");
-            retVal = false;
-        }
+        uint64_t iMessageTimeout = self->sentASDUs[self->oldestSentASDU].sentTime +
+                (uint64_t) (self->parameters.t1 * 1000);
+
+        if ((expiryTime == 0) || (iMessageTimeout < expiryTime))
+            expiryTime = iMessageTimeout;
     }
+
 #if (CONFIG_MASTER_USING_THREADS == 1)
     Semaphore_post(self->sentASDUsLock);
 #endif
 
-
-exit_function:
-
-    return retVal;
+    if (expiryTime == 0)
+        TimerWheel_cancel(self->timerWheel, &(self->t1Timer));
+    else if ((TimerWheelTimer_isArmed(&(self->t1Timer)) == false) ||
+            (TimerWheelTimer_getExpiryTime(&(self->t1Timer)) != expiryTime))
+        TimerWheel_arm(self->timerWheel, &(self->t1Timer), expiryTime);
 }
 
 static void*
@@ -565,19 +564,34 @@ handleConnection(void* parameter)
         if (self->connectionHandler != NULL)
             self->connectionHandler(self->connectionHandlerParameter, self, IEC60870_CONNECTION_OPENED);
 
-        HandleSet handleSet = Handleset_new();
+        PollSet pollSet = PollSet_create();
 
-        bool loopRunning = true;
+        struct sT104ReceiveBuffer recvBuffer;
+        T104ReceiveBuffer_initialize(&recvBuffer);
 
-        while (loopRunning) {
+        TimerWheel timerWheel = TimerWheel_create(Hal_getTimeInMs());
 
-            uint8_t buffer[300];
+        self->timerWheel = timerWheel;
 
-            Handleset_reset(handleSet);
-            Handleset_addSocket(handleSet, self->socket);
+        TimerWheelTimer_initialize(&(self->t1Timer), handleT1Timeout, self);
+        TimerWheelTimer_initialize(&(self->t2Timer), handleT2Timeout, self);
+        TimerWheelTimer_initialize(&(self->t3Timer), handleT3Timeout, self);
 
-            if (Handleset_waitReady(handleSet, 100)) {
-                int bytesRec = receiveMessage(self->socket, buffer);
+        bool loopRunning = ((timerWheel != NULL) && (pollSet != NULL));
+
+        if (loopRunning)
+            loopRunning = PollSet_addSocket(pollSet, self->socket, (void*) self);
+
+        if (loopRunning)
+            resetT3Timeout(self, Hal_getTimeInMs());
+
+        while (loopRunning) {
+
+            /* ASDUs can be sent by other threads - so check timeout T1 at least every 100 ms */
+            int socketTimeout = TimerWheel_getTimeout(timerWheel, Hal_getTimeInMs(), 100);
+
+            if (PollSet_waitReady(pollSet, socketTimeout) > 0) {
+                int bytesRec = T104ReceiveBuffer_fill(&recvBuffer, self->socket);
 
                 if (bytesRec == -1) {
                     loopRunning = false;
@@ -585,30 +599,54 @@ handleConnection(void* parameter)
                 }
 
                 if (bytesRec > 0) {
-                    //TODO call raw message handler if available
+                    uint8_t* msg;
+                    int msgSize;
 
-                    if (checkMessage(self, buffer, bytesRec) == false) {
-                        /* close connection on error */
-                        loopRunning= false;
-                        self->failure = true;
-                    }
-                }
+                    while (loopRunning && ((msgSize = T104ReceiveBuffer_getNextMessage(&recvBuffer, &msg)) != 0)) {
+
+                        //TODO call raw message handler if available
+
+                        if ((msgSize == -1) || (checkMessage(self, msg, msgSize) == false)) {
+                            /* close connection on error */
+                            loopRunning= false;
+                            self->failure = true;
+                        }
 
-                if (self->unconfirmedReceivedIMessages >= self->parameters.w) {
-                    self->lastConfirmationTime = Hal_getTimeInMs();
-                    self->unconfirmedReceivedIMessages = 0;
-                    sendSMessage(self);
+                        if (self->unconfirmedReceivedIMessages >= self->parameters.w) {
+                            self->lastConfirmationTime = Hal_getTimeInMs();
+                            self->unconfirmedReceivedIMessages = 0;
+                            TimerWheel_cancel(timerWheel, &(self->t2Timer));
+                            sendSMessage(self);
+                        }
+                    }
                 }
             }
 
-            if (handleTimeouts(self) == false)
+            updateT1Timeout(self);
+
+            TimerWheel_advance(timerWheel, Hal_getTimeInMs());
+
+            if (self->timeoutDetected)
                 loopRunning = false;
 
             if (self->close)
                 loopRunning = false;
         }
 
-        Handleset_destroy(handleSet);
+        if (pollSet != NULL) {
+            PollSet_removeSocket(pollSet, self->socket);
+            PollSet_destroy(pollSet);
+        }
+
+        if (timerWheel != NULL) {
+            TimerWheel_cancel(timerWheel, &(self->t1Timer));
+            TimerWheel_cancel(timerWheel, &(self->t2Timer));
+            TimerWheel_cancel(timerWheel, &(self->t3Timer));
+
+            TimerWheel_destroy(timerWheel);
+        }
+
+        self->timerWheel = NULL;
 
         /* Call connection handler */
         if (self->connectionHandler != NULL)
@@ -632,8 +670,6 @@ T104Connection_connectAsync(T104Connection self)
 {
     resetConnection(self);
 
-    resetT3Timeout(self);
-
     self->connectionHandlingThread = Thread_create(handleConnection, (void*) self, false);
 
     if (self->connectionHandlingThread)
@@ -0,0 +1,736 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "t104_message_queue.h"
+#include "buffer_frame.h"
+#include "message_ring.h"
+#include "hal_thread.h"
+#include "lib_memory.h"
+
+#include "lib60870_config.h"
+#include "lib60870_internal.h"
+
+#include "apl_types_internal.h"
+#include "t104_coalescing_index.h"
+#include "t104_asdu_packer.h"
+
+#ifndef CONFIG_SLAVE_COALESCING_INDEX_SIZE
+#define CONFIG_SLAVE_COALESCING_INDEX_SIZE 1024
+#endif
+
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+#include "hal_mapped_file.h"
+
+#define PERSISTENT_QUEUE_MAGIC 0x51303631 /* "160Q" */
+#define PERSISTENT_QUEUE_VERSION 2
+
+/* the messages are stored behind the header */
+#define PERSISTENT_QUEUE_HEADER_SIZE 128
+
+/*
+ * State of the message ring. The header contains two copies that are written
+ * alternately. When the process is terminated while a state is written, the
+ * other copy is still valid.
+ */
+struct sPersistentQueueState {
+    uint64_t generation; /* incremented with every write of the state */
+    uint64_t oldestSeqNo;
+    uint64_t nextSeqNo;
+    uint32_t oldestPos;
+    uint32_t nextPos;
+    uint32_t checksum;
+    uint32_t reserved;
+};
+
+struct sPersistentQueueHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t bufferSize;
+    uint32_t reserved;
+
+    struct sPersistentQueueState states[2];
+};
+#endif /* (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1) */
+
+struct sMessageQueue {
+    int size; /* number of maximum size ASDUs that fit into the queue */
+
+    struct sMessageRing ring;
+
+    MessageRingCursor sendCursor; /* next entry to send */
+
+    QueueOverflowPolicy overflowPolicy;
+    QueueSpillHandler spillHandler;
+    void* spillHandlerParameter;
+
+    CoalescingIndex coalescingIndex; /* NULL when the coalescing is not enabled */
+    AsduPacker packer; /* NULL when the packing is not enabled */
+
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+    MappedFile file; /* NULL when the queue is not persistent */
+    struct sPersistentQueueHeader* header;
+    uint64_t generation;
+
+    /* end of the committed entries that are written to the file */
+    uint64_t syncedSeqNo;
+    int syncedPos;
+#endif
+
+#if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE == 1)
+    uint8_t buffer[CONFIG_SLAVE_ASDU_QUEUE_SIZE * MESSAGE_QUEUE_ENTRY_SIZE];
+#else
+    uint8_t* buffer;
+#endif
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore queueLock;
+#endif
+};
+
+MessageQueue
+MessageQueue_create(int maxQueueSize)
+{
+    MessageQueue self = (MessageQueue) GLOBAL_MALLOC(sizeof(struct sMessageQueue));
+
+    if (self != NULL) {
+
+#if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE == 1)
+        self->size = CONFIG_SLAVE_ASDU_QUEUE_SIZE;
+#else
+        if (maxQueueSize < 1)
+            maxQueueSize = CONFIG_SLAVE_ASDU_QUEUE_SIZE;
+
+        self->size = maxQueueSize;
+
+        self->buffer = (uint8_t*) GLOBAL_MALLOC(self->size * MESSAGE_QUEUE_ENTRY_SIZE);
+#endif
+
+        MessageRing_initialize(&(self->ring), self->buffer, self->size * MESSAGE_QUEUE_ENTRY_SIZE);
+        MessageRing_getEnd(&(self->ring), &(self->sendCursor));
+
+        self->overflowPolicy = QUEUE_OVERFLOW_DROP_OLDEST;
+        self->spillHandler = NULL;
+        self->spillHandlerParameter = NULL;
+        self->coalescingIndex = NULL;
+        self->packer = NULL;
+
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+        self->file = NULL;
+        self->header = NULL;
+#endif
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+        self->queueLock = Semaphore_create(1);
+#endif
+    }
+
+    return self;
+}
+
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+
+static uint32_t
+getStateChecksum(struct sPersistentQueueState* state)
+{
+    /* FNV-1a hash of the state (without checksum) */
+    uint8_t* bytes = (uint8_t*) state;
+    uint32_t hash = 2166136261u;
+
+    int i;
+
+    for (i = 0; i < (int) offsetof(struct sPersistentQueueState, checksum); i++) {
+        hash = hash ^ bytes[i];
+        hash = hash * 16777619u;
+    }
+
+    return hash;
+}
+
+static bool
+isStateValid(struct sPersistentQueueState* state, int bufferSize)
+{
+    if (state->checksum != getStateChecksum(state))
+        return false;
+
+    if ((state->oldestPos > (uint32_t) bufferSize) || (state->nextPos > (uint32_t) bufferSize))
+        return false;
+
+    if (state->oldestSeqNo > state->nextSeqNo)
+        return false;
+
+    return true;
+}
+
+/*
+ * Write the entries that have been committed since the last state to the file
+ */
+static void
+syncCommittedEntries(MessageQueue self)
+{
+    int start = self->syncedPos;
+    int end = self->ring.committedPos;
+
+    if (self->ring.committedSeqNo == self->syncedSeqNo)
+        return;
+
+    /* the entries continue at the beginning of the buffer */
+    if (end <= start) {
+        MappedFile_sync(self->file, PERSISTENT_QUEUE_HEADER_SIZE + start, self->ring.size - start);
+        start = 0;
+    }
+
+    if (end > start)
+        MappedFile_sync(self->file, PERSISTENT_QUEUE_HEADER_SIZE + start, end - start);
+
+    self->syncedSeqNo = self->ring.committedSeqNo;
+    self->syncedPos = end;
+}
+
+/*
+ * write the state of the message ring to the file (has to be called with the queue lock held).
+ * Reserved entries that are not yet committed are not part of the state. The entries are
+ * written to the file before the state that refers to them, so a state that is stored in
+ * the file never refers to entries that are lost when the operating system fails.
+ */
+static void
+saveState(MessageQueue self)
+{
+    if (self->header == NULL)
+        return;
+
+    syncCommittedEntries(self);
+
+    self->generation++;
+
+    struct sPersistentQueueState* state = &(self->header->states[self->generation % 2]);
+
+    state->generation = self->generation;
+    state->oldestSeqNo = self->ring.oldestSeqNo;
+    state->nextSeqNo = self->ring.committedSeqNo;
+    state->oldestPos = (uint32_t) self->ring.oldestPos;
+    state->nextPos = (uint32_t) self->ring.committedPos;
+    state->reserved = 0;
+    state->checksum = getStateChecksum(state);
+}
+
+/* restore the state of the message ring from the file. Returns false when the file contains no valid state. */
+static bool
+restoreState(MessageQueue self, int bufferSize)
+{
+    struct sPersistentQueueHeader* header = self->header;
+
+    if ((header->magic != PERSISTENT_QUEUE_MAGIC) || (header->version != PERSISTENT_QUEUE_VERSION) ||
+            (header->bufferSize != (uint32_t) bufferSize))
+        return false;
+
+    struct sPersistentQueueState* state = NULL;
+
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        if (isStateValid(&(header->states[i]), bufferSize)) {
+            if ((state == NULL) || (header->states[i].generation > state->generation))
+                state = &(header->states[i]);
+        }
+    }
+
+    if (state == NULL)
+        return false;
+
+    self->ring.oldestSeqNo = state->oldestSeqNo;
+    self->ring.committedSeqNo = state->nextSeqNo;
+    self->ring.nextSeqNo = state->nextSeqNo;
+    self->ring.oldestPos = (int) state->oldestPos;
+    self->ring.committedPos = (int) state->nextPos;
+    self->ring.nextPos = (int) state->nextPos;
+
+    /* the entries of a damaged file would be sent to the clients */
+    if (MessageRing_isConsistent(&(self->ring), IEC60870_5_104_MAX_ASDU_LENGTH) == false) {
+        DEBUG_PRINT("Queued entries in file are not valid\n");
+
+        MessageRing_initialize(&(self->ring), self->ring.buffer, bufferSize);
+
+        return false;
+    }
+
+    self->generation = state->generation;
+
+    return true;
+}
+
+MessageQueue
+MessageQueue_createPersistent(const char* fileName, int fileSize)
+{
+    int bufferSize = fileSize - PERSISTENT_QUEUE_HEADER_SIZE;
+
+    if (bufferSize < MESSAGE_QUEUE_ENTRY_SIZE)
+        return NULL;
+
+    MappedFile file = MappedFile_open(fileName, fileSize);
+
+    if (file == NULL)
+        return NULL;
+
+    MessageQueue self = (MessageQueue) GLOBAL_MALLOC(sizeof(struct sMessageQueue));
+
+    if (self == NULL) {
+        MappedFile_close(file);
+        return NULL;
+    }
+
+    uint8_t* buffer = MappedFile_getBuffer(file);
+
+    self->size = bufferSize / MESSAGE_QUEUE_ENTRY_SIZE;
+    self->file = file;
+    self->header = (struct sPersistentQueueHeader*) buffer;
+
+#if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE != 1)
+    self->buffer = NULL;
+#endif
+
+    MessageRing_initialize(&(self->ring), buffer + PERSISTENT_QUEUE_HEADER_SIZE, bufferSize);
+
+    bool isRestored = restoreState(self, bufferSize);
+
+    /* the restored entries are already stored in the file */
+    self->syncedSeqNo = self->ring.committedSeqNo;
+    self->syncedPos = self->ring.committedPos;
+
+    if (isRestored == false) {
+        DEBUG_PRINT("No valid queue state in file -> start with empty queue\n");
+
+        self->header->magic = PERSISTENT_QUEUE_MAGIC;
+        self->header->version = PERSISTENT_QUEUE_VERSION;
+        self->header->bufferSize = (uint32_t) bufferSize;
+        self->header->reserved = 0;
+
+        /* a damaged state with a higher generation must not be restored later */
+        memset(self->header->states, 0, sizeof(self->header->states));
+
+        self->generation = 0;
+
+        saveState(self);
+    }
+
+    /* all entries that are not confirmed are sent again */
+    MessageRing_getOldest(&(self->ring), &(self->sendCursor));
+
+    self->overflowPolicy = QUEUE_OVERFLOW_DROP_OLDEST;
+    self->spillHandler = NULL;
+    self->spillHandlerParameter = NULL;
+    self->coalescingIndex = NULL;
+    self->packer = NULL;
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    self->queueLock = Semaphore_create(1);
+#endif
+
+    return self;
+}
+
+#else
+
+static void
+saveState(MessageQueue self)
+{
+}
+
+#endif /* (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1) */
+
+void
+MessageQueue_destroy(MessageQueue self)
+{
+    if (self != NULL) {
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+        if (self->file != NULL)
+            MappedFile_close(self->file);
+#endif
+
+#if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE != 1)
+        GLOBAL_FREEMEM(self->buffer);
+#endif
+
+        CoalescingIndex_destroy(self->coalescingIndex);
+        AsduPacker_destroy(self->packer);
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+        Semaphore_destroy(self->queueLock);
+#endif
+
+        GLOBAL_FREEMEM(self);
+    }
+}
+
+void
+MessageQueue_lock(MessageQueue self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->queueLock);
+#endif
+}
+
+void
+MessageQueue_unlock(MessageQueue self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->queueLock);
+#endif
+}
+
+int
+MessageQueue_getSize(MessageQueue self)
+{
+    return self->size;
+}
+
+void
+MessageQueue_setOverflowPolicy(MessageQueue self, QueueOverflowPolicy policy, QueueSpillHandler spillHandler,
+        void* spillHandlerParameter)
+{
+    MessageQueue_lock(self);
+
+    self->overflowPolicy = policy;
+    self->spillHandler = spillHandler;
+    self->spillHandlerParameter = spillHandlerParameter;
+
+    MessageQueue_unlock(self);
+}
+
+void
+MessageQueue_enableCoalescing(MessageQueue self, ConnectionParameters parameters)
+{
+    MessageQueue_lock(self);
+
+    if (self->coalescingIndex == NULL)
+        self->coalescingIndex = CoalescingIndex_create(parameters, CONFIG_SLAVE_COALESCING_INDEX_SIZE);
+
+    MessageQueue_unlock(self);
+}
+
+void
+MessageQueue_enablePacking(MessageQueue self, ConnectionParameters parameters, int maxDelayInMs)
+{
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+    /* the size of a stored entry cannot be changed safely */
+    if (self->file != NULL)
+        return;
+#endif
+
+    MessageQueue_lock(self);
+
+    if (self->packer == NULL)
+        self->packer = AsduPacker_create(parameters, maxDelayInMs);
+
+    MessageQueue_unlock(self);
+}
+
+int
+MessageQueue_getFillLevelLocked(MessageQueue self)
+{
+    return (int) (((int64_t) MessageRing_getUsedSpace(&(self->ring)) * 100) / self->ring.size);
+}
+
+int
+MessageQueue_getFillLevel(MessageQueue self)
+{
+    MessageQueue_lock(self);
+
+    int fillLevel = MessageQueue_getFillLevelLocked(self);
+
+    MessageQueue_unlock(self);
+
+    return fillLevel;
+}
+
+int
+MessageQueue_getNumberOfEntries(MessageQueue self)
+{
+    MessageQueue_lock(self);
+
+    int entries = MessageRing_getNumberOfMessages(&(self->ring));
+
+    MessageQueue_unlock(self);
+
+    return entries;
+}
+
+/*
+ * Reserve an entry. When the queue is full the overflow policy decides if the oldest
+ * entries are removed (entriesRemoved is set) or no entry is reserved.
+ * Has to be called with the queue lock held.
+ */
+static uint8_t*
+reserveEntry(MessageQueue self, int asduSize, bool* entriesRemoved)
+{
+    uint8_t* entry;
+
+    while ((entry = MessageRing_reserve(&(self->ring), asduSize)) == NULL) {
+
+        /* only reserved entries are left -> they cannot be removed */
+        if (MessageRing_isEmpty(&(self->ring)))
+            break;
+
+        if ((self->overflowPolicy == QUEUE_OVERFLOW_DROP_NEWEST) || (self->overflowPolicy == QUEUE_OVERFLOW_BLOCK))
+            break;
+
+        DEBUG_PRINT("queue full -> remove oldest entry\n");
+
+        if ((self->overflowPolicy == QUEUE_OVERFLOW_SPILL) && (self->spillHandler != NULL)) {
+            MessageRingCursor oldest;
+
+            MessageRing_getOldest(&(self->ring), &oldest);
+
+            int oldestSize;
+            uint8_t* oldestEntry = MessageRing_read(&(self->ring), &oldest, &oldestSize);
+
+            self->spillHandler(self->spillHandlerParameter, oldestEntry, oldestSize);
+        }
+
+        MessageRing_removeOldest(&(self->ring));
+
+        if (entriesRemoved != NULL)
+            *entriesRemoved = true;
+
+        if (MessageRing_isRemoved(&(self->ring), &(self->sendCursor)))
+            MessageRing_getOldest(&(self->ring), &(self->sendCursor));
+    }
+
+    return entry;
+}
+
+EnqueueResult
+MessageQueue_enqueueASDU(MessageQueue self, ASDU asdu)
+{
+    uint8_t buffer[MESSAGE_QUEUE_ENTRY_SIZE];
+
+    struct sBufferFrame bufferFrame;
+
+    Frame frame = BufferFrame_initialize(&bufferFrame, buffer, 0);
+
+    ASDU_encode(asdu, frame);
+
+    int asduSize = Frame_getMsgSize(frame);
+
+    MessageQueue_lock(self);
+
+    EnqueueResult result = MessageQueue_enqueueEncodedASDU(self, buffer, asduSize);
+
+    DEBUG_PRINT("ASDUs in FIFO: %i\n", MessageRing_getNumberOfMessages(&(self->ring)));
+
+    MessageQueue_unlock(self);
+
+    return result;
+}
+
+EnqueueResult
+MessageQueue_enqueueEncodedASDU(MessageQueue self, const uint8_t* asdu, int asduSize)
+{
+    if (self->coalescingIndex != NULL) {
+        uint8_t* waitingEntry = CoalescingIndex_lookup(self->coalescingIndex, &(self->ring),
+                self->sendCursor.seqNo, asdu, asduSize);
+
+        /* replace the value that is not yet sent */
+        if (waitingEntry != NULL) {
+            memcpy(waitingEntry, asdu, asduSize);
+            return ENQUEUE_OK;
+        }
+    }
+
+    /* append the information objects to the newest entry that is not yet sent */
+    if (self->packer != NULL) {
+        if (AsduPacker_pack(self->packer, &(self->ring), self->sendCursor.seqNo, asdu, asduSize))
+            return ENQUEUE_OK;
+    }
+
+    bool entriesRemoved = false;
+
+    uint8_t* entry = reserveEntry(self, asduSize, &entriesRemoved);
+
+    if (entry == NULL) {
+        DEBUG_PRINT("queue full -> ASDU dropped\n");
+        return ENQUEUE_DROPPED;
+    }
+
+    uint64_t seqNo = self->ring.nextSeqNo - 1;
+
+    memcpy(entry, asdu, asduSize);
+
+    MessageRing_commit(&(self->ring), entry);
+
+    if (self->coalescingIndex != NULL)
+        CoalescingIndex_add(self->coalescingIndex, entry, asduSize, seqNo);
+
+    if (self->packer != NULL)
+        AsduPacker_entryAdded(self->packer, seqNo);
+
+    saveState(self);
+
+    return entriesRemoved ? ENQUEUE_OLDEST_DROPPED : ENQUEUE_OK;
+}
+
+uint8_t*
+MessageQueue_reserveASDU(MessageQueue self, int asduSize)
+{
+    MessageQueue_lock(self);
+
+    uint8_t* entry = reserveEntry(self, asduSize, NULL);
+
+    MessageQueue_unlock(self);
+
+    return entry;
+}
+
+void
+MessageQueue_commitASDU(MessageQueue self, uint8_t* entry)
+{
+    MessageQueue_lock(self);
+
+    MessageRing_commit(&(self->ring), entry);
+
+    saveState(self);
+
+    MessageQueue_unlock(self);
+}
+
+#define MAX_BATCH_SIZE 32
+
+int
+MessageQueue_enqueueASDUs(MessageQueue self, ASDU* asdus, int numberOfAsdus)
+{
+    int enqueued = 0;
+
+    while (enqueued < numberOfAsdus) {
+        uint8_t* entries[MAX_BATCH_SIZE];
+
+        int batchSize = numberOfAsdus - enqueued;
+
+        if (batchSize > MAX_BATCH_SIZE)
+            batchSize = MAX_BATCH_SIZE;
+
+        int reserved;
+
+        MessageQueue_lock(self);
+
+        for (reserved = 0; reserved < batchSize; reserved++) {
+            entries[reserved] = reserveEntry(self, ASDU_getEncodedSize(asdus[enqueued + reserved]), NULL);
+
+            if (entries[reserved] == NULL)
+                break;
+        }
+
+        MessageQueue_unlock(self);
+
+        /* encode without holding the queue lock */
+        int i;
+
+        for (i = 0; i < reserved; i++) {
+            struct sBufferFrame bufferFrame;
+
+            Frame frame = BufferFrame_initialize(&bufferFrame, entries[i], 0);
+
+            ASDU_encode(asdus[enqueued + i], frame);
+        }
+
+        MessageQueue_lock(self);
+
+        for (i = 0; i < reserved; i++)
+            MessageRing_commit(&(self->ring), entries[i]);
+
+        saveState(self);
+
+        MessageQueue_unlock(self);
+
+        enqueued += reserved;
+
+        if (reserved < batchSize) {
+            DEBUG_PRINT("queue full -> %i ASDUs dropped\n", numberOfAsdus - enqueued);
+            break;
+        }
+    }
+
+    return enqueued;
+}
+
+int
+MessageQueue_getSendDelay(MessageQueue self)
+{
+    if ((self->packer == NULL) || MessageRing_isAtEnd(&(self->ring), &(self->sendCursor)))
+        return 0;
+
+    return AsduPacker_getSendDelay(self->packer, &(self->ring), self->sendCursor.seqNo);
+}
+
+uint8_t*
+MessageQueue_getNextWaitingASDU(MessageQueue self, uint64_t* seqNo, int* asduSize)
+{
+    if (MessageRing_isAtEnd(&(self->ring), &(self->sendCursor)))
+        return NULL;
+
+    /* the entry is held back to pack more events */
+    if (MessageQueue_getSendDelay(self) > 0)
+        return NULL;
+
+    *seqNo = self->sendCursor.seqNo;
+
+    return MessageRing_read(&(self->ring), &(self->sendCursor), asduSize);
+}
+
+bool
+MessageQueue_isAsduWaiting(MessageQueue self)
+{
+    if (MessageRing_isAtEnd(&(self->ring), &(self->sendCursor)))
+        return false;
+
+    return (MessageQueue_getSendDelay(self) == 0);
+}
+
+void
+MessageQueue_markAsduAsConfirmed(MessageQueue self, uint64_t seqNo)
+{
+    MessageQueue_lock(self);
+
+    /* ignore entries that are already removed or not yet sent */
+    if (seqNo < self->sendCursor.seqNo) {
+        DEBUG_PRINT("Remove entries from queue until %llu\n", (unsigned long long) seqNo);
+
+        MessageRing_removeUntil(&(self->ring), seqNo);
+
+        saveState(self);
+    }
+
+    MessageQueue_unlock(self);
+}
+
+void
+MessageQueue_releaseAllQueuedASDUs(MessageQueue self)
+{
+    MessageQueue_lock(self);
+
+    MessageRing_clear(&(self->ring));
+    MessageRing_getEnd(&(self->ring), &(self->sendCursor));
+
+    saveState(self);
+
+    MessageQueue_unlock(self);
+}
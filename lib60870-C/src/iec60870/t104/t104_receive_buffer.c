@@ -0,0 +1,87 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include <string.h>
+
+#include "t104_receive_buffer.h"
+#include "lib60870_internal.h"
+
+void
+T104ReceiveBuffer_initialize(T104ReceiveBuffer self)
+{
+    self->readPos = 0;
+    self->writePos = 0;
+}
+
+int
+T104ReceiveBuffer_fill(T104ReceiveBuffer self, Socket socket)
+{
+    /* move start of incomplete message to the beginning of the buffer */
+    if (self->readPos > 0) {
+        int remaining = self->writePos - self->readPos;
+
+        if (remaining > 0)
+            memmove(self->buffer, self->buffer + self->readPos, remaining);
+
+        self->writePos = remaining;
+        self->readPos = 0;
+    }
+
+    int spaceLeft = CONFIG_T104_RECEIVE_BUFFER_SIZE - self->writePos;
+
+    if (spaceLeft == 0)
+        return 0;
+
+    int readBytes = Socket_read(socket, self->buffer + self->writePos, spaceLeft);
+
+    if (readBytes > 0)
+        self->writePos += readBytes;
+
+    return readBytes;
+}
+
+int
+T104ReceiveBuffer_getNextMessage(T104ReceiveBuffer self, uint8_t** msg)
+{
+    int available = self->writePos - self->readPos;
+
+    if (available < 2)
+        return 0;
+
+    uint8_t* start = self->buffer + self->readPos;
+
+    if (start[0] != 0x68)
+        return -1; /* message error */
+
+    int length = start[1];
+
+    if (length < 4)
+        return -1; /* message error - APCI is incomplete */
+
+    if (available < (length + 2))
+        return 0;
+
+    self->readPos += (length + 2);
+
+    *msg = start;
+
+    return length + 2;
+}
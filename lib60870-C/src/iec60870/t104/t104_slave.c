@@ -32,7 +32,13 @@
 #include "hal_time.h"
 #include "lib_memory.h"
 #include "linked_list.h"
+#include "timer_wheel.h"
+#include "message_ring.h"
 #include "buffer_frame.h"
+#include "t104_receive_buffer.h"
+#include "t104_message_queue.h"
+#include "t104_coalescing_index.h"
+#include "t104_asdu_packer.h"
 
 #include "lib60870_config.h"
 #include "lib60870_internal.h"
@@ -45,6 +51,33 @@
 
 #define T104_DEFAULT_PORT 2404
 
+#ifndef CONFIG_SLAVE_SEND_BUFFER_SIZE
+#define CONFIG_SLAVE_SEND_BUFFER_SIZE 4096
+#endif
+
+#ifndef CONFIG_SLAVE_MAX_ASDUS_PER_PASS
+#define CONFIG_SLAVE_MAX_ASDUS_PER_PASS 0
+#endif
+
+#ifndef CONFIG_SLAVE_INGEST_QUEUE_SIZE
+#define CONFIG_SLAVE_INGEST_QUEUE_SIZE 0
+#endif
+
+#if (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0)
+#include "ingest_queue.h"
+#include "hal_atomic.h"
+
+/* without atomic operations the ASDUs are added to the event queue with the queue lock held */
+#if (HAL_ATOMIC_AVAILABLE != 1)
+#undef CONFIG_SLAVE_INGEST_QUEUE_SIZE
+#define CONFIG_SLAVE_INGEST_QUEUE_SIZE 0
+#endif
+#endif
+
+#ifndef CONFIG_SLAVE_COALESCING_INDEX_SIZE
+#define CONFIG_SLAVE_COALESCING_INDEX_SIZE 1024
+#endif
+
 //TODO refactor: move to separate file/class
 static struct sT104ConnectionParameters defaultConnectionParameters = {
 	/* .sizeOfTypeId =  */ 1,
@@ -63,40 +96,17 @@ static struct sT104ConnectionParameters defaultConnectionParameters = {
 };
 
 
-typedef struct {
-    uint8_t msg[256];
-    int msgSize;
-} FrameBuffer;
-
-typedef enum  {
-    QUEUE_ENTRY_STATE_NOT_USED,
-    QUEUE_ENTRY_STATE_WAITING_FOR_TRANSMISSION,
-    QUEUE_ENTRY_STATE_SENT_BUT_NOT_CONFIRMED
-} QueueEntryState;
-
-struct sASDUQueueEntry {
-    uint64_t entryTimestamp;
-    FrameBuffer asdu;
-    QueueEntryState state;
-};
-
-typedef struct sASDUQueueEntry* ASDUQueueEntry;
-
-
 /***************************************************
- * MessageQueue
+ * HighPriorityASDUQueue
  ***************************************************/
 
-struct sMessageQueue {
-    int size;
-    int entryCounter;
-    int lastMsgIndex;
-    int firstMsgIndex;
+struct sHighPriorityASDUQueue {
+    struct sMessageRing ring; /* encoded ASDUs (without APCI) */
 
 #if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE == 1)
-    struct sASDUQueueEntry asdus [CONFIG_SLAVE_ASDU_QUEUE_SIZE];
+    uint8_t buffer[CONFIG_SLAVE_CONNECTION_ASDU_QUEUE_SIZE * MESSAGE_QUEUE_ENTRY_SIZE];
 #else
-    ASDUQueueEntry asdus;
+    uint8_t* buffer;
 #endif
 
 #if (CONFIG_SLAVE_USING_THREADS == 1)
@@ -104,55 +114,53 @@ struct sMessageQueue {
 #endif
 };
 
-typedef struct sMessageQueue* MessageQueue;
+typedef struct sHighPriorityASDUQueue* HighPriorityASDUQueue;
+
 
 static void
-MessageQueue_initialize(MessageQueue self, int maxQueueSize)
+HighPriorityASDUQueue_initialize(HighPriorityASDUQueue self, int maxQueueSize)
 {
 #if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE == 1)
+    maxQueueSize = CONFIG_SLAVE_CONNECTION_ASDU_QUEUE_SIZE;
 #else
-    self->asdus = (ASDUQueueEntry) GLOBAL_CALLOC(maxQueueSize, sizeof(struct sASDUQueueEntry));
+    self->buffer = (uint8_t*) GLOBAL_MALLOC(maxQueueSize * MESSAGE_QUEUE_ENTRY_SIZE);
 #endif
 
-    self->entryCounter = 0;
-    self->firstMsgIndex = 0;
-    self->lastMsgIndex = 0;
-    self->size = maxQueueSize;
+    MessageRing_initialize(&(self->ring), self->buffer, maxQueueSize * MESSAGE_QUEUE_ENTRY_SIZE);
 
 #if (CONFIG_SLAVE_USING_THREADS == 1)
     self->queueLock = Semaphore_create(1);
 #endif
 }
 
-static MessageQueue
-MessageQueue_create(int maxQueueSize)
+static HighPriorityASDUQueue
+HighPriorityASDUQueue_create(int maxQueueSize)
 {
-    MessageQueue self = (MessageQueue) GLOBAL_MALLOC(sizeof(struct sMessageQueue));
+    HighPriorityASDUQueue self = (HighPriorityASDUQueue) GLOBAL_MALLOC(sizeof(struct sHighPriorityASDUQueue));
 
     if (self != NULL)
-        MessageQueue_initialize(self, maxQueueSize);
+        HighPriorityASDUQueue_initialize(self, maxQueueSize);
 
     return self;
 }
 
 static void
-MessageQueue_destroy(MessageQueue self)
+HighPriorityASDUQueue_destroy(HighPriorityASDUQueue self)
 {
-    if (self != NULL) {
-#if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE != 1)
-        GLOBAL_FREEMEM(self->asdus);
+#if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE == 1)
+#else
+    GLOBAL_FREEMEM(self->buffer);
 #endif
 
 #if (CONFIG_SLAVE_USING_THREADS == 1)
-        Semaphore_destroy(self->queueLock);
+    Semaphore_destroy(self->queueLock);
 #endif
 
-        GLOBAL_FREEMEM(self);
-    }
+    GLOBAL_FREEMEM(self);
 }
 
 static void
-MessageQueue_lock(MessageQueue self)
+HighPriorityASDUQueue_lock(HighPriorityASDUQueue self)
 {
 #if (CONFIG_SLAVE_USING_THREADS == 1)
     Semaphore_wait(self->queueLock);
@@ -160,91 +168,21 @@ MessageQueue_lock(MessageQueue self)
 }
 
 static void
-MessageQueue_unlock(MessageQueue self)
-{
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_post(self->queueLock);
-#endif
-}
-
-
-/**
- * Add an ASDU to the queue. When queue is full, override oldest entry.
- */
-static void
-MessageQueue_enqueueASDU(MessageQueue self, ASDU asdu)
+HighPriorityASDUQueue_unlock(HighPriorityASDUQueue self)
 {
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_wait(self->queueLock);
-#endif
-
-    int nextIndex;
-    bool removeEntry = false;
-
-    if (self->entryCounter == 0) {
-        self->firstMsgIndex = 0;
-        nextIndex = 0;
-    }
-    else
-        nextIndex = self->lastMsgIndex + 1;
-
-    if (nextIndex == self->size)
-        nextIndex = 0;
-
-    if (self->entryCounter == self->size)
-        removeEntry = true;
-
-    if (removeEntry == false) {
-        DEBUG_PRINT("add entry (nextIndex:%i)\n", nextIndex);
-        self->lastMsgIndex = nextIndex;
-        self->entryCounter++;
-    }
-    else {
-        DEBUG_PRINT("add entry (nextIndex:%i) -> remove oldest\n", nextIndex);
-
-        /* remove oldest entry */
-        self->lastMsgIndex = nextIndex;
-
-        int firstIndex = nextIndex + 1;
-
-        if (firstIndex == self->size)
-            firstIndex = 0;
-
-        self->firstMsgIndex = firstIndex;
-    }
-
-    struct sBufferFrame bufferFrame;
-
-    Frame frame = BufferFrame_initialize(&bufferFrame, self->asdus[nextIndex].asdu.msg,
-                                            IEC60870_5_104_APCI_LENGTH);
-
-    ASDU_encode(asdu, frame);
-
-    self->asdus[nextIndex].asdu.msgSize = Frame_getMsgSize(frame);
-    self->asdus[nextIndex].entryTimestamp = Hal_getTimeInMs();
-    self->asdus[nextIndex].state = QUEUE_ENTRY_STATE_WAITING_FOR_TRANSMISSION;
-
-    DEBUG_PRINT("ASDUs in FIFO: %i (first: %i, last: %i)\n", self->entryCounter,
-            self->firstMsgIndex, self->lastMsgIndex);
-
 #if (CONFIG_SLAVE_USING_THREADS == 1)
     Semaphore_post(self->queueLock);
 #endif
 }
 
 static bool
-MessageQueue_isAsduAvailable(MessageQueue self)
+HighPriorityASDUQueue_isAsduAvailable(HighPriorityASDUQueue self)
 {
 #if (CONFIG_SLAVE_USING_THREADS == 1)
     Semaphore_wait(self->queueLock);
 #endif
 
-    bool retVal;
-
-    if (self->entryCounter > 0)
-        retVal = true;
-    else
-        retVal = false;
+    bool retVal = (MessageRing_isEmpty(&(self->ring)) == false);
 
 #if (CONFIG_SLAVE_USING_THREADS == 1)
     Semaphore_post(self->queueLock);
@@ -253,342 +191,490 @@ MessageQueue_isAsduAvailable(MessageQueue self)
     return retVal;
 }
 
-
-static FrameBuffer*
-MessageQueue_getNextWaitingASDU(MessageQueue self, uint64_t* timestamp, int* index)
+/**
+ * Remove the oldest ASDU from the queue. The returned ASDU is valid until the
+ * queue lock is released.
+ */
+static uint8_t*
+HighPriorityASDUQueue_getNextASDU(HighPriorityASDUQueue self, int* asduSize)
 {
-    FrameBuffer* buffer = NULL;
+    uint8_t* asdu = NULL;
 
-    if (self->entryCounter != 0) {
-        int currentIndex = self->firstMsgIndex;
+    if (MessageRing_isEmpty(&(self->ring)) == false)  {
+        MessageRingCursor cursor;
 
-        while (self->asdus[currentIndex].state != QUEUE_ENTRY_STATE_WAITING_FOR_TRANSMISSION) {
+        MessageRing_getOldest(&(self->ring), &cursor);
 
-            if (self->asdus[currentIndex].state == QUEUE_ENTRY_STATE_NOT_USED)
-                break;
+        asdu = MessageRing_read(&(self->ring), &cursor, asduSize);
 
-            currentIndex = (currentIndex + 1) % self->size;
+        MessageRing_removeOldest(&(self->ring));
+    }
 
-            /* break when we reached the oldest entry again */
-            if (currentIndex == self->firstMsgIndex)
-                break;
-        }
+    return asdu;
+}
 
-        if (self->asdus[currentIndex].state == QUEUE_ENTRY_STATE_WAITING_FOR_TRANSMISSION) {
+//static bool
+//Slave_enqueueHighPrioASDU(Slave self, ASDU asdu)
+static bool
+HighPriorityASDUQueue_enqueue(HighPriorityASDUQueue self, ASDU asdu)
+{
+    uint8_t buffer[MESSAGE_QUEUE_ENTRY_SIZE];
 
-            self->asdus[currentIndex].state = QUEUE_ENTRY_STATE_SENT_BUT_NOT_CONFIRMED;
-            *timestamp = self->asdus[currentIndex].entryTimestamp;
-            *index = currentIndex;
+    struct sBufferFrame bufferFrame;
 
-            buffer = &(self->asdus[currentIndex].asdu);
-        }
-    }
+    Frame frame = BufferFrame_initialize(&bufferFrame, buffer, 0);
 
-    return buffer;
-}
+    ASDU_encode(asdu, frame);
 
-#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
-static void
-MessageQueue_releaseAllQueuedASDUs(MessageQueue self)
-{
 #if (CONFIG_SLAVE_USING_THREADS == 1)
     Semaphore_wait(self->queueLock);
 #endif
 
-    self->firstMsgIndex = 0;
-    self->lastMsgIndex = 0;
-    self->entryCounter = 0;
+    bool enqueued = MessageRing_add(&(self->ring), buffer, Frame_getMsgSize(frame));
+
+    DEBUG_PRINT("ASDUs in HighPrio FIFO: %i\n", MessageRing_getNumberOfMessages(&(self->ring)));
 
 #if (CONFIG_SLAVE_USING_THREADS == 1)
     Semaphore_post(self->queueLock);
 #endif
+
+    return enqueued;
 }
-#endif /* (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1) */
 
+//static void
+//Slave_resetConnectionQueue(Slave self)
 static void
-MessageQueue_markAsduAsConfirmed(MessageQueue self, int index, uint64_t timestamp)
+HighPriorityASDUQueue_resetConnectionQueue(HighPriorityASDUQueue self)
 {
-    if ((index < 0) || (index > self->size))
-        return;
-
 #if (CONFIG_SLAVE_USING_THREADS == 1)
     Semaphore_wait(self->queueLock);
 #endif
 
-    if (self->entryCounter > 0) {
-        if (self->asdus[index].state == QUEUE_ENTRY_STATE_SENT_BUT_NOT_CONFIRMED) {
-
-            if (self->asdus[index].entryTimestamp == timestamp) {
-                int currentIndex = index;
-
-                while (self->asdus[currentIndex].state == QUEUE_ENTRY_STATE_SENT_BUT_NOT_CONFIRMED) {
+    MessageRing_clear(&(self->ring));
 
-                    DEBUG_PRINT("Remove from queue with index %i\n", currentIndex);
-
-                    self->asdus[currentIndex].state = QUEUE_ENTRY_STATE_NOT_USED;
-                    self->asdus[currentIndex].entryTimestamp = 0;
-
-                    self->entryCounter--;
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->queueLock);
+#endif
+}
 
-                    if (self->entryCounter == 0) {
-                        self->firstMsgIndex = -1;
-                        self->lastMsgIndex = -1;
-                        break;
-                    }
 
-                    if (currentIndex == self->firstMsgIndex) {
-                        self->firstMsgIndex = (index + 1) % self->size;
 
-                        if (self->entryCounter == 1)
-                            self->lastMsgIndex = self->firstMsgIndex;
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
 
-                        break;
-                    }
+/***************************************************
+ * EventLog
+ *
+ * Queue of encoded events shared by all connections in
+ * CONNECTION_IS_REDUNDANCY_GROUP mode. Every event is encoded once
+ * and identified by its sequence number. The connections only keep
+ * a cursor to the next event to send and the sequence number of the
+ * oldest unconfirmed event. The events are removed when they are
+ * confirmed by all open connections (readers), also by the connections
+ * that have not started the data transfer. When the log is full the
+ * oldest events are overwritten.
+ ***************************************************/
 
-                    currentIndex--;
+struct sEventLog {
+    struct sMessageRing ring; /* encoded events (without APCI) that are not confirmed by all connections */
 
-                    if (currentIndex < 0)
-                        currentIndex = self->size - 1;
+    uint8_t* buffer;
 
-                    /* break if we reached the first deleted entry again */
-                    if (currentIndex == index)
-                        break;
+    QueueOverflowPolicy overflowPolicy;
+    QueueSpillHandler spillHandler;
+    void* spillHandlerParameter;
 
-                    DEBUG_PRINT("queue state: noASDUs: %i oldest: %i latest: %i\n", self->entryCounter,
-                            self->firstMsgIndex, self->lastMsgIndex);
+    CoalescingIndex coalescingIndex; /* NULL when the coalescing is not enabled */
+    AsduPacker packer; /* NULL when the packing is not enabled */
+    uint64_t sentSeqNo; /* sequence number of the first event that no connection has sent */
 
-                }
-            }
-        }
-    }
+    LinkedList readers; /* acknowledge cursors (uint64_t*) of the open connections */
+    uint64_t minAckCursor; /* oldest unconfirmed event of the readers */
 
 #if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_post(self->queueLock);
+    Semaphore logLock;
 #endif
-}
+};
 
-/***************************************************
- * HighPriorityASDUQueue
- ***************************************************/
+typedef struct sEventLog* EventLog;
 
-struct sHighPriorityASDUQueue {
-    int size;
-    int entryCounter;
-    int lastMsgIndex;
-    int firstMsgIndex;
+static bool
+EventLog_initialize(EventLog self, int maxLogSize)
+{
+    if (maxLogSize < 1)
+        maxLogSize = CONFIG_SLAVE_ASDU_QUEUE_SIZE;
 
-#if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE == 1)
-    FrameBuffer asdus[CONFIG_SLAVE_CONNECTION_ASDU_QUEUE_SIZE];
-#else
-    FrameBuffer* asdus;
-#endif
+    self->buffer = (uint8_t*) GLOBAL_MALLOC(maxLogSize * MESSAGE_QUEUE_ENTRY_SIZE);
 
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore queueLock;
-#endif
-};
+    if (self->buffer == NULL)
+        return false;
 
-typedef struct sHighPriorityASDUQueue* HighPriorityASDUQueue;
+    MessageRing_initialize(&(self->ring), self->buffer, maxLogSize * MESSAGE_QUEUE_ENTRY_SIZE);
 
+    self->overflowPolicy = QUEUE_OVERFLOW_DROP_OLDEST;
+    self->spillHandler = NULL;
+    self->spillHandlerParameter = NULL;
 
-static void
-HighPriorityASDUQueue_initialize(HighPriorityASDUQueue self, int maxQueueSize)
-{
-#if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE == 1)
-#else
-    self->asdus = (FrameBuffer*) GLOBAL_CALLOC(maxQueueSize, sizeof(FrameBuffer));
-#endif
+    self->coalescingIndex = NULL;
+    self->packer = NULL;
+    self->sentSeqNo = 0;
 
-    self->entryCounter = 0;
-    self->firstMsgIndex = 0;
-    self->lastMsgIndex = 0;
-    self->size = maxQueueSize;
+    self->readers = LinkedList_create();
+    self->minAckCursor = 0;
 
 #if (CONFIG_SLAVE_USING_THREADS == 1)
-    self->queueLock = Semaphore_create(1);
+    self->logLock = Semaphore_create(1);
 #endif
+
+    return true;
 }
 
-static HighPriorityASDUQueue
-HighPriorityASDUQueue_create(int maxQueueSize)
+static void
+EventLog_finalize(EventLog self)
 {
-    HighPriorityASDUQueue self = (HighPriorityASDUQueue) GLOBAL_MALLOC(sizeof(struct sHighPriorityASDUQueue));
+    if (self->buffer != NULL) {
+        GLOBAL_FREEMEM(self->buffer);
+        self->buffer = NULL;
 
-    if (self != NULL)
-        HighPriorityASDUQueue_initialize(self, maxQueueSize);
+        CoalescingIndex_destroy(self->coalescingIndex);
+        self->coalescingIndex = NULL;
 
-    return self;
-}
+        AsduPacker_destroy(self->packer);
+        self->packer = NULL;
 
-static void
-HighPriorityASDUQueue_destroy(HighPriorityASDUQueue self)
-{
-#if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE == 1)
-#else
-    GLOBAL_FREEMEM(self->asdus);
-#endif
+        LinkedList_destroyStatic(self->readers);
 
 #if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_destroy(self->queueLock);
+        Semaphore_destroy(self->logLock);
 #endif
-
-    GLOBAL_FREEMEM(self);
+    }
 }
 
 static void
-HighPriorityASDUQueue_lock(HighPriorityASDUQueue self)
+EventLog_lock(EventLog self)
 {
 #if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_wait(self->queueLock);
+    Semaphore_wait(self->logLock);
 #endif
 }
 
 static void
-HighPriorityASDUQueue_unlock(HighPriorityASDUQueue self)
+EventLog_unlock(EventLog self)
 {
 #if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_post(self->queueLock);
+    Semaphore_post(self->logLock);
 #endif
 }
 
-static bool
-HighPriorityASDUQueue_isAsduAvailable(HighPriorityASDUQueue self)
+/**
+ * Reserve space for an event. When the log is full, the overflow policy decides if the
+ * oldest events are removed (eventsRemoved is set) or no space is reserved.
+ *
+ * Has to be called with the log lock held.
+ */
+static uint8_t*
+EventLog_reserve(EventLog self, int eventSize, bool* eventsRemoved)
 {
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_wait(self->queueLock);
-#endif
+    uint8_t* event;
 
-    bool retVal;
+    while ((event = MessageRing_reserve(&(self->ring), eventSize)) == NULL) {
 
-    if (self->entryCounter > 0)
-        retVal = true;
-    else
-        retVal = false;
+        /* only reserved events are left -> they cannot be removed */
+        if (MessageRing_isEmpty(&(self->ring)))
+            break;
 
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_post(self->queueLock);
-#endif
+        if ((self->overflowPolicy == QUEUE_OVERFLOW_DROP_NEWEST) || (self->overflowPolicy == QUEUE_OVERFLOW_BLOCK))
+            break;
 
-    return retVal;
-}
+        if ((self->overflowPolicy == QUEUE_OVERFLOW_SPILL) && (self->spillHandler != NULL)) {
+            MessageRingCursor oldest;
 
-static FrameBuffer*
-HighPriorityASDUQueue_getNextASDU(HighPriorityASDUQueue self)
-{
-    FrameBuffer* buffer = NULL;
+            MessageRing_getOldest(&(self->ring), &oldest);
 
-    if (self->entryCounter != 0)  {
-        int currentIndex = self->firstMsgIndex;
+            int oldestSize;
+            uint8_t* oldestEvent = MessageRing_read(&(self->ring), &oldest, &oldestSize);
 
-        if (self->entryCounter == 1) {
-            self->entryCounter = 0;
-            self->firstMsgIndex = -1;
-            self->lastMsgIndex = -1;
+            self->spillHandler(self->spillHandlerParameter, oldestEvent, oldestSize);
         }
-        else {
-            self->firstMsgIndex = (self->firstMsgIndex + 1) % (self->size);
 
-            self->entryCounter--;
-        }
+        MessageRing_removeOldest(&(self->ring));
 
-        buffer = &(self->asdus[currentIndex]);
+        if (eventsRemoved != NULL)
+            *eventsRemoved = true;
     }
 
-    return buffer;
+    return event;
 }
 
-//static bool
-//Slave_enqueueHighPrioASDU(Slave self, ASDU asdu)
-static bool
-HighPriorityASDUQueue_enqueue(HighPriorityASDUQueue self, ASDU asdu)
+/**
+ * Add an encoded event to the log. When the log is full, apply the overflow policy.
+ *
+ * Has to be called with the log lock held.
+ */
+static EnqueueResult
+EventLog_addEncoded(EventLog self, const uint8_t* encodedEvent, int eventSize)
 {
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_wait(self->queueLock);
-#endif
+    if (self->coalescingIndex != NULL) {
+        uint8_t* waitingEvent = CoalescingIndex_lookup(self->coalescingIndex, &(self->ring),
+                self->sentSeqNo, encodedEvent, eventSize);
 
-    bool enqueued = false;
+        /* replace the value that is not yet sent by any connection */
+        if (waitingEvent != NULL) {
+            memcpy(waitingEvent, encodedEvent, eventSize);
+            return ENQUEUE_OK;
+        }
+    }
 
-    if (self->entryCounter == self->size)
-        goto exit_function;
+    /* append the information objects to the newest event that is not yet sent by any connection */
+    if (self->packer != NULL) {
+        if (AsduPacker_pack(self->packer, &(self->ring), self->sentSeqNo, encodedEvent, eventSize))
+            return ENQUEUE_OK;
+    }
 
-    int nextIndex;
+    bool eventsRemoved = false;
 
-    if (self->entryCounter == 0) {
-        self->firstMsgIndex = 0;
-        nextIndex = 0;
-    }
-    else
-        nextIndex = self->lastMsgIndex + 1;
+    uint8_t* event = EventLog_reserve(self, eventSize, &eventsRemoved);
 
-    if (nextIndex == self->size)
-        nextIndex = 0;
+    if (event == NULL)
+        return ENQUEUE_DROPPED;
 
-    DEBUG_PRINT("HighPrio AsduQueue: add entry (nextIndex:%i)\n", nextIndex);
-    self->lastMsgIndex = nextIndex;
-    self->entryCounter++;
+    uint64_t seqNo = self->ring.nextSeqNo - 1;
+
+    memcpy(event, encodedEvent, eventSize);
+    MessageRing_commit(&(self->ring), event);
+
+    if (self->coalescingIndex != NULL)
+        CoalescingIndex_add(self->coalescingIndex, event, eventSize, seqNo);
+
+    if (self->packer != NULL)
+        AsduPacker_entryAdded(self->packer, seqNo);
+
+    return eventsRemoved ? ENQUEUE_OLDEST_DROPPED : ENQUEUE_OK;
+}
+
+/**
+ * Encode the ASDU and add it to the log. When the log is full, apply the overflow policy.
+ */
+static EnqueueResult
+EventLog_add(EventLog self, ASDU asdu)
+{
+    uint8_t buffer[MESSAGE_QUEUE_ENTRY_SIZE];
 
     struct sBufferFrame bufferFrame;
 
-    Frame frame = BufferFrame_initialize(&bufferFrame, self->asdus[nextIndex].msg,
-                                            IEC60870_5_104_APCI_LENGTH);
+    Frame frame = BufferFrame_initialize(&bufferFrame, buffer, 0);
 
     ASDU_encode(asdu, frame);
 
-    self->asdus[nextIndex].msgSize = Frame_getMsgSize(frame);
-
-    DEBUG_PRINT("ASDUs in HighPrio FIFO: %i (first: %i, last: %i)\n", self->entryCounter,
-            self->firstMsgIndex, self->lastMsgIndex);
+    int eventSize = Frame_getMsgSize(frame);
 
-    enqueued = true;
+    EventLog_lock(self);
 
-exit_function:
+    EnqueueResult result = EventLog_addEncoded(self, buffer, eventSize);
 
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_post(self->queueLock);
-#endif
+    EventLog_unlock(self);
 
-    return enqueued;
+    return result;
 }
 
-//static void
-//Slave_resetConnectionQueue(Slave self)
-static void
-HighPriorityASDUQueue_resetConnectionQueue(HighPriorityASDUQueue self)
+#define MAX_EVENT_BATCH_SIZE 32
+
+/**
+ * Encode the ASDUs and add them to the log. The events are reserved and committed with a
+ * single acquisition of the log lock each and encoded without holding the lock.
+ *
+ * Returns the number of added events.
+ */
+static int
+EventLog_addBatch(EventLog self, ASDU* asdus, int numberOfAsdus)
 {
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_wait(self->queueLock);
-#endif
+    int added = 0;
 
-    self->firstMsgIndex = 0;
-    self->lastMsgIndex = 0;
-    self->entryCounter = 0;
+    while (added < numberOfAsdus) {
+        uint8_t* events[MAX_EVENT_BATCH_SIZE];
 
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_post(self->queueLock);
-#endif
-}
+        int batchSize = numberOfAsdus - added;
 
+        if (batchSize > MAX_EVENT_BATCH_SIZE)
+            batchSize = MAX_EVENT_BATCH_SIZE;
 
+        int reserved;
 
-/***************************************************
- * Slave
- ***************************************************/
+        EventLog_lock(self);
 
-struct sSlave {
-    InterrogationHandler interrogationHandler;
-    void* interrogationHandlerParameter;
+        for (reserved = 0; reserved < batchSize; reserved++) {
+            events[reserved] = EventLog_reserve(self, ASDU_getEncodedSize(asdus[added + reserved]), NULL);
 
-    CounterInterrogationHandler counterInterrogationHandler;
-    void* counterInterrogationHandlerParameter;
+            if (events[reserved] == NULL)
+                break;
+        }
 
-    ReadHandler readHandler;
-    void* readHandlerParameter;
+        EventLog_unlock(self);
 
-    ClockSynchronizationHandler clockSyncHandler;
-    void* clockSyncHandlerParameter;
+        int i;
 
-    ResetProcessHandler resetProcessHandler;
-    void* resetProcessHandlerParameter;
+        for (i = 0; i < reserved; i++) {
+            struct sBufferFrame bufferFrame;
+
+            Frame frame = BufferFrame_initialize(&bufferFrame, events[i], 0);
+
+            ASDU_encode(asdus[added + i], frame);
+        }
+
+        EventLog_lock(self);
+
+        for (i = 0; i < reserved; i++)
+            MessageRing_commit(&(self->ring), events[i]);
+
+        EventLog_unlock(self);
+
+        added += reserved;
+
+        if (reserved < batchSize)
+            break;
+    }
+
+    return added;
+}
+
+/**
+ * Remove the events that are confirmed by all readers and update the minimum
+ * acknowledge cursor.
+ *
+ * Has to be called with the log lock held. Returns true when events have been removed.
+ */
+static bool
+EventLog_releaseConfirmedEvents(EventLog self)
+{
+    LinkedList element = LinkedList_getNext(self->readers);
+
+    if (element == NULL)
+        return false;
+
+    uint64_t minAckCursor = self->ring.committedSeqNo;
+
+    while (element != NULL) {
+        uint64_t* ackCursor = (uint64_t*) LinkedList_getData(element);
+
+        if (*ackCursor < minAckCursor)
+            minAckCursor = *ackCursor;
+
+        element = LinkedList_getNext(element);
+    }
+
+    self->minAckCursor = minAckCursor;
+
+    if (minAckCursor <= self->ring.oldestSeqNo)
+        return false;
+
+    MessageRing_removeUntil(&(self->ring), minAckCursor - 1);
+
+    return true;
+}
+
+/**
+ * Add a new connection as reader. The connection only receives the events that are
+ * added after it has been accepted (the cursors are set behind the newest event).
+ *
+ * Has to be called with the log lock held.
+ */
+static void
+EventLog_addReader(EventLog self, MessageRingCursor* sendCursor, uint64_t* ackCursor)
+{
+    MessageRing_getEnd(&(self->ring), sendCursor);
+
+    /* the events before the cursor must not be changed anymore (packing) */
+    if (sendCursor->seqNo > self->sentSeqNo)
+        self->sentSeqNo = sendCursor->seqNo;
+
+    *ackCursor = sendCursor->seqNo;
+
+    if ((LinkedList_getNext(self->readers) == NULL) || (*ackCursor < self->minAckCursor))
+        self->minAckCursor = *ackCursor;
+
+    LinkedList_add(self->readers, ackCursor);
+}
+
+/**
+ * Remove the acknowledge cursor of a connection that is closed
+ *
+ * Has to be called with the log lock held. Returns true when events have been removed.
+ */
+static bool
+EventLog_removeReader(EventLog self, uint64_t* ackCursor)
+{
+    LinkedList_remove(self->readers, ackCursor);
+
+    /* the events that are only waiting for this connection are not required anymore */
+    if (*ackCursor <= self->minAckCursor)
+        return EventLog_releaseConfirmedEvents(self);
+
+    return false;
+}
+
+/**
+ * Move the acknowledge cursor of a reader. The events are only released when
+ * the cursor of the reader with the oldest unconfirmed event is moved.
+ *
+ * Has to be called with the log lock held. Returns true when events have been removed.
+ */
+static bool
+EventLog_moveAckCursor(EventLog self, uint64_t* ackCursor, uint64_t newAckCursor)
+{
+    if (newAckCursor <= *ackCursor)
+        return false;
+
+    /* the minimum is outdated when the oldest events have been overwritten */
+    bool isMinimum = ((*ackCursor <= self->minAckCursor) || (self->minAckCursor < self->ring.oldestSeqNo));
+
+    *ackCursor = newAckCursor;
+
+    if (isMinimum)
+        return EventLog_releaseConfirmedEvents(self);
+
+    return false;
+}
+
+static int
+EventLog_getFillLevelLocked(EventLog self)
+{
+    return (int) (((int64_t) MessageRing_getUsedSpace(&(self->ring)) * 100) / self->ring.size);
+}
+
+static int
+EventLog_getFillLevel(EventLog self)
+{
+    EventLog_lock(self);
+
+    int fillLevel = EventLog_getFillLevelLocked(self);
+
+    EventLog_unlock(self);
+
+    return fillLevel;
+}
+
+#endif /* (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1) */
+
+/***************************************************
+ * Slave
+ ***************************************************/
+
+typedef struct sEventLoop* EventLoop;
+
+struct sSlave {
+    InterrogationHandler interrogationHandler;
+    void* interrogationHandlerParameter;
+
+    CounterInterrogationHandler counterInterrogationHandler;
+    void* counterInterrogationHandlerParameter;
+
+    ReadHandler readHandler;
+    void* readHandlerParameter;
+
+    ClockSynchronizationHandler clockSyncHandler;
+    void* clockSyncHandlerParameter;
+
+    ResetProcessHandler resetProcessHandler;
+    void* resetProcessHandlerParameter;
 
     DelayAcquisitionHandler delayAcquisitionHandler;
     void* delayAcquisitionHandlerParameter;
@@ -604,9 +690,43 @@ struct sSlave {
     HighPriorityASDUQueue connectionAsduQueue; /**< high priority ASDU queue */
 #endif
 
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+    char* eventQueueFileName; /**< file of the persistent low priority queue or NULL */
+    int eventQueueFileSize;
+#endif
+
 #if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP)
     int maxLowPrioQueueSize;
     int maxHighPrioQueueSize;
+    struct sEventLog eventLog; /**< encoded events shared by all connections */
+#endif
+
+    QueueOverflowPolicy overflowPolicy;
+    int blockTimeoutInMs;
+    int blockedProducers; /**< producers waiting for free space (protected by the lock of the event queue (or log)) */
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore eventsReleased; /**< posted for every blocked producer when events are released */
+#endif
+
+    QueueSpillHandler spillHandler;
+    void* spillHandlerParameter;
+
+    int lowWatermark;
+    int highWatermark;
+    QueueWatermarkHandler watermarkHandler;
+    void* watermarkHandlerParameter;
+    bool isAboveHighWatermark; /**< protected by the lock of the event queue (or log) */
+
+    bool isCoalescingEnabled;
+    int packingMaxDelay; /**< maximum delay for packing events in ms (-1 = packing disabled) */
+
+#if (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0)
+    IngestQueue ingestQueue; /**< lock-free queue of the ASDUs added with Slave_enqueueASDU */
+    volatile int ingestWakeupPending; /**< connections have been informed about ASDUs in the ingest queue */
+    volatile int ingestEventsRemoved; /**< ASDUs have been removed (or spilled) while the ingest queue was drained */
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore ingestConsumerLock; /**< serializes the consumers of the ingest queue */
+#endif
 #endif
 
     int openConnections; /**< number of connected clients */
@@ -629,6 +749,12 @@ struct sSlave {
     int tcpPort;
 
     ServerMode serverMode;
+    ServerThreadingMode threadingMode;
+
+    int numberOfEventLoops; /**< number of event loop threads in EVENT_LOOP_THREAD mode */
+    int eventLoopFirstCpu; /**< CPU core of the first event loop thread or -1 */
+    int runningEventLoops;
+    EventLoop eventLoops;
 
     char* localAddress;
     Thread listeningThread;
@@ -669,9 +795,29 @@ initializeMessageQueues(Slave self, int lowPrioMaxQueueSize, int highPrioMaxQueu
         lowPrioMaxQueueSize = CONFIG_SLAVE_ASDU_QUEUE_SIZE;
 #endif
 
-    self->asduQueue = MessageQueue_create(lowPrioMaxQueueSize);
+    self->asduQueue = NULL;
+
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+    if (self->eventQueueFileName != NULL) {
+        self->asduQueue = MessageQueue_createPersistent(self->eventQueueFileName, self->eventQueueFileSize);
+
+        if (self->asduQueue == NULL)
+            DEBUG_PRINT("Failed to open event queue file %s\n", self->eventQueueFileName);
+    }
+#endif
+
+    if (self->asduQueue == NULL)
+        self->asduQueue = MessageQueue_create(lowPrioMaxQueueSize);
     //TODO support static memory allocation mode
 
+    MessageQueue_setOverflowPolicy(self->asduQueue, self->overflowPolicy, self->spillHandler, self->spillHandlerParameter);
+
+    if (self->isCoalescingEnabled)
+        MessageQueue_enableCoalescing(self->asduQueue, (ConnectionParameters) &(self->parameters));
+
+    if (self->packingMaxDelay >= 0)
+        MessageQueue_enablePacking(self->asduQueue, (ConnectionParameters) &(self->parameters), self->packingMaxDelay);
+
     /* initialize high priority queue */
 
 #if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE == 1)
@@ -714,18 +860,52 @@ T104Slave_create(ConnectionParameters parameters, int maxLowPrioQueueSize, int m
 #if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
         self->maxLowPrioQueueSize = maxLowPrioQueueSize;
         self->maxHighPrioQueueSize = maxHighPrioQueueSize;
+        self->eventLog.buffer = NULL;
+#endif
+
+#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
+        self->asduQueue = NULL;
+        self->connectionAsduQueue = NULL;
+#endif
+
+        self->overflowPolicy = QUEUE_OVERFLOW_DROP_OLDEST;
+        self->blockTimeoutInMs = 0;
+        self->blockedProducers = 0;
+        self->spillHandler = NULL;
+        self->spillHandlerParameter = NULL;
+        self->lowWatermark = 0;
+        self->highWatermark = 100;
+        self->watermarkHandler = NULL;
+        self->watermarkHandlerParameter = NULL;
+        self->isAboveHighWatermark = false;
+        self->isCoalescingEnabled = false;
+        self->packingMaxDelay = -1;
+
+#if (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0)
+        self->ingestQueue = IngestQueue_create(CONFIG_SLAVE_INGEST_QUEUE_SIZE);
+        self->ingestWakeupPending = 0;
+        self->ingestEventsRemoved = 0;
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+        self->ingestConsumerLock = Semaphore_create(1);
+#endif
 #endif
 
         self->masterConnections = LinkedList_create();
         self->maxOpenConnections = CONFIG_CS104_MAX_CLIENT_CONNECTIONS;
 #if (CONFIG_SLAVE_USING_THREADS == 1)
         self->openConnectionsLock = Semaphore_create(1);
+        self->eventsReleased = Semaphore_create(0);
 #endif
 
         self->isRunning = false;
         self->stopRunning = false;
 
         self->localAddress = NULL;
+
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+        self->eventQueueFileName = NULL;
+        self->eventQueueFileSize = 0;
+#endif
         self->tcpPort = T104_DEFAULT_PORT;
         self->openConnections = 0;
         self->listeningThread = NULL;
@@ -738,6 +918,11 @@ T104Slave_create(ConnectionParameters parameters, int maxLowPrioQueueSize, int m
 #endif
 #endif
 
+        self->threadingMode = THREAD_PER_CONNECTION;
+        self->numberOfEventLoops = 1;
+        self->eventLoopFirstCpu = -1;
+        self->runningEventLoops = 0;
+        self->eventLoops = NULL;
     }
 
     return self;
@@ -749,6 +934,27 @@ T104Slave_setServerMode(Slave self, ServerMode serverMode)
     self->serverMode = serverMode;
 }
 
+void
+T104Slave_setThreadingMode(Slave self, ServerThreadingMode threadingMode)
+{
+    self->threadingMode = threadingMode;
+}
+
+void
+T104Slave_setEventLoopThreads(Slave self, int numberOfThreads)
+{
+    if (numberOfThreads < 1)
+        numberOfThreads = 1;
+
+    self->numberOfEventLoops = numberOfThreads;
+}
+
+void
+T104Slave_setEventLoopCpuAffinity(Slave self, int firstCpu)
+{
+    self->eventLoopFirstCpu = firstCpu;
+}
+
 void
 T104Slave_setLocalAddress(Slave self, const char* ipAddress)
 {
@@ -761,6 +967,60 @@ T104Slave_setLocalAddress(Slave self, const char* ipAddress)
         strcpy(self->localAddress, ipAddress);
 }
 
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+void
+T104Slave_setEventQueueFile(Slave self, const char* fileName, int fileSize)
+{
+    if (self->eventQueueFileName)
+        GLOBAL_FREEMEM(self->eventQueueFileName);
+
+    self->eventQueueFileName = (char*) GLOBAL_MALLOC(strlen(fileName) + 1);
+
+    if (self->eventQueueFileName)
+        strcpy(self->eventQueueFileName, fileName);
+
+    self->eventQueueFileSize = fileSize;
+}
+#endif /* (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1) */
+
+void
+T104Slave_setQueueOverflowPolicy(Slave self, QueueOverflowPolicy policy, int blockTimeoutInMs)
+{
+    self->overflowPolicy = policy;
+    self->blockTimeoutInMs = blockTimeoutInMs;
+}
+
+void
+T104Slave_setQueueSpillHandler(Slave self, QueueSpillHandler handler, void* parameter)
+{
+    self->spillHandler = handler;
+    self->spillHandlerParameter = parameter;
+}
+
+void
+T104Slave_setQueueWatermarks(Slave self, int lowWatermark, int highWatermark, QueueWatermarkHandler handler, void* parameter)
+{
+    self->lowWatermark = lowWatermark;
+    self->highWatermark = highWatermark;
+    self->watermarkHandler = handler;
+    self->watermarkHandlerParameter = parameter;
+}
+
+void
+T104Slave_setEventCoalescing(Slave self, bool enable)
+{
+    self->isCoalescingEnabled = enable;
+}
+
+void
+T104Slave_setEventPacking(Slave self, bool enable, int maxDelayInMs)
+{
+    if (enable)
+        self->packingMaxDelay = (maxDelayInMs > 0) ? maxDelayInMs : 0;
+    else
+        self->packingMaxDelay = -1;
+}
+
 void
 T104Slave_setLocalPort(Slave self, int tcpPort)
 {
@@ -873,10 +1133,11 @@ Slave_getConnectionParameters(Slave self)
  * MasterConnection
  *********************************************************/
 
+#define NO_QUEUE_ENTRY UINT64_MAX
+
 typedef struct {
-    /* required to identify message in server (low-priority) queue */
-    uint64_t entryTime;
-    int queueIndex; /* -1 if ASDU is not from low-priority queue */
+    /* required to identify message in server (low-priority) queue or event log */
+    uint64_t queueSeqNo; /* NO_QUEUE_ENTRY if ASDU is not from low-priority queue or event log */
 
     /* required for T1 timeout */
     uint64_t sentTime;
@@ -895,21 +1156,51 @@ struct sMasterConnection {
     int unconfirmedReceivedIMessages; /* number of unconfirmed messages received */
     uint64_t lastConfirmationTime; /* timestamp when the last confirmation message (for I messages) was sent */
 
-    uint64_t nextT3Timeout;
     int outstandingTestFRConMessages;
 
+    TimerWheel timerWheel; /* timer wheel of the thread handling the connection */
+    struct sTimerWheelTimer t1Timer; /* timeout for confirmation of sent I messages */
+    struct sTimerWheelTimer t2Timer; /* timeout for sending confirmation of received I messages */
+    struct sTimerWheelTimer t3Timer; /* timeout for sending test frames */
+    struct sTimerWheelTimer packingTimer; /* end of the delay of an event that is held back for packing */
+    struct sTimerWheelTimer sendTimer; /* timeout T1 for messages the socket doesn't take (EVENT_LOOP_THREAD mode) */
+
     int maxSentASDUs;
     int oldestSentASDU;
     int newestSentASDU;
     SentASDUSlave* sentASDUs;
 #if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore sentASDUsLock;
+    Semaphore sentASDUsLock; /* also protects the send buffer */
 #endif
 
-    MessageQueue lowPrioQueue;
+    /* messages waiting to be written to the socket */
+    uint8_t sendBuffer[CONFIG_SLAVE_SEND_BUFFER_SIZE];
+    int sendBufferSize;
+    bool deferSending; /* true while received messages are handled */
+    bool isSendBlocked; /* the socket cannot take the buffered messages (EVENT_LOOP_THREAD mode) */
+    bool isWaitingForWritable; /* the event loop waits until the socket is writable (only accessed by the event loop thread) */
+
+    WakeupHandle wakeupHandle; /* signaled when new events are available (owned by the event loop in EVENT_LOOP_THREAD mode) */
+
+    MessageQueue lowPrioQueue; /* NULL when the events are read from the shared event log */
     HighPriorityASDUQueue highPrioQueue;
 
+    /* active response stream (see MasterConnection_startResponseStream) */
+    ResponseProducer streamProducer; /* NULL when no stream is active */
+    ResponseStreamFinishedHandler streamFinishedHandler;
+    void* streamParameter;
+    struct sStaticASDU streamTerminationMemory;
+    ASDU streamTermination; /* ACT_TERM sent at the end of the stream (NULL when no ACT_TERM is sent) */
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    MessageRingCursor eventLogSendCursor; /* next event to send */
+    uint64_t eventLogAckCursor; /* sequence number of the oldest unconfirmed event (protected by the log lock) */
+    bool isEventLogReader; /* the ack cursor is one of the readers of the log (protected by the log lock) */
+#endif
+
     bool firstIMessageReceived;
+
+    struct sT104ReceiveBuffer recvBuffer;
 };
 
 
@@ -924,10 +1215,10 @@ printSendBuffer(MasterConnection self)
         DEBUG_PRINT ("------k-buffer------\n");
 
         do {
-            DEBUG_PRINT("%02i : SeqNo=%i time=%llu : queueIdx=%i\n", currentIndex,
+            DEBUG_PRINT("%02i : SeqNo=%i time=%llu : queueSeqNo=%llu\n", currentIndex,
                     self->sentASDUs[currentIndex].seqNo,
                     self->sentASDUs[currentIndex].sentTime,
-                    self->sentASDUs[currentIndex].queueIndex);
+                    (unsigned long long) self->sentASDUs[currentIndex].queueSeqNo);
 
             if (currentIndex == self->newestSentASDU)
                 nextIndex = -1;
@@ -943,119 +1234,270 @@ printSendBuffer(MasterConnection self)
 }
 
 
-static int
-receiveMessage(Socket socket, uint8_t* buffer)
-{
-    int readFirst = Socket_read(socket, buffer, 1);
-
-    if (readFirst < 1)
-        return readFirst;
+/* maximum size of an I message */
+#define MAX_I_MESSAGE_SIZE (IEC60870_5_104_MAX_ASDU_LENGTH + IEC60870_5_104_APCI_LENGTH)
 
-    if (buffer[0] != 0x68)
-        return -1; /* message error */
-
-    if (Socket_read(socket, buffer + 1, 1) != 1)
-        return -1;
+/* space of the send buffer that is kept free for S and U messages */
+#define CONTROL_MESSAGES_RESERVE (4 * 6)
 
-    int length = buffer[1];
+/**
+ * Write the buffered messages to the socket.
+ *
+ * In THREAD_PER_CONNECTION mode the connection waits (at most timeout T1) until the socket has
+ * taken all messages. In EVENT_LOOP_THREAD mode the socket is non-blocking. The messages the
+ * socket cannot take remain in the send buffer until the event loop finds the socket writable.
+ *
+ * Returns true when all messages have been written.
+ */
+static bool
+flushSendBuffer(MasterConnection self)
+{
+    /* locking of send buffer has to be done by caller! */
+    if (self->sendBufferSize > 0) {
 
-    /* read remaining frame */
-    if (Socket_read(socket, buffer + 2, length) != length)
-        return -1;
+        DEBUG_PRINT("SEND %i bytes\n", self->sendBufferSize);
 
-    return length + 2;
-}
+        int sentBytes = 0;
 
-static int
-sendIMessage(MasterConnection self, uint8_t* buffer, int msgSize)
-{
-    //TODO lock socket?
+        /* the socket can take less than the whole buffer */
+        while (sentBytes < self->sendBufferSize) {
+            int result = Socket_write(self->socket, self->sendBuffer + sentBytes, self->sendBufferSize - sentBytes);
 
-    buffer[0] = (uint8_t) 0x68;
-    buffer[1] = (uint8_t) (msgSize - 2);
+            if (result > 0)
+                sentBytes += result;
+            else if ((result == 0) && (self->slave->threadingMode == EVENT_LOOP_THREAD))
+                break;
+            else if ((result == -1) ||
+                    (Socket_waitWritable(self->socket, self->slave->parameters.t1 * 1000) == false)) {
+                /* socket error or the master has not received any data within timeout T1 */
+                DEBUG_PRINT("Failed to send %i bytes\n", self->sendBufferSize - sentBytes);
 
-    buffer[2] = (uint8_t) ((self->sendCount % 128) * 2);
-    buffer[3] = (uint8_t) (self->sendCount / 128);
+                self->isRunning = false;
+                sentBytes = self->sendBufferSize;
+                break;
+            }
+        }
 
-    buffer[4] = (uint8_t) ((self->receiveCount % 128) * 2);
-    buffer[5] = (uint8_t) (self->receiveCount / 128);
+        /* keep the messages the socket didn't take */
+        if (sentBytes < self->sendBufferSize)
+            memmove(self->sendBuffer, self->sendBuffer + sentBytes, self->sendBufferSize - sentBytes);
 
-    if (Socket_write(self->socket, buffer, msgSize) != -1) {
-        DEBUG_PRINT("SEND I (size = %i) N(S) = %i N(R) = %i\n", msgSize, self->sendCount, self->receiveCount);
-        self->sendCount = (self->sendCount + 1) % 32768;
-        self->unconfirmedReceivedIMessages = 0;
+        self->sendBufferSize -= sentBytes;
     }
-    else
-        self->isRunning = false;
 
-    self->unconfirmedReceivedIMessages = 0;
+    self->isSendBlocked = (self->sendBufferSize > 0);
 
-    return self->sendCount;
+    return (self->isSendBlocked == false);
 }
 
+/**
+ * Check if the send buffer can take another I message. Some space is kept free for
+ * the S and U messages.
+ */
 static bool
-isSentBufferFull(MasterConnection self)
+hasSendBufferSpace(MasterConnection self)
 {
-    /* locking of k-buffer has to be done by caller! */
-    if (self->oldestSentASDU == -1)
-        return false;
-
-    int newIndex = (self->newestSentASDU + 1) % (self->maxSentASDUs);
-
-    if (newIndex == self->oldestSentASDU)
+    /* locking of send buffer has to be done by caller! */
+    if (self->sendBufferSize == 0)
         return true;
-    else
-        return false;
-}
 
+    return ((self->sendBufferSize + MAX_I_MESSAGE_SIZE + CONTROL_MESSAGES_RESERVE) <= CONFIG_SLAVE_SEND_BUFFER_SIZE);
+}
 
 static void
-sendASDU(MasterConnection self, FrameBuffer* asdu, uint64_t timestamp, int index)
+writeToSendBuffer(MasterConnection self, uint8_t* msg, int msgSize)
 {
-    int currentIndex = 0;
+    /* locking of send buffer has to be done by caller! */
+    if ((self->sendBufferSize + msgSize) > CONFIG_SLAVE_SEND_BUFFER_SIZE)
+        flushSendBuffer(self);
 
-    if (self->oldestSentASDU == -1) {
-        self->oldestSentASDU = 0;
-        self->newestSentASDU = 0;
-    }
-    else {
-        currentIndex = (self->newestSentASDU + 1) % self->maxSentASDUs;
+    /* the master doesn't take the messages - the connection is closed by the send timeout */
+    if ((self->sendBufferSize + msgSize) > CONFIG_SLAVE_SEND_BUFFER_SIZE) {
+        DEBUG_PRINT("Send buffer full - control message dropped\n");
+        return;
     }
 
-    self->sentASDUs[currentIndex].entryTime = timestamp;
-    self->sentASDUs[currentIndex].queueIndex = index;
-    self->sentASDUs[currentIndex].seqNo = sendIMessage(self, asdu->msg, asdu->msgSize);
-    self->sentASDUs[currentIndex].sentTime = Hal_getTimeInMs();
-
-    self->newestSentASDU = currentIndex;
-
-    printSendBuffer(self);
+    memcpy(self->sendBuffer + self->sendBufferSize, msg, msgSize);
+    self->sendBufferSize += msgSize;
 }
 
-
-static bool
-sendASDUInternal(MasterConnection self, ASDU asdu)
+/**
+ * Add a U or S message to the send buffer
+ */
+static void
+sendControlMessage(MasterConnection self, uint8_t* msg, int msgSize)
 {
-    bool asduSent;
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->sentASDUsLock);
+#endif
 
-    if (self->isActive) {
+    writeToSendBuffer(self, msg, msgSize);
 
 #if (CONFIG_SLAVE_USING_THREADS == 1)
-        Semaphore_wait(self->sentASDUsLock);
+    Semaphore_post(self->sentASDUsLock);
 #endif
+}
 
-        if (isSentBufferFull(self) == false) {
+/**
+ * Write all buffered messages to the socket.
+ *
+ * Returns true when the send buffer had no space for another I message and the socket has
+ * taken all messages. In this case the connection can continue sending immediately.
+ */
+static bool
+MasterConnection_flush(MasterConnection self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->sentASDUsLock);
+#endif
 
-            FrameBuffer frameBuffer;
+    bool wasFull = (hasSendBufferSpace(self) == false);
 
-            struct sBufferFrame bufferFrame;
+    bool continueSending = (flushSendBuffer(self) && wasFull);
 
-            Frame frame = BufferFrame_initialize(&bufferFrame, frameBuffer.msg, IEC60870_5_104_APCI_LENGTH);
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->sentASDUsLock);
+#endif
+
+    return continueSending;
+}
+
+/**
+ * Check if the event loop has to wait until the socket can take the buffered messages
+ */
+static bool
+MasterConnection_isSendBlocked(MasterConnection self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->sentASDUsLock);
+#endif
+
+    bool isSendBlocked = self->isSendBlocked;
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->sentASDUsLock);
+#endif
+
+    return isSendBlocked;
+}
+
+/**
+ * Add an I message with the encoded ASDU to the send buffer. The ASDU is not changed
+ * because it can be shared with other connections. The caller has to check the space
+ * of the send buffer with hasSendBufferSpace. The messages are not written to the socket
+ * here because the callers can hold the lock of the event queue.
+ *
+ * Returns the new send sequence number or -1 when the ASDU size is not valid.
+ */
+static int
+sendIMessage(MasterConnection self, const uint8_t* asdu, int asduSize)
+{
+    /* the length field of the APCI has only one byte */
+    if ((asduSize < 1) || (asduSize > IEC60870_5_104_MAX_ASDU_LENGTH)) {
+        DEBUG_PRINT("Invalid ASDU size %i -> not sent\n", asduSize);
+        return -1;
+    }
+
+    int msgSize = asduSize + IEC60870_5_104_APCI_LENGTH;
+
+    /* locking of send buffer has to be done by caller! */
+    uint8_t* buffer = self->sendBuffer + self->sendBufferSize;
+
+    buffer[0] = (uint8_t) 0x68;
+    buffer[1] = (uint8_t) (msgSize - 2);
+
+    buffer[2] = (uint8_t) ((self->sendCount % 128) * 2);
+    buffer[3] = (uint8_t) (self->sendCount / 128);
+
+    buffer[4] = (uint8_t) ((self->receiveCount % 128) * 2);
+    buffer[5] = (uint8_t) (self->receiveCount / 128);
+
+    memcpy(buffer + IEC60870_5_104_APCI_LENGTH, asdu, asduSize);
+
+    self->sendBufferSize += msgSize;
+
+    DEBUG_PRINT("SEND I (size = %i) N(S) = %i N(R) = %i\n", msgSize, self->sendCount, self->receiveCount);
+
+    self->sendCount = (self->sendCount + 1) % 32768;
+
+    self->unconfirmedReceivedIMessages = 0;
+
+    return self->sendCount;
+}
+
+static bool
+isSentBufferFull(MasterConnection self)
+{
+    /* locking of k-buffer has to be done by caller! */
+    if (self->oldestSentASDU == -1)
+        return false;
+
+    int newIndex = (self->newestSentASDU + 1) % (self->maxSentASDUs);
+
+    if (newIndex == self->oldestSentASDU)
+        return true;
+    else
+        return false;
+}
+
+
+static void
+sendASDU(MasterConnection self, const uint8_t* asdu, int asduSize, uint64_t queueSeqNo)
+{
+    int seqNo = sendIMessage(self, asdu, asduSize);
+
+    if (seqNo == -1)
+        return;
+
+    int currentIndex = 0;
+
+    if (self->oldestSentASDU == -1) {
+        self->oldestSentASDU = 0;
+        self->newestSentASDU = 0;
+    }
+    else {
+        currentIndex = (self->newestSentASDU + 1) % self->maxSentASDUs;
+    }
+
+    self->sentASDUs[currentIndex].queueSeqNo = queueSeqNo;
+    self->sentASDUs[currentIndex].seqNo = seqNo;
+    self->sentASDUs[currentIndex].sentTime = Hal_getTimeInMs();
+
+    self->newestSentASDU = currentIndex;
+
+    printSendBuffer(self);
+}
+
+
+static bool
+sendASDUInternal(MasterConnection self, ASDU asdu)
+{
+    bool asduSent;
+
+    if (self->isActive) {
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+        Semaphore_wait(self->sentASDUsLock);
+#endif
+
+        if ((isSentBufferFull(self) == false) && hasSendBufferSpace(self)) {
+
+            uint8_t buffer[MESSAGE_QUEUE_ENTRY_SIZE];
+
+            struct sBufferFrame bufferFrame;
+
+            Frame frame = BufferFrame_initialize(&bufferFrame, buffer, 0);
             ASDU_encode(asdu, frame);
 
-            frameBuffer.msgSize = Frame_getMsgSize(frame);
+            sendASDU(self, buffer, Frame_getMsgSize(frame), NO_QUEUE_ENTRY);
+
+            /* when not called while handling received messages the message is sent immediately */
+            if (self->deferSending == false) {
+                flushSendBuffer(self);
 
-            sendASDU(self, &frameBuffer, 0, -1);
+                /* let the connection handling start timeout T1 */
+                WakeupHandle_signal(self->wakeupHandle);
+            }
 
 #if (CONFIG_SLAVE_USING_THREADS == 1)
             Semaphore_post(self->sentASDUsLock);
@@ -1100,6 +1542,9 @@ handleASDU(MasterConnection self, ASDU asdu)
 
     Slave slave = self->slave;
 
+    /* memory for the decoded command (avoids allocating the information object) */
+    union uStaticInformationObject ioMemory;
+
     uint8_t cot = ASDU_getCOT(asdu);
 
     switch (ASDU_getTypeID(asdu)) {
@@ -1111,13 +1556,11 @@ handleASDU(MasterConnection self, ASDU asdu)
         if ((cot == ACTIVATION) || (cot == DEACTIVATION)) {
             if (slave->interrogationHandler != NULL) {
 
-                InterrogationCommand irc = (InterrogationCommand) ASDU_getElement(asdu, 0);
+                InterrogationCommand irc = (InterrogationCommand) ASDU_getElementEx(asdu, &ioMemory, 0);
 
                 if (slave->interrogationHandler(slave->interrogationHandlerParameter,
                         self, asdu, InterrogationCommand_getQOI(irc)))
                     messageHandled = true;
-
-                InterrogationCommand_destroy(irc);
             }
         }
         else
@@ -1133,14 +1576,11 @@ handleASDU(MasterConnection self, ASDU asdu)
 
             if (slave->counterInterrogationHandler != NULL) {
 
-                CounterInterrogationCommand cic = (CounterInterrogationCommand) ASDU_getElement(asdu, 0);
-
+                CounterInterrogationCommand cic = (CounterInterrogationCommand) ASDU_getElementEx(asdu, &ioMemory, 0);
 
                 if (slave->counterInterrogationHandler(slave->counterInterrogationHandlerParameter,
                         self, asdu, CounterInterrogationCommand_getQCC(cic)))
                     messageHandled = true;
-
-                CounterInterrogationCommand_destroy(cic);
             }
         }
         else
@@ -1154,13 +1594,11 @@ handleASDU(MasterConnection self, ASDU asdu)
 
         if (cot == REQUEST) {
             if (slave->readHandler != NULL) {
-                ReadCommand rc = (ReadCommand) ASDU_getElement(asdu, 0);
+                ReadCommand rc = (ReadCommand) ASDU_getElementEx(asdu, &ioMemory, 0);
 
                 if (slave->readHandler(slave->readHandlerParameter,
                         self, asdu, InformationObject_getObjectAddress((InformationObject) rc)))
                     messageHandled = true;
-
-                ReadCommand_destroy(rc);
             }
         }
         else
@@ -1176,13 +1614,11 @@ handleASDU(MasterConnection self, ASDU asdu)
 
             if (slave->clockSyncHandler != NULL) {
 
-                ClockSynchronizationCommand csc = (ClockSynchronizationCommand) ASDU_getElement(asdu, 0);
+                ClockSynchronizationCommand csc = (ClockSynchronizationCommand) ASDU_getElementEx(asdu, &ioMemory, 0);
 
                 if (slave->clockSyncHandler(slave->clockSyncHandlerParameter,
                         self, asdu, ClockSynchronizationCommand_getTime(csc)))
                     messageHandled = true;
-
-                ClockSynchronizationCommand_destroy(csc);
             }
         }
         else
@@ -1212,13 +1648,11 @@ handleASDU(MasterConnection self, ASDU asdu)
         if (cot == ACTIVATION) {
 
             if (slave->resetProcessHandler != NULL) {
-                ResetProcessCommand rpc = (ResetProcessCommand) ASDU_getElement(asdu, 0);
+                ResetProcessCommand rpc = (ResetProcessCommand) ASDU_getElementEx(asdu, &ioMemory, 0);
 
                 if (slave->resetProcessHandler(slave->resetProcessHandlerParameter,
                         self, asdu, ResetProcessCommand_getQRP(rpc)))
                     messageHandled = true;
-
-                ResetProcessCommand_destroy(rpc);
             }
 
         }
@@ -1234,13 +1668,11 @@ handleASDU(MasterConnection self, ASDU asdu)
         if ((cot == ACTIVATION) || (cot == SPONTANEOUS)) {
 
             if (slave->delayAcquisitionHandler != NULL) {
-                DelayAcquisitionCommand dac = (DelayAcquisitionCommand) ASDU_getElement(asdu, 0);
+                DelayAcquisitionCommand dac = (DelayAcquisitionCommand) ASDU_getElementEx(asdu, &ioMemory, 0);
 
                 if (slave->delayAcquisitionHandler(slave->delayAcquisitionHandlerParameter,
                         self, asdu, DelayAcquisitionCommand_getDelay(dac)))
                     messageHandled = true;
-
-                DelayAcquisitionCommand_destroy(dac);
             }
         }
         else
@@ -1266,6 +1698,203 @@ handleASDU(MasterConnection self, ASDU asdu)
 
 
 
+/**
+ * Lock the event queue (or log) of the slave
+ */
+static void
+Slave_lockEventQueue(Slave self)
+{
+#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == SINGLE_REDUNDANCY_GROUP) && (self->asduQueue != NULL))
+        MessageQueue_lock(self->asduQueue);
+#endif
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) && (self->eventLog.buffer != NULL))
+        EventLog_lock(&(self->eventLog));
+#endif
+}
+
+static void
+Slave_unlockEventQueue(Slave self)
+{
+#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == SINGLE_REDUNDANCY_GROUP) && (self->asduQueue != NULL))
+        MessageQueue_unlock(self->asduQueue);
+#endif
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) && (self->eventLog.buffer != NULL))
+        EventLog_unlock(&(self->eventLog));
+#endif
+}
+
+/**
+ * Wake up the producers that wait for free space in the event queue (QUEUE_OVERFLOW_BLOCK policy).
+ *
+ * Has to be called with the lock of the event queue (or log) held.
+ */
+static void
+Slave_signalReleasedEvents(Slave self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    int i;
+
+    for (i = 0; i < self->blockedProducers; i++)
+        Semaphore_post(self->eventsReleased);
+#endif
+}
+
+/**
+ * Wait until events are released or the timeout elapsed. The producer has to be
+ * counted in blockedProducers before it checks the free space the last time, so
+ * that it doesn't miss the release of events.
+ */
+static void
+Slave_waitForReleasedEvents(Slave self, int timeoutInMs)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_timedWait(self->eventsReleased, (unsigned int) timeoutInMs);
+#else
+    /* the events can only be released by the thread that calls Slave_tick */
+    Thread_sleep(timeoutInMs);
+#endif
+}
+
+static void
+Slave_setProducerBlocked(Slave self, bool isBlocked)
+{
+    Slave_lockEventQueue(self);
+
+    if (isBlocked)
+        self->blockedProducers++;
+    else
+        self->blockedProducers--;
+
+    Slave_unlockEventQueue(self);
+}
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+/**
+ * Move the acknowledge cursor of the connection and remove the events that are
+ * confirmed by all connections from the shared event log
+ */
+static void
+Slave_confirmEvents(Slave self, MasterConnection connection, uint64_t ackCursor)
+{
+    EventLog eventLog = &(self->eventLog);
+
+    EventLog_lock(eventLog);
+
+    if (connection->isEventLogReader) {
+        if (EventLog_moveAckCursor(eventLog, &(connection->eventLogAckCursor), ackCursor))
+            Slave_signalReleasedEvents(self);
+    }
+
+    EventLog_unlock(eventLog);
+}
+
+/**
+ * Remove the connection from the readers of the shared event log. The events that are
+ * only waiting for the confirmation of this connection are released.
+ */
+static void
+Slave_removeEventLogReader(Slave self, MasterConnection connection)
+{
+    EventLog eventLog = &(self->eventLog);
+
+    EventLog_lock(eventLog);
+
+    if (connection->isEventLogReader) {
+        if (EventLog_removeReader(eventLog, &(connection->eventLogAckCursor)))
+            Slave_signalReleasedEvents(self);
+
+        connection->isEventLogReader = false;
+    }
+
+    /* without connections all events are released */
+    if (LinkedList_getNext(eventLog->readers) == NULL) {
+        MessageRing_clear(&(eventLog->ring));
+        Slave_signalReleasedEvents(self);
+    }
+
+    EventLog_unlock(eventLog);
+}
+#endif /* (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1) */
+
+/**
+ * Update the water mark state. Has to be called with the lock of the event queue (or log).
+ *
+ * Returns 1 when the fill level crossed the high water mark, -1 when it crossed the low
+ * water mark and 0 otherwise.
+ */
+static int
+Slave_updateWatermarkState(Slave self, int fillLevel)
+{
+    if ((fillLevel >= self->highWatermark) && (self->isAboveHighWatermark == false)) {
+        self->isAboveHighWatermark = true;
+        return 1;
+    }
+
+    if ((fillLevel <= self->lowWatermark) && self->isAboveHighWatermark) {
+        self->isAboveHighWatermark = false;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Call the water mark handler when the fill level of the event queue crossed a water mark
+ */
+static void
+Slave_checkWatermarks(Slave self)
+{
+    if (self->watermarkHandler == NULL)
+        return;
+
+    int fillLevel = 0;
+    int crossed = 0;
+
+#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == SINGLE_REDUNDANCY_GROUP) && (self->asduQueue != NULL)) {
+        MessageQueue_lock(self->asduQueue);
+        fillLevel = MessageQueue_getFillLevelLocked(self->asduQueue);
+        crossed = Slave_updateWatermarkState(self, fillLevel);
+        MessageQueue_unlock(self->asduQueue);
+    }
+#endif
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) && (self->eventLog.buffer != NULL)) {
+        EventLog_lock(&(self->eventLog));
+        fillLevel = EventLog_getFillLevelLocked(&(self->eventLog));
+        crossed = Slave_updateWatermarkState(self, fillLevel);
+        EventLog_unlock(&(self->eventLog));
+    }
+#endif
+
+    /* the handler is called without the lock so that it can add or remove events */
+    if (crossed != 0)
+        self->watermarkHandler(self->watermarkHandlerParameter, (crossed > 0), fillLevel);
+}
+
+/**
+ * Remove a confirmed ASDU from the server (low-priority) queue or return the new
+ * acknowledge cursor for the shared event log (in eventLogAckCursor)
+ */
+static void
+confirmQueuedASDU(MasterConnection self, SentASDUSlave* sentASDU, uint64_t* eventLogAckCursor)
+{
+    if (sentASDU->queueSeqNo == NO_QUEUE_ENTRY)
+        return;
+
+    if (self->lowPrioQueue != NULL)
+        MessageQueue_markAsduAsConfirmed(self->lowPrioQueue, sentASDU->queueSeqNo);
+    else
+        *eventLogAckCursor = sentASDU->queueSeqNo + 1;
+}
+
 static bool
 checkSequenceNumber(MasterConnection self, int seqNo)
 {
@@ -1278,6 +1907,8 @@ checkSequenceNumber(MasterConnection self, int seqNo)
     bool seqNoIsValid = false;
     bool counterOverflowDetected = false;
 
+    uint64_t eventLogAckCursor = 0; /* 0 when no event of the shared log is confirmed */
+
     if (self->oldestSentASDU == -1) { /* if k-Buffer is empty */
         if (seqNo == self->sendCount)
             seqNoIsValid = true;
@@ -1319,13 +1950,7 @@ checkSequenceNumber(MasterConnection self, int seqNo)
                         break;
                 }
 
-                /* remove from server (low-priority) queue if required */
-                if (self->sentASDUs[self->oldestSentASDU].queueIndex != -1) {
-
-                    MessageQueue_markAsduAsConfirmed(self->lowPrioQueue,
-                            self->sentASDUs[self->oldestSentASDU].queueIndex,
-                            self->sentASDUs[self->oldestSentASDU].entryTime);
-                }
+                confirmQueuedASDU(self, &(self->sentASDUs[self->oldestSentASDU]), &eventLogAckCursor);
 
                 self->oldestSentASDU = (self->oldestSentASDU + 1) % self->maxSentASDUs;
 
@@ -1339,6 +1964,8 @@ checkSequenceNumber(MasterConnection self, int seqNo)
                 if (self->sentASDUs[self->oldestSentASDU].seqNo == seqNo) {
                     /* we arrived at the seq# that has been confirmed */
 
+                    confirmQueuedASDU(self, &(self->sentASDUs[self->oldestSentASDU]), &eventLogAckCursor);
+
                     if (self->oldestSentASDU == self->newestSentASDU)
                         self->oldestSentASDU = -1;
                     else
@@ -1359,16 +1986,48 @@ checkSequenceNumber(MasterConnection self, int seqNo)
     Semaphore_post(self->sentASDUsLock);
 #endif
 
+    if (seqNoIsValid) {
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+        if (eventLogAckCursor > 0)
+            Slave_confirmEvents(self->slave, self, eventLogAckCursor);
+#endif
+
+        /* the server queue released the confirmed ASDUs */
+        if ((self->lowPrioQueue != NULL) && (self->slave->overflowPolicy == QUEUE_OVERFLOW_BLOCK)) {
+            Slave_lockEventQueue(self->slave);
+            Slave_signalReleasedEvents(self->slave);
+            Slave_unlockEventQueue(self->slave);
+        }
+
+        Slave_checkWatermarks(self->slave);
+    }
+
     return seqNoIsValid;
 }
 
 static void
-resetT3Timeout(MasterConnection self)
+resetT3Timeout(MasterConnection self, uint64_t currentTime)
 {
-    self->nextT3Timeout = Hal_getTimeInMs() + (uint64_t) (self->slave->parameters.t3 * 1000);
+    TimerWheel_arm(self->timerWheel, &(self->t3Timer), currentTime + (uint64_t) (self->slave->parameters.t3 * 1000));
 }
 
 
+static void
+finishResponseStream(MasterConnection self, bool completed)
+{
+    ResponseStreamFinishedHandler finishedHandler = self->streamFinishedHandler;
+    void* parameter = self->streamParameter;
+
+    self->streamProducer = NULL;
+    self->streamFinishedHandler = NULL;
+    self->streamParameter = NULL;
+    self->streamTermination = NULL;
+
+    /* the handler can start the next stream */
+    if (finishedHandler != NULL)
+        finishedHandler(parameter, self, completed);
+}
+
 static bool
 handleMessage(MasterConnection self, uint8_t* buffer, int msgSize)
 {
@@ -1404,14 +2063,21 @@ handleMessage(MasterConnection self, uint8_t* buffer, int msgSize)
         self->receiveCount = (self->receiveCount + 1) % 32768;
         self->unconfirmedReceivedIMessages++;
 
+        /* start timeout T2 */
+        if (TimerWheelTimer_isArmed(&(self->t2Timer)) == false)
+            TimerWheel_arm(self->timerWheel, &(self->t2Timer),
+                    self->lastConfirmationTime + (uint64_t) (self->slave->parameters.t2 * 1000));
+
         if (self->isActive) {
 
-            ASDU asdu = ASDU_createFromBuffer((ConnectionParameters)&(self->slave->parameters), buffer + 6, msgSize - 6);
+            /* the ASDU refers to the receive buffer (nothing is allocated) */
+            struct sASDU asduMemory;
 
-            //TODO add support for separate handler thread
-            handleASDU(self, asdu);
+            ASDU asdu = ASDU_initializeFromBuffer(&asduMemory, (ConnectionParameters)&(self->slave->parameters), buffer + 6, msgSize - 6);
 
-            ASDU_destroy(asdu);
+            //TODO add support for separate handler thread
+            if (asdu != NULL)
+                handleASDU(self, asdu);
         }
         else
             DEBUG_PRINT("Connection not activated. Skip I message");
@@ -1422,7 +2088,7 @@ handleMessage(MasterConnection self, uint8_t* buffer, int msgSize)
     else if ((buffer[2] & 0x43) == 0x43) {
         DEBUG_PRINT("Send TESTFR_CON\n");
 
-        Socket_write(self->socket, TESTFR_CON_MSG, TESTFR_CON_MSG_SIZE);
+        sendControlMessage(self, TESTFR_CON_MSG, TESTFR_CON_MSG_SIZE);
     }
 
     /* Check for STARTDT_ACT message */
@@ -1435,7 +2101,10 @@ handleMessage(MasterConnection self, uint8_t* buffer, int msgSize)
 
         HighPriorityASDUQueue_resetConnectionQueue(self->highPrioQueue);
 
-        Socket_write(self->socket, STARTDT_CON_MSG, STARTDT_CON_MSG_SIZE);
+        if (self->streamProducer != NULL)
+            finishResponseStream(self, false);
+
+        sendControlMessage(self, STARTDT_CON_MSG, STARTDT_CON_MSG_SIZE);
     }
 
     /* Check for STOPDT_ACT message */
@@ -1444,7 +2113,7 @@ handleMessage(MasterConnection self, uint8_t* buffer, int msgSize)
 
         self->isActive = false;
 
-        Socket_write(self->socket, STOPDT_CON_MSG, STOPDT_CON_MSG_SIZE);
+        sendControlMessage(self, STOPDT_CON_MSG, STOPDT_CON_MSG_SIZE);
     }
 
     /* Check for TESTFR_CON message */
@@ -1468,7 +2137,7 @@ handleMessage(MasterConnection self, uint8_t* buffer, int msgSize)
         return true;
     }
 
-    resetT3Timeout(self);
+    resetT3Timeout(self, currentTime);
 
     return true;
 }
@@ -1487,7 +2156,7 @@ sendSMessage(MasterConnection self)
     msg[4] = (uint8_t) ((self->receiveCount % 128) * 2);
     msg[5] = (uint8_t) (self->receiveCount / 128);
 
-    Socket_write(self->socket, msg, 6);
+    sendControlMessage(self, msg, 6);
 }
 
 static void
@@ -1502,38 +2171,159 @@ MasterConnection_destroy(MasterConnection self)
         Semaphore_destroy(self->sentASDUsLock);
 #endif
 
+        if (self->slave->threadingMode == THREAD_PER_CONNECTION)
+            WakeupHandle_destroy(self->wakeupHandle);
+
         GLOBAL_FREEMEM(self);
     }
 }
 
 
-static void
-sendNextLowPriorityASDU(MasterConnection self)
-{
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_wait(self->sentASDUsLock);
-#endif
+#if (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0)
+static bool
+Slave_isUsingIngestQueue(Slave self);
 
-    if (isSentBufferFull(self))
-        goto exit_function;
+static bool
+Slave_drainIngestQueue(Slave self);
+#endif
 
-    MessageQueue_lock(self->lowPrioQueue);
+/**
+ * Wake up the connection when the delay of the event that is held back for packing has expired
+ */
+static void
+armPackingTimer(MasterConnection self, int sendDelay)
+{
+    if ((sendDelay > 0) && (TimerWheelTimer_isArmed(&(self->packingTimer)) == false))
+        TimerWheel_arm(self->timerWheel, &(self->packingTimer), Hal_getTimeInMs() + (uint64_t) sendDelay);
+}
+
+/**
+ * Send ASDUs from the low-priority queue until the k-buffer or the send buffer is full, the
+ * queue is empty, or maxNumber ASDUs have been sent.
+ *
+ * Returns true when ASDUs are waiting and the k-buffer is not yet full.
+ */
+static bool
+sendLowPriorityASDUs(MasterConnection self, int maxNumber)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->sentASDUsLock);
+#endif
+
+    MessageQueue_lock(self->lowPrioQueue);
 
-    uint64_t timestamp;
-    int index;
+    int sentASDUs = 0;
 
-    FrameBuffer* asdu = MessageQueue_getNextWaitingASDU(self->lowPrioQueue, &timestamp, &index);
+    while ((sentASDUs < maxNumber) && (isSentBufferFull(self) == false) && hasSendBufferSpace(self)) {
 
-    if (asdu != NULL)
-        sendASDU(self, asdu, timestamp, index);
+        uint64_t queueSeqNo;
+
+        int asduSize;
+
+        uint8_t* asdu = MessageQueue_getNextWaitingASDU(self->lowPrioQueue, &queueSeqNo, &asduSize);
+
+        if (asdu == NULL)
+            break;
+
+        sendASDU(self, asdu, asduSize, queueSeqNo);
+
+        sentASDUs++;
+    }
+
+    bool isAsduWaiting = (MessageQueue_isAsduWaiting(self->lowPrioQueue) && (isSentBufferFull(self) == false));
+
+    armPackingTimer(self, MessageQueue_getSendDelay(self->lowPrioQueue));
 
     MessageQueue_unlock(self->lowPrioQueue);
 
-exit_function:
 #if (CONFIG_SLAVE_USING_THREADS == 1)
     Semaphore_post(self->sentASDUsLock);
 #endif
+
+    return isAsduWaiting;
+}
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+/**
+ * Send events from the shared event log until the k-buffer or the send buffer is full, all
+ * events have been sent, or maxNumber events have been sent.
+ *
+ * Returns true when events are waiting and the k-buffer is not yet full.
+ */
+static bool
+sendEventsFromLog(MasterConnection self, int maxNumber)
+{
+    EventLog eventLog = &(self->slave->eventLog);
+
+    if (eventLog->buffer == NULL)
+        return false;
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->sentASDUsLock);
+#endif
+
+    EventLog_lock(eventLog);
+
+    MessageRing ring = &(eventLog->ring);
+
+    uint64_t oldestSeqNo = ring->oldestSeqNo;
+
+    /* events that have been overwritten in the log are lost */
+    if (MessageRing_isRemoved(ring, &(self->eventLogSendCursor))) {
+        DEBUG_PRINT("Event log overflow - %llu events lost\n",
+                (unsigned long long) (oldestSeqNo - self->eventLogSendCursor.seqNo));
+
+        MessageRing_getOldest(ring, &(self->eventLogSendCursor));
+    }
+
+    if (self->eventLogAckCursor < oldestSeqNo)
+        self->eventLogAckCursor = oldestSeqNo;
+
+    int sentEvents = 0;
+
+    while ((sentEvents < maxNumber) && (isSentBufferFull(self) == false) && hasSendBufferSpace(self)) {
+
+        if (MessageRing_isAtEnd(ring, &(self->eventLogSendCursor)))
+            break;
+
+        /* the event is held back to pack more events */
+        if ((eventLog->packer != NULL) &&
+                (AsduPacker_getSendDelay(eventLog->packer, ring, self->eventLogSendCursor.seqNo) > 0))
+            break;
+
+        uint64_t seqNo = self->eventLogSendCursor.seqNo;
+
+        int eventSize;
+        uint8_t* event = MessageRing_read(ring, &(self->eventLogSendCursor), &eventSize);
+
+        sendASDU(self, event, eventSize, seqNo);
+
+        sentEvents++;
+    }
+
+    if (self->eventLogSendCursor.seqNo > eventLog->sentSeqNo)
+        eventLog->sentSeqNo = self->eventLogSendCursor.seqNo;
+
+    bool isEventWaiting = ((MessageRing_isAtEnd(ring, &(self->eventLogSendCursor)) == false) && (isSentBufferFull(self) == false));
+
+    if (isEventWaiting && (eventLog->packer != NULL)) {
+        int sendDelay = AsduPacker_getSendDelay(eventLog->packer, ring, self->eventLogSendCursor.seqNo);
+
+        if (sendDelay > 0) {
+            isEventWaiting = false;
+            armPackingTimer(self, sendDelay);
+        }
+    }
+
+    EventLog_unlock(eventLog);
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->sentASDUsLock);
+#endif
+
+    return isEventWaiting;
 }
+#endif /* (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1) */
 
 static bool
 sendNextHighPriorityASDU(MasterConnection self)
@@ -1544,15 +2334,17 @@ sendNextHighPriorityASDU(MasterConnection self)
     Semaphore_wait(self->sentASDUsLock);
 #endif
 
-    if (isSentBufferFull(self))
+    if (isSentBufferFull(self) || (hasSendBufferSpace(self) == false))
         goto exit_function;
 
     HighPriorityASDUQueue_lock(self->highPrioQueue);
 
-    FrameBuffer* msg = HighPriorityASDUQueue_getNextASDU(self->highPrioQueue);
+    int asduSize;
+
+    uint8_t* asdu = HighPriorityASDUQueue_getNextASDU(self->highPrioQueue, &asduSize);
 
-    if (msg != NULL) {
-        sendASDU(self, msg, 0, -1);
+    if (asdu != NULL) {
+        sendASDU(self, asdu, asduSize, NO_QUEUE_ENTRY);
         retVal = true;
     }
 
@@ -1567,417 +2359,1487 @@ exit_function:
 }
 
 /**
- * Send all high-priority ASDUs and the last waiting ASDU from the low-priority queue.
- * Returns true if ASDUs are still waiting. This can happen when there are more ASDUs
- * in the event (low-priority) buffer, or the connection is unavailable to send the high-priority
- * ASDUs (congestion or connection lost).
+ * Pull ASDUs from the active response stream while the k-buffer has room for them.
+ * Returns the number of sent ASDUs.
+ */
+static int
+sendStreamedASDUs(MasterConnection self, int maxNumber)
+{
+    int sentASDUs = 0;
+
+    /* the ASDUs are written to the socket together with the other messages of this pass */
+    self->deferSending = true;
+
+    while ((sentASDUs < maxNumber) && (self->streamProducer != NULL) && self->isActive) {
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+        Semaphore_wait(self->sentASDUsLock);
+#endif
+
+        bool isFull = (isSentBufferFull(self) || (hasSendBufferSpace(self) == false));
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+        Semaphore_post(self->sentASDUsLock);
+#endif
+
+        if (isFull)
+            break;
+
+        ASDU asdu = self->streamProducer(self->streamParameter, self);
+
+        if (asdu == NULL) {
+
+            if (self->streamTermination != NULL) {
+                sendASDUInternal(self, self->streamTermination);
+
+                sentASDUs++;
+            }
+
+            finishResponseStream(self, true);
+        }
+        else {
+            /* when another thread filled the k-buffer in the meantime the ASDU is queued */
+            sendASDUInternal(self, asdu);
+
+            if (ASDU_isStackCreated(asdu) == false)
+                ASDU_destroy(asdu);
+
+            sentASDUs++;
+        }
+    }
+
+    self->deferSending = false;
+
+    return sentASDUs;
+}
+
+/**
+ * Send the waiting ASDUs until the k-buffer is full. High-priority ASDUs are sent first.
+ * To not delay the handling of received messages at most CONFIG_SLAVE_MAX_ASDUS_PER_PASS
+ * ASDUs are sent in one pass.
+ * Returns true if ASDUs are still waiting and can be sent immediately. This can happen when
+ * the maximum number of ASDUs per pass has been sent. When the k-buffer is full (congestion) or
+ * the connection is lost false is returned because the connection has to wait for the counterpart.
  */
 static bool
 sendWaitingASDUs(MasterConnection self)
 {
+    int budget = CONFIG_SLAVE_MAX_ASDUS_PER_PASS;
+
+    if (budget < 1)
+        budget = self->maxSentASDUs;
+
     /* send all available high priority ASDUs first */
     while (HighPriorityASDUQueue_isAsduAvailable(self->highPrioQueue)) {
 
-        if (sendNextHighPriorityASDU(self) == false)
+        if (budget == 0)
             return true;
 
+        if (sendNextHighPriorityASDU(self) == false)
+            return false;
+
         if (self->isRunning == false)
+            return false;
+
+        budget--;
+    }
+
+    if (budget == 0)
+        return true;
+
+    /* then the response stream */
+    if (self->streamProducer != NULL) {
+        budget -= sendStreamedASDUs(self, budget);
+
+        if (budget == 0)
             return true;
+
+        /* the stream is still active -> k-buffer is full */
+        if (self->streamProducer != NULL)
+            return false;
     }
 
+#if (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0)
+    /* move new ASDUs of the producers to the low-priority queue or event log */
+    if (Slave_isUsingIngestQueue(self->slave))
+        Slave_drainIngestQueue(self->slave);
+#endif
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    /* send events from the shared event log */
+    if (self->lowPrioQueue == NULL)
+        return sendEventsFromLog(self, budget);
+#endif
+
     /* send messages from low-priority queue */
-    sendNextLowPriorityASDU(self);
+    return sendLowPriorityASDUs(self, budget);
+}
 
-    if (MessageQueue_isAsduAvailable(self->lowPrioQueue))
-        return true;
-    else
-        return false;
+static void
+handleT1Timeout(void* parameter)
+{
+    MasterConnection self = (MasterConnection) parameter;
+
+    printSendBuffer(self);
+
+    DEBUG_PRINT("I message timeout\n");
+
+    /* close connection */
+    self->isRunning = false;
+}
+
+static void
+handleT2Timeout(void* parameter)
+{
+    MasterConnection self = (MasterConnection) parameter;
+
+    if (self->unconfirmedReceivedIMessages > 0) {
+        self->lastConfirmationTime = Hal_getTimeInMs();
+        self->unconfirmedReceivedIMessages = 0;
+        sendSMessage(self);
+    }
+}
+
+static void
+handlePackingTimeout(void* parameter)
+{
+    /* nothing to do - the event is sent by MasterConnection_executePeriodicTasks */
+}
+
+static void
+handleSendTimeout(void* parameter)
+{
+    MasterConnection self = (MasterConnection) parameter;
+
+    DEBUG_PRINT("Timeout for sending messages\n");
+
+    /* close connection */
+    self->isRunning = false;
+}
+
+static void
+handleT3Timeout(void* parameter)
+{
+    MasterConnection self = (MasterConnection) parameter;
+
+    if (self->outstandingTestFRConMessages > 2) {
+        DEBUG_PRINT("Timeout for TESTFR CON message\n");
+
+        /* close connection */
+        self->isRunning = false;
+    }
+    else {
+        sendControlMessage(self, TESTFR_ACT_MSG, TESTFR_ACT_MSG_SIZE);
+
+        self->outstandingTestFRConMessages++;
+        resetT3Timeout(self, Hal_getTimeInMs());
+    }
+}
+
+/**
+ * Start, restart, or stop timeout T1 according to the oldest unconfirmed ASDU in the k-buffer
+ */
+static void
+updateT1Timeout(MasterConnection self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->sentASDUsLock);
+#endif
+
+    if (self->oldestSentASDU == -1)
+        TimerWheel_cancel(self->timerWheel, &(self->t1Timer));
+    else {
+        uint64_t expiryTime = self->sentASDUs[self->oldestSentASDU].sentTime +
+                (uint64_t) (self->slave->parameters.t1 * 1000);
+
+        if ((TimerWheelTimer_isArmed(&(self->t1Timer)) == false) ||
+                (TimerWheelTimer_getExpiryTime(&(self->t1Timer)) != expiryTime))
+            TimerWheel_arm(self->timerWheel, &(self->t1Timer), expiryTime);
+    }
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->sentASDUsLock);
+#endif
+}
+
+static void
+T104Slave_removeConnection(Slave self, MasterConnection connection)
+{
+#if (CONFIG_SLAVE_USING_THREADS)
+    Semaphore_wait(self->openConnectionsLock);
+#endif
+
+    self->openConnections--;
+    LinkedList_remove(self->masterConnections, (void*) connection);
+
+#if (CONFIG_SLAVE_USING_THREADS)
+    Semaphore_post(self->openConnectionsLock);
+#endif
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    /* the events that are only waiting for this connection are not required anymore */
+    if ((self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) && (self->eventLog.buffer != NULL)) {
+        Slave_removeEventLogReader(self, connection);
+
+        Slave_checkWatermarks(self);
+    }
+#endif
+
+    MasterConnection_destroy(connection);
 }
 
+/**
+ * Check if the send buffer can take the responses to the next received message
+ */
 static bool
-handleTimeouts(MasterConnection self)
+hasResponseSpace(MasterConnection self)
 {
-    uint64_t currentTime = Hal_getTimeInMs();
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->sentASDUsLock);
+#endif
 
-    bool timeoutsOk = true;
+    if ((self->sendBufferSize + CONTROL_MESSAGES_RESERVE) > CONFIG_SLAVE_SEND_BUFFER_SIZE)
+        flushSendBuffer(self);
 
-    /* check T3 timeout */
-    if (currentTime > self->nextT3Timeout) {
+    bool hasSpace = ((self->sendBufferSize + CONTROL_MESSAGES_RESERVE) <= CONFIG_SLAVE_SEND_BUFFER_SIZE);
 
-        if (self->outstandingTestFRConMessages > 2) {
-            DEBUG_PRINT("Timeout for TESTFR CON message\n");
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->sentASDUsLock);
+#endif
 
-            /* close connection */
-            timeoutsOk = false;
-        }
-        else {
-            if (Socket_write(self->socket, TESTFR_ACT_MSG, TESTFR_ACT_MSG_SIZE) == -1)
-                self->isRunning = false;
+    return hasSpace;
+}
+
+/**
+ * Handle the complete messages in the receive buffer. When the master doesn't take the
+ * responses (EVENT_LOOP_THREAD mode) the remaining messages are handled after the socket
+ * has taken the buffered messages.
+ */
+static void
+MasterConnection_handleReceivedMessages(MasterConnection self)
+{
+    uint8_t* msg;
+    int msgSize;
+
+    /* responses are sent together by MasterConnection_executePeriodicTasks */
+    self->deferSending = true;
+
+    while (self->isRunning && hasResponseSpace(self)) {
+
+        msgSize = T104ReceiveBuffer_getNextMessage(&(self->recvBuffer), &msg);
 
-            self->outstandingTestFRConMessages++;
-            resetT3Timeout(self);
+        if (msgSize == 0)
+            break;
+
+        if (msgSize == -1) {
+            DEBUG_PRINT("Connection: framing error\n");
+            self->isRunning = false;
+            break;
         }
-    }
 
-    /* check timeout for others station I messages */
-    if (self->unconfirmedReceivedIMessages > 0) {
-        if ((currentTime - self->lastConfirmationTime) >= (uint64_t) (self->slave->parameters.t2 * 1000)) {
-            self->lastConfirmationTime = currentTime;
+        DEBUG_PRINT("Connection: rcvd msg(%i bytes)\n", msgSize);
+
+        if (handleMessage(self, msg, msgSize) == false)
+            self->isRunning = false;
+
+        if (self->unconfirmedReceivedIMessages >= self->slave->parameters.w) {
+
+            self->lastConfirmationTime = Hal_getTimeInMs();
+
             self->unconfirmedReceivedIMessages = 0;
+
+            TimerWheel_cancel(self->timerWheel, &(self->t2Timer));
+
             sendSMessage(self);
         }
     }
 
-    /* check if counterpart confirmed I message */
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_wait(self->sentASDUsLock);
-#endif
+    self->deferSending = false;
+}
 
-    if (self->oldestSentASDU != -1) {
-        if ((currentTime - self->sentASDUs[self->oldestSentASDU].sentTime) >= (uint64_t) (self->slave->parameters.t1 * 1000)) {
-            timeoutsOk = false;
+static void
+MasterConnection_handleTcpConnection(MasterConnection self)
+{
+    int bytesRec = T104ReceiveBuffer_fill(&(self->recvBuffer), self->socket);
+
+    if (bytesRec == -1) {
+        DEBUG_PRINT("Error reading from socket\n");
+        self->isRunning = false;
+    }
+    else
+        MasterConnection_handleReceivedMessages(self);
+}
 
-            printSendBuffer(self);
+/**
+ * Send waiting ASDUs and update timeout T1. All messages created in the current pass
+ * of the connection handling are written to the socket at once. The other protocol
+ * timeouts are handled by the timer wheel.
+ *
+ * Returns true if ASDUs are still waiting and can be sent without waiting for the counterpart
+ * or for the socket.
+ */
+static bool
+MasterConnection_executePeriodicTasks(MasterConnection self)
+{
+    bool isAsduWaiting = false;
+
+    if (self->isRunning)
+        if (self->isActive)
+            isAsduWaiting = sendWaitingASDUs(self);
+
+    if (self->isRunning) {
+        updateT1Timeout(self);
+
+        if (MasterConnection_flush(self))
+            isAsduWaiting = true;
+        else if (MasterConnection_isSendBlocked(self))
+            isAsduWaiting = false;
+    }
+
+    return isAsduWaiting;
+}
+
+static void
+MasterConnection_release(MasterConnection self)
+{
+    self->isRunning = false;
+
+    if (self->timerWheel != NULL) {
+        TimerWheel_cancel(self->timerWheel, &(self->t1Timer));
+        TimerWheel_cancel(self->timerWheel, &(self->t2Timer));
+        TimerWheel_cancel(self->timerWheel, &(self->t3Timer));
+        TimerWheel_cancel(self->timerWheel, &(self->packingTimer));
+        TimerWheel_cancel(self->timerWheel, &(self->sendTimer));
+    }
+
+    if (self->streamProducer != NULL)
+        finishResponseStream(self, false);
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    if (self->slave->serverMode == CONNECTION_IS_REDUNDANCY_GROUP)
+        HighPriorityASDUQueue_destroy(self->highPrioQueue);
+#endif
+
+    T104Slave_removeConnection(self->slave, self);
+}
+
+static void*
+connectionHandlingThread(void* parameter)
+{
+    MasterConnection self = (MasterConnection) parameter;
+
+    TimerWheel timerWheel = TimerWheel_create(Hal_getTimeInMs());
+
+    self->timerWheel = timerWheel;
+
+    /* the connection itself is used to identify the socket events */
+    PollSet pollSet = PollSet_create();
+
+    bool useWakeupHandle = false;
+
+    if ((timerWheel != NULL) && (pollSet != NULL)) {
+
+        if (PollSet_addSocket(pollSet, self->socket, (void*) self)) {
+            self->isRunning = true;
+
+            resetT3Timeout(self, Hal_getTimeInMs());
+        }
+
+        if (self->wakeupHandle != NULL)
+            useWakeupHandle = PollSet_addWakeupHandle(pollSet, self->wakeupHandle, (void*) self->wakeupHandle);
+    }
+
+    bool isAsduWaiting = false;
+
+    while (self->isRunning) {
+
+        int socketTimeout;
+
+        /*
+         * When an ASDU can be sent only have a look to see if a client request
+         * was received. Otherwise wait for a client message, a new event, or the next
+         * timeout (poll for new events when the wakeup handle is not supported by the platform).
+         */
+        if (isAsduWaiting)
+            socketTimeout = 0;
+        else if (useWakeupHandle)
+            socketTimeout = TimerWheel_getTimeout(timerWheel, Hal_getTimeInMs(), 1000);
+        else
+            socketTimeout = TimerWheel_getTimeout(timerWheel, Hal_getTimeInMs(), 100);
+
+        int readyHandles = PollSet_waitReady(pollSet, socketTimeout);
+
+        int i;
+
+        for (i = 0; i < readyHandles; i++) {
+
+            void* handle = PollSet_getReadyParameter(pollSet, i);
+
+            if (handle == (void*) self)
+                MasterConnection_handleTcpConnection(self);
+            else if (handle != NULL)
+                WakeupHandle_reset(self->wakeupHandle);
+        }
+
+        TimerWheel_advance(timerWheel, Hal_getTimeInMs());
+
+        isAsduWaiting = MasterConnection_executePeriodicTasks(self);
+    }
+
+    DEBUG_PRINT("Connection closed\n");
+
+    if (pollSet != NULL) {
+        PollSet_removeSocket(pollSet, self->socket);
+        PollSet_destroy(pollSet);
+    }
+
+    MasterConnection_release(self);
+
+    if (timerWheel != NULL)
+        TimerWheel_destroy(timerWheel);
+
+    return NULL;
+}
+
+static MasterConnection
+MasterConnection_create(Slave slave, Socket socket, MessageQueue lowPrioQueue, HighPriorityASDUQueue highPrioQueue)
+{
+    MasterConnection self = (MasterConnection) GLOBAL_MALLOC(sizeof(struct sMasterConnection));
+
+    if (self != NULL) {
+
+        self->slave = slave;
+        self->socket = socket;
+        self->isActive = false;
+        self->isRunning = false;
+        self->receiveCount = 0;
+        self->sendCount = 0;
+
+        self->unconfirmedReceivedIMessages = 0;
+        self->lastConfirmationTime = UINT64_MAX;
+
+        self->firstIMessageReceived = false;
+
+        self->maxSentASDUs = slave->parameters.k;
+        self->oldestSentASDU = -1;
+        self->newestSentASDU = -1;
+        self->sentASDUs = (SentASDUSlave*) GLOBAL_MALLOC(sizeof(SentASDUSlave) * self->maxSentASDUs);
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+        self->sentASDUsLock = Semaphore_create(1);
+#endif
+
+        self->lowPrioQueue = lowPrioQueue;
+        self->highPrioQueue = highPrioQueue;
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+        self->isEventLogReader = false;
+#endif
+
+        self->streamProducer = NULL;
+        self->streamFinishedHandler = NULL;
+        self->streamParameter = NULL;
+        self->streamTermination = NULL;
+
+        self->outstandingTestFRConMessages = 0;
+
+        self->timerWheel = NULL;
+        TimerWheelTimer_initialize(&(self->t1Timer), handleT1Timeout, self);
+        TimerWheelTimer_initialize(&(self->t2Timer), handleT2Timeout, self);
+        TimerWheelTimer_initialize(&(self->t3Timer), handleT3Timeout, self);
+        TimerWheelTimer_initialize(&(self->packingTimer), handlePackingTimeout, self);
+        TimerWheelTimer_initialize(&(self->sendTimer), handleSendTimeout, self);
+
+        self->sendBufferSize = 0;
+        self->deferSending = false;
+        self->isSendBlocked = false;
+        self->isWaitingForWritable = false;
+
+        if (slave->threadingMode == THREAD_PER_CONNECTION)
+            self->wakeupHandle = WakeupHandle_create();
+        else
+            self->wakeupHandle = NULL;
+
+        T104ReceiveBuffer_initialize(&(self->recvBuffer));
+    }
+
+    return self;
+}
+
+void
+MasterConnection_close(MasterConnection self)
+{
+    self->isRunning = false;
+
+    WakeupHandle_signal(self->wakeupHandle);
+}
+
+void
+MasterConnection_deactivate(MasterConnection self)
+{
+    self->isActive = false;
+}
+
+
+bool
+MasterConnection_sendASDU(MasterConnection self, ASDU asdu)
+{
+    bool retVal = sendASDUInternal(self, asdu);
+
+    if (ASDU_isStackCreated(asdu) == false)
+        ASDU_destroy(asdu);
+
+    return retVal;
+}
+
+bool
+MasterConnection_sendACT_CON(MasterConnection self, ASDU asdu, bool negative)
+{
+    ASDU_setCOT(asdu, ACTIVATION_CON);
+    ASDU_setNegative(asdu, negative);
+
+    return MasterConnection_sendASDU(self, asdu);
+}
+
+bool
+MasterConnection_sendACT_TERM(MasterConnection self, ASDU asdu)
+{
+    ASDU_setCOT(asdu, ACTIVATION_TERMINATION);
+    ASDU_setNegative(asdu, false);
+
+    return MasterConnection_sendASDU(self, asdu);
+}
+
+bool
+MasterConnection_startResponseStream(MasterConnection self, ASDU request, ResponseProducer producer,
+        ResponseStreamFinishedHandler finishedHandler, void* parameter)
+{
+    if ((self->streamProducer != NULL) || (self->isActive == false) || (producer == NULL))
+        return false;
+
+    self->streamTermination = NULL;
+
+    if (request != NULL) {
+
+        if (ASDU_getEncodedSize(request) > IEC60870_5_104_MAX_ASDU_LENGTH)
+            return false;
+
+        uint8_t buffer[IEC60870_5_104_MAX_ASDU_LENGTH];
+
+        struct sBufferFrame bufferFrame;
+
+        Frame frame = BufferFrame_initialize(&bufferFrame, buffer, 0);
+        ASDU_encode(request, frame);
+
+        /* copy of the request (the request is only valid during the callback) */
+        ASDU termination = ASDU_initializeStaticFromBuffer(&(self->streamTerminationMemory),
+                (ConnectionParameters) &(self->slave->parameters), buffer, Frame_getMsgSize(frame));
+
+        if (termination == NULL)
+            return false;
+
+        ASDU_setCOT(termination, ACTIVATION_TERMINATION);
+        ASDU_setNegative(termination, false);
+
+        self->streamTermination = termination;
+    }
+
+    self->streamProducer = producer;
+    self->streamFinishedHandler = finishedHandler;
+    self->streamParameter = parameter;
+
+    /* the connection pulls the first ASDUs when the current pass is finished */
+    if (self->deferSending == false)
+        WakeupHandle_signal(self->wakeupHandle);
+
+    return true;
+}
+
+bool
+MasterConnection_stopResponseStream(MasterConnection self)
+{
+    if (self->streamProducer == NULL)
+        return false;
+
+    finishResponseStream(self, false);
+
+    return true;
+}
+
+static ServerSocket
+createServerSocket(Slave self)
+{
+    ServerSocket serverSocket;
+
+    if (self->localAddress)
+        serverSocket = TcpServerSocket_create(self->localAddress, self->tcpPort);
+    else
+        serverSocket = TcpServerSocket_create("0.0.0.0", self->tcpPort);
+
+    if (serverSocket == NULL)
+        DEBUG_PRINT("Cannot create server socket\n");
+
+    return serverSocket;
+}
+
+/**
+ * Check if a new client connection can be accepted and create the MasterConnection object.
+ *
+ * Returns NULL (and closes the socket) when the connection is not accepted.
+ */
+static MasterConnection
+T104Slave_acceptConnection(Slave self, Socket newSocket)
+{
+    bool acceptConnection = true;
+
+    /* check if maximum number of open connections is reached */
+    if (self->maxOpenConnections > 0) {
+        if (self->openConnections >= self->maxOpenConnections)
+            acceptConnection = false;
+    }
+
+    if (acceptConnection && (self->connectionRequestHandler != NULL)) {
+        char ipAddress[60];
+
+        Socket_getPeerAddressStatic(newSocket, ipAddress);
+
+        /* remove TCP port part */
+        char* separator = strchr(ipAddress, ':');
+        if (separator != NULL)
+            *separator = 0;
+
+        acceptConnection = self->connectionRequestHandler(self->connectionRequestHandlerParameter,
+                ipAddress);
+    }
+
+    if (acceptConnection == false) {
+        Socket_destroy(newSocket);
+        return NULL;
+    }
+
+    MessageQueue lowPrioQueue = NULL;
+    HighPriorityASDUQueue highPrioQueue = NULL;
+
+#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
+    if (self->serverMode == SINGLE_REDUNDANCY_GROUP) {
+        lowPrioQueue = self->asduQueue;
+        highPrioQueue = self->connectionAsduQueue;
+    }
+#endif
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    if (self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) {
+        /* events are read from the shared event log */
+        highPrioQueue = HighPriorityASDUQueue_create(self->maxHighPrioQueueSize);
+    }
+#endif
+
+    MasterConnection connection =
+            MasterConnection_create(self, newSocket, lowPrioQueue, highPrioQueue);
+
+#if (CONFIG_SLAVE_USING_THREADS)
+    Semaphore_wait(self->openConnectionsLock);
+#endif
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) && (self->eventLog.buffer != NULL)) {
+        /* the connection keeps the events until it has confirmed them (also before STARTDT) */
+        EventLog_lock(&(self->eventLog));
+
+        EventLog_addReader(&(self->eventLog), &(connection->eventLogSendCursor), &(connection->eventLogAckCursor));
+        connection->isEventLogReader = true;
+
+        EventLog_unlock(&(self->eventLog));
+    }
+#endif
+
+    self->openConnections++;
+    LinkedList_add(self->masterConnections, connection);
+
+#if (CONFIG_SLAVE_USING_THREADS)
+    Semaphore_post(self->openConnectionsLock);
+#endif
+
+    return connection;
+}
+
+static void*
+serverThread (void* parameter)
+{
+    Slave self = (Slave) parameter;
+
+    ServerSocket serverSocket = createServerSocket(self);
+
+    if (serverSocket == NULL) {
+        self->isStarting = false;
+        goto exit_function;
+    }
+
+    ServerSocket_listen(serverSocket);
+
+    self->isRunning = true;
+    self->isStarting = false;
+
+    /* wait for new connections (fall back to polling when the PollSet is not available) */
+    PollSet pollSet = PollSet_create();
+
+    if (pollSet != NULL) {
+        if (PollSet_addServerSocket(pollSet, serverSocket, (void*) serverSocket) == false) {
+            PollSet_destroy(pollSet);
+            pollSet = NULL;
+        }
+    }
+
+    while (self->stopRunning == false) {
+
+        if (pollSet != NULL) {
+            if (PollSet_waitReady(pollSet, 100) < 1)
+                continue;
+        }
+
+        Socket newSocket = ServerSocket_accept(serverSocket);
+
+        if (newSocket != NULL) {
+
+            MasterConnection connection = T104Slave_acceptConnection(self, newSocket);
+
+            if (connection != NULL) {
+                Thread newThread =
+                       Thread_create((ThreadExecutionFunction) connectionHandlingThread,
+                               (void*) connection, true);
+
+                Thread_start(newThread);
+            }
+        }
+        else if (pollSet == NULL)
+            Thread_sleep(10);
+    }
+
+    if (pollSet != NULL)
+        PollSet_destroy(pollSet);
+
+    if (serverSocket)
+        Socket_destroy((Socket) serverSocket);
+
+    self->isRunning = false;
+    self->stopRunning = false;
+
+exit_function:
+    return NULL;
+}
+
+/***************************************************
+ * EventLoop (EVENT_LOOP_THREAD mode)
+ ***************************************************/
+
+struct sEventLoop {
+    Slave slave;
+    Thread thread;
+    ServerSocket serverSocket;
+    PollSet pollSet;
+    WakeupHandle wakeupHandle; /**< signaled when new events are available */
+    TimerWheel timerWheel; /**< protocol timeouts of all connections of this event loop */
+
+    LinkedList connections; /**< connections owned by this event loop - only accessed by the event loop thread */
+};
+
+static bool
+EventLoop_initialize(EventLoop self, Slave slave, ServerSocket serverSocket)
+{
+    self->slave = slave;
+    self->thread = NULL;
+    self->serverSocket = serverSocket;
+    self->connections = LinkedList_create();
+    self->pollSet = PollSet_create();
+    self->wakeupHandle = WakeupHandle_create();
+    self->timerWheel = TimerWheel_create(Hal_getTimeInMs());
+
+    return ((self->pollSet != NULL) && (self->timerWheel != NULL));
+}
+
+static void
+EventLoop_finalize(EventLoop self)
+{
+    if (self->pollSet != NULL)
+        PollSet_destroy(self->pollSet);
+
+    WakeupHandle_destroy(self->wakeupHandle);
+
+    if (self->timerWheel != NULL)
+        TimerWheel_destroy(self->timerWheel);
+
+    if (self->serverSocket != NULL)
+        Socket_destroy((Socket) self->serverSocket);
+
+    LinkedList_destroyStatic(self->connections);
+}
+
+static void
+EventLoop_acceptConnections(EventLoop self)
+{
+    Socket newSocket;
+
+    while ((newSocket = ServerSocket_accept(self->serverSocket)) != NULL) {
+
+        MasterConnection connection = T104Slave_acceptConnection(self->slave, newSocket);
+
+        if (connection != NULL) {
+            connection->isRunning = true;
+
+            connection->timerWheel = self->timerWheel;
+            connection->wakeupHandle = self->wakeupHandle;
+
+            /* the event loop must not wait for a single connection */
+            Socket_setNonBlocking(newSocket);
+
+            resetT3Timeout(connection, Hal_getTimeInMs());
+
+            if (PollSet_addSocket(self->pollSet, newSocket, (void*) connection))
+                LinkedList_add(self->connections, connection);
+            else
+                MasterConnection_release(connection);
+        }
+    }
+}
+
+/**
+ * Wait until the socket is writable while it cannot take the buffered messages. Reading
+ * is suspended in the meantime so that the master cannot create more responses than the
+ * connection can send. When the master doesn't take the messages within timeout T1 the
+ * connection is closed.
+ *
+ * Returns true when messages were held back and the connection can send again.
+ */
+static bool
+EventLoop_updateSendState(EventLoop self, MasterConnection connection)
+{
+    bool isSendBlocked = MasterConnection_isSendBlocked(connection);
+
+    if (isSendBlocked == connection->isWaitingForWritable)
+        return false;
+
+    if (PollSet_setWaitForWritable(self->pollSet, connection->socket, (void*) connection, isSendBlocked) == false) {
+        connection->isRunning = false;
+        return false;
+    }
+
+    connection->isWaitingForWritable = isSendBlocked;
+
+    if (isSendBlocked) {
+        TimerWheel_arm(self->timerWheel, &(connection->sendTimer),
+                Hal_getTimeInMs() + (uint64_t) (self->slave->parameters.t1 * 1000));
+
+        return false;
+    }
+
+    TimerWheel_cancel(self->timerWheel, &(connection->sendTimer));
+
+    /* handle the messages that were received while the send buffer was blocked */
+    MasterConnection_handleReceivedMessages(connection);
+
+    return true;
+}
+
+/**
+ * Event loop thread. Handles the server socket, the client connections accepted by
+ * the server socket and their timeouts.
+ */
+static void*
+eventLoopThread(void* parameter)
+{
+    EventLoop self = (EventLoop) parameter;
+    Slave slave = self->slave;
+
+    /* the server socket itself is used to identify the server socket events */
+    PollSet_addServerSocket(self->pollSet, self->serverSocket, (void*) self->serverSocket);
+
+    if (self->wakeupHandle != NULL)
+        PollSet_addWakeupHandle(self->pollSet, self->wakeupHandle, (void*) self->wakeupHandle);
+
+    bool isAsduWaiting = false;
+
+    while (slave->stopRunning == false) {
+
+        int socketTimeout;
+
+        if (isAsduWaiting)
+            socketTimeout = 0;
+        else if (self->wakeupHandle != NULL)
+            socketTimeout = TimerWheel_getTimeout(self->timerWheel, Hal_getTimeInMs(), 1000);
+        else
+            socketTimeout = TimerWheel_getTimeout(self->timerWheel, Hal_getTimeInMs(), 100);
+
+        int readyHandles = PollSet_waitReady(self->pollSet, socketTimeout);
+
+        int i;
+
+        for (i = 0; i < readyHandles; i++) {
+
+            void* handle = PollSet_getReadyParameter(self->pollSet, i);
+
+            if (handle == (void*) self->serverSocket)
+                EventLoop_acceptConnections(self);
+            else if (handle == (void*) self->wakeupHandle)
+                WakeupHandle_reset(self->wakeupHandle);
+            else if (handle != NULL) {
+                MasterConnection connection = (MasterConnection) handle;
+
+                /* a writable socket takes the buffered messages in MasterConnection_executePeriodicTasks */
+                if (connection->isWaitingForWritable == false)
+                    MasterConnection_handleTcpConnection(connection);
+            }
+        }
+
+        TimerWheel_advance(self->timerWheel, Hal_getTimeInMs());
+
+        isAsduWaiting = false;
+
+        LinkedList element = LinkedList_getNext(self->connections);
+
+        while (element != NULL) {
+            MasterConnection connection = (MasterConnection) LinkedList_getData(element);
+
+            element = LinkedList_getNext(element);
+
+            if (MasterConnection_executePeriodicTasks(connection))
+                isAsduWaiting = true;
+
+            if (connection->isRunning && EventLoop_updateSendState(self, connection))
+                isAsduWaiting = true;
+
+            if (connection->isRunning == false) {
+                DEBUG_PRINT("Connection closed\n");
+
+                PollSet_removeSocket(self->pollSet, connection->socket);
+                LinkedList_remove(self->connections, connection);
+                MasterConnection_release(connection);
+            }
+        }
+    }
+
+    /* close all remaining connections */
+    LinkedList element;
+
+    for (element = LinkedList_getNext(self->connections);
+         element != NULL;
+         element = LinkedList_getNext(element))
+    {
+        MasterConnection connection = (MasterConnection) LinkedList_getData(element);
+
+        PollSet_removeSocket(self->pollSet, connection->socket);
+        MasterConnection_release(connection);
+    }
+
+    return NULL;
+}
+
+/**
+ * Create the server sockets and start the event loop threads. When more than one
+ * event loop is configured every event loop gets its own server socket bound to the
+ * same port.
+ */
+static void
+Slave_startEventLoops(Slave self)
+{
+    int numberOfEventLoops = self->numberOfEventLoops;
+
+    EventLoop eventLoops = (EventLoop) GLOBAL_CALLOC(numberOfEventLoops, sizeof(struct sEventLoop));
+
+    if (eventLoops == NULL)
+        return;
+
+    const char* localAddress = self->localAddress;
+
+    if (localAddress == NULL)
+        localAddress = "0.0.0.0";
+
+    int i;
+
+    for (i = 0; i < numberOfEventLoops; i++) {
+        ServerSocket serverSocket;
+
+        if (numberOfEventLoops > 1) {
+            serverSocket = TcpServerSocket_createShared(localAddress, self->tcpPort);
+
+            /* platform doesn't support shared server sockets -> only use a single event loop */
+            if ((serverSocket == NULL) && (i == 0)) {
+                DEBUG_PRINT("Shared server sockets not supported - use single event loop\n");
+                numberOfEventLoops = 1;
+                serverSocket = createServerSocket(self);
+            }
+        }
+        else
+            serverSocket = createServerSocket(self);
+
+        if (serverSocket == NULL)
+            break;
+
+        ServerSocket_listen(serverSocket);
+
+        if (EventLoop_initialize(&(eventLoops[i]), self, serverSocket) == false) {
+            EventLoop_finalize(&(eventLoops[i]));
+            break;
+        }
+    }
+
+    if (i == 0) {
+        GLOBAL_FREEMEM(eventLoops);
+        return;
+    }
+
+    /* from now on producers can signal the event loops (see Slave_wakeupConnections) */
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->openConnectionsLock);
+#endif
+
+    self->eventLoops = eventLoops;
+    self->runningEventLoops = i;
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->openConnectionsLock);
+#endif
+
+    self->isRunning = true;
+
+    for (i = 0; i < self->runningEventLoops; i++) {
+        EventLoop eventLoop = &(eventLoops[i]);
+
+        eventLoop->thread = Thread_create(eventLoopThread, (void*) eventLoop, false);
+
+        Thread_start(eventLoop->thread);
+
+        if (self->eventLoopFirstCpu >= 0)
+            Thread_setCpuAffinity(eventLoop->thread, self->eventLoopFirstCpu + i);
+    }
+}
+
+static void
+Slave_stopEventLoops(Slave self)
+{
+    /* producers must not signal the event loops while they are destroyed (see Slave_wakeupConnections) */
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->openConnectionsLock);
+#endif
+
+    EventLoop eventLoops = self->eventLoops;
+    int runningEventLoops = self->runningEventLoops;
+
+    self->eventLoops = NULL;
+    self->runningEventLoops = 0;
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->openConnectionsLock);
+#endif
+
+    self->stopRunning = true;
+
+    int i;
+
+    for (i = 0; i < runningEventLoops; i++)
+        WakeupHandle_signal(eventLoops[i].wakeupHandle);
+
+    for (i = 0; i < runningEventLoops; i++) {
+        Thread_destroy(eventLoops[i].thread);
+        EventLoop_finalize(&(eventLoops[i]));
+    }
+
+    GLOBAL_FREEMEM(eventLoops);
+
+    self->isRunning = false;
+    self->stopRunning = false;
+}
+
+/**
+ * Inform all connections (or event loops) about a new event in the shared queue
+ */
+static void
+Slave_wakeupConnections(Slave self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->openConnectionsLock);
+#endif
+
+    if (self->threadingMode == EVENT_LOOP_THREAD) {
+        int i;
+
+        /* the event loops are not stopped while the lock is held */
+        for (i = 0; i < self->runningEventLoops; i++)
+            WakeupHandle_signal(self->eventLoops[i].wakeupHandle);
+    }
+    else {
+        LinkedList element;
+
+        for (element = LinkedList_getNext(self->masterConnections);
+             element != NULL;
+             element = LinkedList_getNext(element))
+        {
+            MasterConnection connection = (MasterConnection) LinkedList_getData(element);
+
+            WakeupHandle_signal(connection->wakeupHandle);
+        }
+    }
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->openConnectionsLock);
+#endif
+}
+
+int
+Slave_getQueueFillLevel(Slave self)
+{
+#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == SINGLE_REDUNDANCY_GROUP) && (self->asduQueue != NULL))
+        return MessageQueue_getFillLevel(self->asduQueue);
+#endif
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) && (self->eventLog.buffer != NULL))
+        return EventLog_getFillLevel(&(self->eventLog));
+#endif
+
+    return 0;
+}
+
+#if (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0)
+
+/**
+ * Check if new ASDUs are added to the ingest queue. The persistent message queue is
+ * updated directly so that an ASDU is stored in the file when Slave_enqueueASDU returns.
+ * The ingest queue is only used when the event queue accepts all ASDUs (the result is
+ * not known when Slave_enqueueASDU returns).
+ */
+static bool
+Slave_isUsingIngestQueue(Slave self)
+{
+    if (self->ingestQueue == NULL)
+        return false;
 
-            DEBUG_PRINT("I message timeout for %i seqNo: %i\n", self->oldestSentASDU,
-                    self->sentASDUs[self->oldestSentASDU].seqNo);
-        }
-    }
+    if ((self->overflowPolicy != QUEUE_OVERFLOW_DROP_OLDEST) && (self->overflowPolicy != QUEUE_OVERFLOW_SPILL))
+        return false;
 
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-    Semaphore_post(self->sentASDUsLock);
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+    if (self->eventQueueFileName != NULL)
+        return false;
 #endif
 
-    return timeoutsOk;
+    return true;
 }
 
 static void
-T104Slave_removeConnection(Slave self, MasterConnection connection)
+Slave_lockIngestConsumer(Slave self)
 {
-#if (CONFIG_SLAVE_USING_THREADS)
-    Semaphore_wait(self->openConnectionsLock);
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_wait(self->ingestConsumerLock);
 #endif
+}
 
-    self->openConnections--;
-    LinkedList_remove(self->masterConnections, (void*) connection);
-
-#if (CONFIG_SLAVE_USING_THREADS)
-    Semaphore_post(self->openConnectionsLock);
+static void
+Slave_unlockIngestConsumer(Slave self)
+{
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_post(self->ingestConsumerLock);
 #endif
-
-    MasterConnection_destroy(connection);
 }
 
-static void*
-connectionHandlingThread(void* parameter)
+/**
+ * Move the ASDUs from the ingest queue to the low-priority queue or event log and inform
+ * the connections. The producers already returned, so when ASDUs are removed (or spilled)
+ * or cannot be added this is reported by the next call of Slave_enqueueASDU.
+ *
+ * Returns false when the queue (or log) is not yet created.
+ */
+static bool
+Slave_drainIngestQueue(Slave self)
 {
-    MasterConnection self = (MasterConnection) parameter;
+    /* producers that add ASDUs from now on have to inform the connections again */
+    Atomic_exchange(&(self->ingestWakeupPending), 0);
 
-    uint8_t buffer[260];
+    if (IngestQueue_isEmpty(self->ingestQueue))
+        return true;
 
-    self->isRunning = true;
+    int drainedAsdus = 0;
+    bool eventsRemoved = false;
+    bool isQueueCreated = false;
 
-    resetT3Timeout(self);
+    IngestQueueSlot slot;
 
-    HandleSet handleSet = Handleset_new();
+    Slave_lockIngestConsumer(self);
 
-    bool isAsduWaiting = false;
+#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == SINGLE_REDUNDANCY_GROUP) && (self->asduQueue != NULL)) {
 
-    while (self->isRunning) {
+        isQueueCreated = true;
 
-        Handleset_reset(handleSet);
-        Handleset_addSocket(handleSet, self->socket);
+        MessageQueue_lock(self->asduQueue);
 
-        int socketTimeout;
+        while ((slot = IngestQueue_peek(self->ingestQueue)) != NULL) {
 
-        /*
-         * When an ASDU is waiting only have a short look to see if a client request
-         * was received. Otherwise wait to save CPU time.
-         */
-        if (isAsduWaiting)
-            socketTimeout = 1;
-        else
-            socketTimeout = 100; /* TODO replace by configurable parameter */
+            if (MessageQueue_enqueueEncodedASDU(self->asduQueue, slot->msg, slot->msgSize) != ENQUEUE_OK)
+                eventsRemoved = true;
 
-        if (Handleset_waitReady(handleSet, socketTimeout)) {
+            IngestQueue_release(self->ingestQueue, slot);
 
-            int bytesRec = receiveMessage(self->socket, buffer);
+            drainedAsdus++;
+        }
 
-            if (bytesRec == -1) {
-                DEBUG_PRINT("Error reading from socket\n");
-                break;
-            }
+        MessageQueue_unlock(self->asduQueue);
+    }
+#endif /* (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1) */
 
-            if (bytesRec > 0) {
-                DEBUG_PRINT("Connection: rcvd msg(%i bytes)\n", bytesRec);
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) && (self->eventLog.buffer != NULL)) {
 
-                if (handleMessage(self, buffer, bytesRec) == false)
-                    self->isRunning = false;
+        EventLog eventLog = &(self->eventLog);
 
-                if (self->unconfirmedReceivedIMessages >= self->slave->parameters.w) {
+        isQueueCreated = true;
 
-                    self->lastConfirmationTime = Hal_getTimeInMs();
+        EventLog_lock(eventLog);
 
-                    self->unconfirmedReceivedIMessages = 0;
+        while ((slot = IngestQueue_peek(self->ingestQueue)) != NULL) {
 
-                    sendSMessage(self);
-                }
+            /* events that are added while no client is connected are not stored */
+            if (self->openConnections > 0) {
+                if (EventLog_addEncoded(eventLog, slot->msg, slot->msgSize) != ENQUEUE_OK)
+                    eventsRemoved = true;
             }
-        }
 
-        if (handleTimeouts(self) == false)
-            self->isRunning = false;
+            IngestQueue_release(self->ingestQueue, slot);
+
+            drainedAsdus++;
+        }
 
-        if (self->isRunning)
-            if (self->isActive)
-                isAsduWaiting = sendWaitingASDUs(self);
+        EventLog_unlock(eventLog);
     }
+#endif /* (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1) */
 
-    DEBUG_PRINT("Connection closed\n");
+    Slave_unlockIngestConsumer(self);
 
-    Handleset_destroy(handleSet);
+    if (eventsRemoved)
+        Atomic_exchange(&(self->ingestEventsRemoved), 1);
 
-    self->isRunning = false;
+    if (drainedAsdus > 0) {
+        Slave_wakeupConnections(self);
 
-#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
-    if (self->slave->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) {
-        MessageQueue_destroy(self->lowPrioQueue);
-        HighPriorityASDUQueue_destroy(self->highPrioQueue);
+        Slave_checkWatermarks(self);
     }
-#endif
-
-    T104Slave_removeConnection(self->slave, self);
 
-    return NULL;
+    return isQueueCreated;
 }
 
-static MasterConnection
-MasterConnection_create(Slave slave, Socket socket, MessageQueue lowPrioQueue, HighPriorityASDUQueue highPrioQueue)
+/**
+ * Apply the overflow policy to the full ingest queue when the ASDUs cannot be moved
+ * because the queue (or log) is not yet created: the oldest ASDU is removed (or spilled).
+ */
+static void
+Slave_removeOldestIngestedASDU(Slave self)
 {
-    MasterConnection self = (MasterConnection) GLOBAL_MALLOC(sizeof(struct sMasterConnection));
+    Slave_lockIngestConsumer(self);
 
-    if (self != NULL) {
+    IngestQueueSlot slot = IngestQueue_peek(self->ingestQueue);
 
-        self->slave = slave;
-        self->socket = socket;
-        self->isActive = false;
-        self->isRunning = false;
-        self->receiveCount = 0;
-        self->sendCount = 0;
+    if (slot != NULL) {
+        if ((self->overflowPolicy == QUEUE_OVERFLOW_SPILL) && (self->spillHandler != NULL))
+            self->spillHandler(self->spillHandlerParameter, slot->msg, slot->msgSize);
 
-        self->unconfirmedReceivedIMessages = 0;
-        self->lastConfirmationTime = UINT64_MAX;
+        IngestQueue_release(self->ingestQueue, slot);
+    }
 
-        self->firstIMessageReceived = false;
+    Slave_unlockIngestConsumer(self);
+}
 
-        self->maxSentASDUs = slave->parameters.k;
-        self->oldestSentASDU = -1;
-        self->newestSentASDU = -1;
-        self->sentASDUs = (SentASDUSlave*) GLOBAL_MALLOC(sizeof(SentASDUSlave) * self->maxSentASDUs);
+/**
+ * Encode the ASDU into the ingest queue without taking a lock. Only the first producer
+ * after the queue has been drained informs the connections. When the ingest queue is full
+ * the producer moves the waiting ASDUs to the low-priority queue (or event log) itself.
+ */
+static EnqueueResult
+Slave_addToIngestQueue(Slave self, ASDU asdu)
+{
+    EnqueueResult result = ENQUEUE_OK;
 
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-        self->sentASDUsLock = Semaphore_create(1);
-#endif
+    IngestQueueSlot slot;
 
-        self->lowPrioQueue = lowPrioQueue;
-        self->highPrioQueue = highPrioQueue;
+    while ((slot = IngestQueue_reserve(self->ingestQueue)) == NULL) {
 
-        self->outstandingTestFRConMessages = 0;
+        if (Slave_drainIngestQueue(self) == false) {
+            DEBUG_PRINT("ingest queue full -> remove oldest ASDU\n");
 
-        Thread newThread =
-               Thread_create((ThreadExecutionFunction) connectionHandlingThread,
-                       (void*) self, true);
+            Slave_removeOldestIngestedASDU(self);
 
-        Thread_start(newThread);
+            result = ENQUEUE_OLDEST_DROPPED;
+        }
     }
 
-    return self;
-}
-
-void
-MasterConnection_close(MasterConnection self)
-{
-    self->isRunning = false;
-}
+    struct sBufferFrame bufferFrame;
 
-void
-MasterConnection_deactivate(MasterConnection self)
-{
-    self->isActive = false;
-}
+    Frame frame = BufferFrame_initialize(&bufferFrame, slot->msg, 0);
 
+    ASDU_encode(asdu, frame);
 
-bool
-MasterConnection_sendASDU(MasterConnection self, ASDU asdu)
-{
-    bool retVal = sendASDUInternal(self, asdu);
+    slot->msgSize = Frame_getMsgSize(frame);
 
-    if (ASDU_isStackCreated(asdu) == false)
-        ASDU_destroy(asdu);
+    IngestQueue_publish(self->ingestQueue, slot);
 
-    return retVal;
-}
+    if (Atomic_exchange(&(self->ingestWakeupPending), 1) == 0)
+        Slave_wakeupConnections(self);
 
-bool
-MasterConnection_sendACT_CON(MasterConnection self, ASDU asdu, bool negative)
-{
-    ASDU_setCOT(asdu, ACTIVATION_CON);
-    ASDU_setNegative(asdu, negative);
+    /* report the ASDUs that have been removed while the queue was drained */
+    if (self->ingestEventsRemoved && (Atomic_exchange(&(self->ingestEventsRemoved), 0) == 1))
+        result = ENQUEUE_OLDEST_DROPPED;
 
-    return MasterConnection_sendASDU(self, asdu);
+    return result;
 }
 
-bool
-MasterConnection_sendACT_TERM(MasterConnection self, ASDU asdu)
-{
-    ASDU_setCOT(asdu, ACTIVATION_TERMINATION);
-    ASDU_setNegative(asdu, false);
-
-    return MasterConnection_sendASDU(self, asdu);
-}
+#endif /* (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0) */
 
-static void*
-serverThread (void* parameter)
+/**
+ * Add the ASDU to the low-priority queue or the event log (one attempt)
+ */
+static EnqueueResult
+Slave_addToEventQueue(Slave self, ASDU asdu)
 {
-    Slave self = (Slave) parameter;
+#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == SINGLE_REDUNDANCY_GROUP) && (self->asduQueue != NULL))
+        return MessageQueue_enqueueASDU(self->asduQueue, asdu);
+#endif
 
-    ServerSocket serverSocket;
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) && (self->eventLog.buffer != NULL)) {
 
-    if (self->localAddress)
-        serverSocket = TcpServerSocket_create(self->localAddress, self->tcpPort);
-    else
-        serverSocket = TcpServerSocket_create("0.0.0.0", self->tcpPort);
+        /* events that are added while no client is connected are not stored */
+        if (self->openConnections == 0)
+            return ENQUEUE_OK;
 
-    if (serverSocket == NULL) {
-        DEBUG_PRINT("Cannot create server socket\n");
-        self->isStarting = false;
-        goto exit_function;
+        /* the event is encoded once - the connections read it from the shared log */
+        return EventLog_add(&(self->eventLog), asdu);
     }
+#endif
 
-    ServerSocket_listen(serverSocket);
+    return ENQUEUE_DROPPED;
+}
 
-    self->isRunning = true;
-    self->isStarting = false;
+/**
+ * Add the ASDUs to the low-priority queue or the event log (one attempt)
+ *
+ * Returns the number of added ASDUs.
+ */
+static int
+Slave_addBatchToEventQueue(Slave self, ASDU* asdus, int numberOfAsdus)
+{
+#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == SINGLE_REDUNDANCY_GROUP) && (self->asduQueue != NULL))
+        return MessageQueue_enqueueASDUs(self->asduQueue, asdus, numberOfAsdus);
+#endif
 
-    while (self->stopRunning == false) {
-        Socket newSocket = ServerSocket_accept(serverSocket);
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    if ((self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) && (self->eventLog.buffer != NULL)) {
 
-        if (newSocket != NULL) {
+        if (self->openConnections == 0)
+            return numberOfAsdus;
 
-            bool acceptConnection = true;
+        return EventLog_addBatch(&(self->eventLog), asdus, numberOfAsdus);
+    }
+#endif
 
-            /* check if maximum number of open connections is reached */
-            if (self->maxOpenConnections > 0) {
-                if (self->openConnections >= self->maxOpenConnections)
-                    acceptConnection = false;
-            }
+    return 0;
+}
 
-            if (acceptConnection && (self->connectionRequestHandler != NULL)) {
-                char ipAddress[60];
+EnqueueResult
+Slave_enqueueASDU(Slave self, ASDU asdu)
+{
+    EnqueueResult result;
 
-                Socket_getPeerAddressStatic(newSocket, ipAddress);
+#if (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0)
+    if (Slave_isUsingIngestQueue(self)) {
+        result = Slave_addToIngestQueue(self, asdu);
 
-                /* remove TCP port part */
-                char* separator = strchr(ipAddress, ':');
-                if (separator != NULL)
-                    *separator = 0;
+        if (ASDU_isStackCreated(asdu) == false)
+            ASDU_destroy(asdu);
 
-                acceptConnection = self->connectionRequestHandler(self->connectionRequestHandlerParameter,
-                        ipAddress);
-            }
+        return result;
+    }
+#endif /* (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0) */
 
-            if (acceptConnection) {
+    result = Slave_addToEventQueue(self, asdu);
 
-                MessageQueue lowPrioQueue = NULL;
-                HighPriorityASDUQueue highPrioQueue = NULL;
+    /* with the QUEUE_OVERFLOW_BLOCK policy wait until the clients confirmed enough ASDUs */
+    if ((result == ENQUEUE_DROPPED) && (self->overflowPolicy == QUEUE_OVERFLOW_BLOCK)) {
+        uint64_t startTime = Hal_getTimeInMs();
 
-#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
-                if (self->serverMode == SINGLE_REDUNDANCY_GROUP) {
-                    lowPrioQueue = self->asduQueue;
-                    highPrioQueue = self->connectionAsduQueue;
-                }
-#endif
+        Slave_setProducerBlocked(self, true);
 
-#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
-                if (self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) {
-                    lowPrioQueue = MessageQueue_create(self->maxLowPrioQueueSize);
-                    highPrioQueue = HighPriorityASDUQueue_create(self->maxHighPrioQueueSize);
-                }
-#endif
+        while ((result = Slave_addToEventQueue(self, asdu)) == ENQUEUE_DROPPED) {
+            uint64_t waitingTime = Hal_getTimeInMs() - startTime;
 
-                MasterConnection connection =
-                        MasterConnection_create(self, newSocket, lowPrioQueue, highPrioQueue);
+            if (waitingTime >= (uint64_t) self->blockTimeoutInMs)
+                break;
 
-#if (CONFIG_SLAVE_USING_THREADS)
-                Semaphore_wait(self->openConnectionsLock);
-#endif
+            Slave_waitForReleasedEvents(self, self->blockTimeoutInMs - (int) waitingTime);
+        }
 
-                self->openConnections++;
-                LinkedList_add(self->masterConnections, connection);
+        Slave_setProducerBlocked(self, false);
+    }
 
-#if (CONFIG_SLAVE_USING_THREADS)
-                Semaphore_post(self->openConnectionsLock);
-#endif
+    if (result != ENQUEUE_DROPPED) {
+        Slave_wakeupConnections(self);
 
-            }
-            else {
-                Socket_destroy(newSocket);
-            }
-        }
-        else
-            Thread_sleep(10);
+        Slave_checkWatermarks(self);
     }
 
-    if (serverSocket)
-        Socket_destroy((Socket) serverSocket);
-
-    self->isRunning = false;
-    self->stopRunning = false;
+    if (ASDU_isStackCreated(asdu) == false)
+        ASDU_destroy(asdu);
 
-exit_function:
-    return NULL;
+    return result;
 }
 
-void
-Slave_enqueueASDU(Slave self, ASDU asdu)
+int
+Slave_enqueueASDUs(Slave self, ASDU* asdus, int numberOfAsdus)
 {
+#if (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0)
+    /* keep the order of the ASDUs added before with Slave_enqueueASDU */
+    if (Slave_isUsingIngestQueue(self))
+        Slave_drainIngestQueue(self);
+#endif
 
-#if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
-    if (self->serverMode == SINGLE_REDUNDANCY_GROUP)
-        MessageQueue_enqueueASDU(self->asduQueue, asdu);
-#endif /* (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1) */
+    int added = Slave_addBatchToEventQueue(self, asdus, numberOfAsdus);
 
-#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
-    if (self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) {
+    /* with the QUEUE_OVERFLOW_BLOCK policy wait until the clients confirmed enough ASDUs */
+    if ((added < numberOfAsdus) && (self->overflowPolicy == QUEUE_OVERFLOW_BLOCK)) {
+        uint64_t startTime = Hal_getTimeInMs();
 
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-        Semaphore_wait(self->openConnectionsLock);
-#endif
+        Slave_setProducerBlocked(self, true);
 
-        /************************************************
-         * Dispatch event to all open client connections
-         ************************************************/
+        while (true) {
+            added += Slave_addBatchToEventQueue(self, asdus + added, numberOfAsdus - added);
 
-        LinkedList element;
+            if (added == numberOfAsdus)
+                break;
 
-        for (element = LinkedList_getNext(self->masterConnections);
-             element != NULL;
-             element = LinkedList_getNext(element))
-        {
-            MasterConnection connection = (MasterConnection) LinkedList_getData(element);
+            uint64_t waitingTime = Hal_getTimeInMs() - startTime;
+
+            if (waitingTime >= (uint64_t) self->blockTimeoutInMs)
+                break;
 
-            MessageQueue_enqueueASDU(connection->lowPrioQueue, asdu);
+            Slave_waitForReleasedEvents(self, self->blockTimeoutInMs - (int) waitingTime);
         }
 
-#if (CONFIG_SLAVE_USING_THREADS == 1)
-        Semaphore_post(self->openConnectionsLock);
-#endif
+        Slave_setProducerBlocked(self, false);
     }
-#endif /* (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1) */
 
-    ASDU_destroy(asdu);
+    if (added > 0) {
+        Slave_wakeupConnections(self);
+
+        Slave_checkWatermarks(self);
+    }
+
+    int i;
+
+    for (i = 0; i < numberOfAsdus; i++) {
+        if (ASDU_isStackCreated(asdus[i]) == false)
+            ASDU_destroy(asdus[i]);
+    }
 
-    //TODO trigger active connection(s) to send message?
+    return added;
 }
 
 void
@@ -1990,15 +3852,40 @@ Slave_start(Slave self)
         self->stopRunning = false;
 
 #if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
-        if (self->serverMode == SINGLE_REDUNDANCY_GROUP)
+        if ((self->serverMode == SINGLE_REDUNDANCY_GROUP) && (self->asduQueue == NULL))
             initializeMessageQueues(self, self->maxLowPrioQueueSize, self->maxHighPrioQueueSize);
 #endif
-        self->listeningThread = Thread_create(serverThread, (void*) self, false);
 
-        Thread_start(self->listeningThread);
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+        if ((self->serverMode == CONNECTION_IS_REDUNDANCY_GROUP) && (self->eventLog.buffer == NULL)) {
+            if (EventLog_initialize(&(self->eventLog), self->maxLowPrioQueueSize)) {
+                self->eventLog.overflowPolicy = self->overflowPolicy;
+                self->eventLog.spillHandler = self->spillHandler;
+                self->eventLog.spillHandlerParameter = self->spillHandlerParameter;
+
+                if (self->isCoalescingEnabled)
+                    self->eventLog.coalescingIndex = CoalescingIndex_create((ConnectionParameters) &(self->parameters),
+                            CONFIG_SLAVE_COALESCING_INDEX_SIZE);
+
+                if (self->packingMaxDelay >= 0)
+                    self->eventLog.packer = AsduPacker_create((ConnectionParameters) &(self->parameters),
+                            self->packingMaxDelay);
+            }
+        }
+#endif
+        if (self->threadingMode == EVENT_LOOP_THREAD) {
+            Slave_startEventLoops(self);
+
+            self->isStarting = false;
+        }
+        else {
+            self->listeningThread = Thread_create(serverThread, (void*) self, false);
 
-        while (self->isStarting)
-            Thread_sleep(1);
+            Thread_start(self->listeningThread);
+
+            while (self->isStarting)
+                Thread_sleep(1);
+        }
     }
 }
 
@@ -2011,6 +3898,13 @@ Slave_isRunning(Slave self)
 void
 Slave_stop(Slave self)
 {
+    if (self->threadingMode == EVENT_LOOP_THREAD) {
+        if (self->eventLoops != NULL)
+            Slave_stopEventLoops(self);
+
+        return;
+    }
+
     if (self->isRunning) {
         self->stopRunning = true;
 
@@ -2031,13 +3925,24 @@ Slave_destroy(Slave self)
         Slave_stop(self);
 
 #if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
-    if (self->serverMode == SINGLE_REDUNDANCY_GROUP)
-        MessageQueue_releaseAllQueuedASDUs(self->asduQueue);
+    /* the queues are created by Slave_start */
+    if ((self->serverMode == SINGLE_REDUNDANCY_GROUP) && (self->asduQueue != NULL)) {
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+        /* the events in a persistent queue are kept for the next start */
+        if (self->eventQueueFileName == NULL)
+#endif
+            MessageQueue_releaseAllQueuedASDUs(self->asduQueue);
+    }
 #endif
 
     if (self->localAddress != NULL)
         GLOBAL_FREEMEM(self->localAddress);
 
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+    if (self->eventQueueFileName != NULL)
+        GLOBAL_FREEMEM(self->eventQueueFileName);
+#endif
+
     /*
      * Stop all connections
      * */
@@ -2068,16 +3973,31 @@ Slave_destroy(Slave self)
 
 #if (CONFIG_SLAVE_USING_THREADS == 1)
     Semaphore_destroy(self->openConnectionsLock);
+    Semaphore_destroy(self->eventsReleased);
+#endif
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    EventLog_finalize(&(self->eventLog));
+#endif
+
+#if (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0)
+    IngestQueue_destroy(self->ingestQueue);
+    self->ingestQueue = NULL;
+
+#if (CONFIG_SLAVE_USING_THREADS == 1)
+    Semaphore_destroy(self->ingestConsumerLock);
+#endif
 #endif
 
 #if (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE == 0)
 
 #if (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
-    if (self->serverMode == SINGLE_REDUNDANCY_GROUP) {
+    if ((self->serverMode == SINGLE_REDUNDANCY_GROUP) && (self->asduQueue != NULL)) {
         MessageQueue_destroy(self->asduQueue);
         HighPriorityASDUQueue_destroy(self->connectionAsduQueue);
     }
 #endif /* (CONFIG_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1) */
+
     GLOBAL_FREEMEM(self);
 
 #endif /* (CONFIG_SLAVE_WITH_STATIC_MESSAGE_QUEUE == 0) */
@@ -232,6 +232,26 @@ Lib60870_enableDebugOutput(bool value);
 Lib60870VersionInfo
 Lib60870_getLibraryVersionInfo(void);
 
+typedef struct sASDUPool* ASDUPool;
+
+typedef struct sStaticASDU* StaticASDU;
+
+/**
+ * \brief Memory of an ASDU provided by the application (see \ref ASDU_initializeStatic)
+ *
+ * NOTE: The members must not be accessed directly.
+ */
+struct sStaticASDU {
+    bool stackCreated;
+    ConnectionParameters parameters;
+    uint8_t* asdu;
+    int asduHeaderLength;
+    uint8_t* payload;
+    int payloadSize;
+    ASDUPool pool;
+    uint8_t encodedData[256];
+};
+
 bool
 ASDU_isTest(ASDU self);
 
@@ -265,9 +285,60 @@ ASDU_isSequence(ASDU self);
 int
 ASDU_getNumberOfElements(ASDU self);
 
+/**
+ * \brief Get the information object with the given index
+ *
+ * The information object is allocated and has to be released with InformationObject_destroy.
+ * Use \ref ASDU_getElementEx to avoid the allocation.
+ *
+ * \param index the index of the information object (0 .. ASDU_getNumberOfElements - 1)
+ *
+ * \return the information object or NULL in case of an error
+ */
 InformationObject
 ASDU_getElement(ASDU self, int index);
 
+/**
+ * \brief Get the information object with the given index without allocating memory
+ *
+ * The information object is decoded into the memory provided by the application. A single
+ * union uStaticInformationObject (e.g. on the stack) can be reused to iterate over all elements
+ * of an ASDU in the ASDU received handler.
+ *
+ * Don't call InformationObject_destroy for the returned information object. It is valid until
+ * the memory is reused.
+ *
+ * \param io the memory for the information object
+ * \param index the index of the information object (0 .. ASDU_getNumberOfElements - 1)
+ *
+ * \return the information object (uses the memory of io) or NULL in case of an error
+ */
+InformationObject
+ASDU_getElementEx(ASDU self, StaticInformationObject io, int index);
+
+/**
+ * \brief Decode all elements of an ASDU with monitoring information into arrays (one array per field)
+ *
+ * Decodes the elements in a single pass without creating information objects. Supported are
+ * the types M_SP_NA_1, M_DP_NA_1, M_BO_NA_1, M_ME_NA_1, M_ME_NB_1, M_ME_NC_1, M_ME_ND_1 and the
+ * types with CP56Time2a time tag M_SP_TB_1, M_DP_TB_1, M_BO_TB_1, M_ME_TD_1, M_ME_TE_1, M_ME_TF_1.
+ * Other types have to be decoded with \ref ASDU_getElementEx.
+ *
+ * Each array can be NULL when the field is not required.
+ *
+ * \param ioa array for the information object addresses
+ * \param value array for the values: the state of single points (0/1), the DoublePointValue of double points,
+ *        the 32 bit value of bitstrings, -1.0 .. 1.0 for normalized values, the scaled value or the short
+ *        floating point value
+ * \param quality array for the quality descriptors (IEC60870_QUALITY_GOOD for M_ME_ND_1)
+ * \param timestamp array for the time tags in ms since epoch (0 for types without time tag)
+ * \param maxElements the size of the arrays
+ *
+ * \return the number of decoded elements or -1 if the type is not supported
+ */
+int
+ASDU_decodeBatch(ASDU self, int* ioa, double* value, QualityDescriptor* quality, uint64_t* timestamp, int maxElements);
+
 ASDU
 ASDU_create(ConnectionParameters parameters, TypeID typeId, bool isSequence, CauseOfTransmission cot, int oa, int ca,
         bool isTest, bool isNegative);
@@ -275,6 +346,55 @@ ASDU_create(ConnectionParameters parameters, TypeID typeId, bool isSequence, Cau
 void
 ASDU_destroy(ASDU self);
 
+/**
+ * \brief Initialize an ASDU in memory provided by the application (e.g. on the stack)
+ *
+ * No memory is allocated. The ASDU is not released by Slave_enqueueASDU or MasterConnection_sendASDU
+ * and can be reused with \ref ASDU_reset after it has been sent. Don't call ASDU_destroy for the ASDU.
+ *
+ * \param self the memory for the ASDU
+ *
+ * \return the ASDU (uses the memory of self)
+ */
+ASDU
+ASDU_initializeStatic(StaticASDU self, ConnectionParameters parameters, TypeID typeId, bool isSequence,
+        CauseOfTransmission cot, int oa, int ca, bool isTest, bool isNegative);
+
+/**
+ * \brief Remove all information objects from the ASDU to reuse it (the header is not changed)
+ *
+ * NOTE: Only for ASDUs created by ASDU_create, ASDU_initializeStatic or ASDUPool_createASDU.
+ */
+void
+ASDU_reset(ASDU self);
+
+/**
+ * \brief Create a pool of ASDUs
+ *
+ * The ASDUs of the pool are created and released without allocating memory. ASDU_destroy (also called by
+ * Slave_enqueueASDU and MasterConnection_sendASDU) returns the ASDU to its pool. A pool is not thread-safe:
+ * every thread that creates ASDUs needs its own pool, and the ASDUs have to be released by this thread.
+ *
+ * \param size the number of ASDUs in the pool
+ */
+ASDUPool
+ASDUPool_create(int size);
+
+/**
+ * \brief Destroy the pool (all ASDUs of the pool have to be released before)
+ */
+void
+ASDUPool_destroy(ASDUPool self);
+
+/**
+ * \brief Create an ASDU from the pool (same parameters as ASDU_create)
+ *
+ * When all ASDUs of the pool are in use the ASDU is allocated like with ASDU_create.
+ */
+ASDU
+ASDUPool_createASDU(ASDUPool self, ConnectionParameters parameters, TypeID typeId, bool isSequence,
+        CauseOfTransmission cot, int oa, int ca, bool isTest, bool isNegative);
+
 /**
  * \brief add an information object to the ASDU
  *
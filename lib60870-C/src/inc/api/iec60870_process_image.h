@@ -0,0 +1,192 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_INC_API_IEC60870_PROCESS_IMAGE_H_
+#define SRC_INC_API_IEC60870_PROCESS_IMAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "iec60870_common.h"
+#include "iec60870_slave.h"
+#include "information_objects.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Process image (point database) of a slave.
+ *
+ * The process image stores the current values of the information objects of a slave.
+ * The points are added in blocks of consecutive IOAs with the same type. A value update
+ * only changes the process image and adds a spontaneous event to the event queue of the
+ * slave when the value or the quality has changed. Interrogation (C_IC_NA_1) and read
+ * (C_RD_NA_1) commands are answered from the process image, so no ASDUs have to be created
+ * by the application for the responses. The interrogation responses contain the blocks as
+ * sequences of elements (SQ=1) with as many information objects per ASDU as possible.
+ * They are sent as response stream of the connection (see MasterConnection_startResponseStream),
+ * so the size of the process image is not limited by the queues of the connection.
+ * The encoded response of a CA and interrogation group is kept as snapshot and shared by all
+ * interrogations (of all connections) until a point of the snapshot changes, so simultaneous
+ * interrogations of redundant masters encode the process image only once.
+ *
+ * Supported types: M_SP_NA_1, M_DP_NA_1, M_ST_NA_1, M_ME_NA_1, M_ME_NB_1, M_ME_NC_1
+ *
+ * Usage:
+ *
+ *     ProcessImage image = ProcessImage_create(slave);
+ *
+ *     ProcessImage_addPoints(image, 1, M_SP_NA_1, 100, 1000);
+ *     ProcessImage_addPoints(image, 1, M_ME_NC_1, 2000, 500);
+ *
+ *     Slave_setInterrogationHandler(slave, ProcessImage_interrogationHandler, image);
+ *     Slave_setReadHandler(slave, ProcessImage_readHandler, image);
+ *
+ *     ProcessImage_updateShortFloat(image, 1, 2010, 23.5f, IEC60870_QUALITY_GOOD);
+ */
+typedef struct sProcessImage* ProcessImage;
+
+/**
+ * \brief Create a new (empty) process image
+ *
+ * \param slave the slave that sends the events and the responses (provides the application layer parameters)
+ */
+ProcessImage
+ProcessImage_create(Slave slave);
+
+/**
+ * \brief Destroy the process image (stop the slave or remove the image from the handlers of the slave before)
+ */
+void
+ProcessImage_destroy(ProcessImage self);
+
+/**
+ * \brief Add a block of points with consecutive IOAs
+ *
+ * The points are initialized with the value 0 and the quality IEC60870_QUALITY_INVALID.
+ *
+ * \param ca the common address of the points
+ * \param typeId the type of the points (see supported types)
+ * \param startIoa the IOA of the first point
+ * \param numberOfPoints the number of points
+ *
+ * \return true when the points have been added, false when the type is not supported,
+ *         the IOAs are already used, or no memory is available
+ */
+bool
+ProcessImage_addPoints(ProcessImage self, int ca, TypeID typeId, int startIoa, int numberOfPoints);
+
+/**
+ * \brief Assign a block of points to an interrogation group
+ *
+ * The points of all blocks are sent for a station interrogation. For a group interrogation
+ * only the blocks assigned to the group are sent.
+ *
+ * \param ca the common address of the block
+ * \param startIoa the IOA of the first point of the block
+ * \param group the interrogation group (1-16) or 0 (only station interrogation)
+ *
+ * \return true when the group has been set, false when the block doesn't exist
+ */
+bool
+ProcessImage_setInterrogationGroup(ProcessImage self, int ca, int startIoa, int group);
+
+/**
+ * \brief Send the events with time tag CP56Time2a (e.g. M_SP_TB_1 instead of M_SP_NA_1)
+ *
+ * \param enable true to add the time of the update to the events (default is false)
+ */
+void
+ProcessImage_setEventTimestamps(ProcessImage self, bool enable);
+
+/**
+ * \brief Update a single point (M_SP_NA_1)
+ *
+ * \return true when the point exists, false otherwise
+ */
+bool
+ProcessImage_updateSinglePoint(ProcessImage self, int ca, int ioa, bool value, QualityDescriptor quality);
+
+/**
+ * \brief Update a double point (M_DP_NA_1)
+ *
+ * \return true when the point exists, false otherwise
+ */
+bool
+ProcessImage_updateDoublePoint(ProcessImage self, int ca, int ioa, DoublePointValue value, QualityDescriptor quality);
+
+/**
+ * \brief Update a step position (M_ST_NA_1)
+ *
+ * \return true when the point exists, false otherwise
+ */
+bool
+ProcessImage_updateStepPosition(ProcessImage self, int ca, int ioa, int value, bool isTransient,
+        QualityDescriptor quality);
+
+/**
+ * \brief Update a normalized measured value (M_ME_NA_1)
+ *
+ * \return true when the point exists, false otherwise
+ */
+bool
+ProcessImage_updateNormalizedValue(ProcessImage self, int ca, int ioa, float value, QualityDescriptor quality);
+
+/**
+ * \brief Update a scaled measured value (M_ME_NB_1)
+ *
+ * \return true when the point exists, false otherwise
+ */
+bool
+ProcessImage_updateScaledValue(ProcessImage self, int ca, int ioa, int value, QualityDescriptor quality);
+
+/**
+ * \brief Update a short floating point measured value (M_ME_NC_1)
+ *
+ * \return true when the point exists, false otherwise
+ */
+bool
+ProcessImage_updateShortFloat(ProcessImage self, int ca, int ioa, float value, QualityDescriptor quality);
+
+/**
+ * \brief Interrogation handler that answers the interrogation commands from the process image
+ *
+ * Use with Slave_setInterrogationHandler (parameter is the process image). The response is
+ * streamed, another interrogation on the same connection is rejected until the response is
+ * complete. A deactivation stops the response.
+ */
+bool
+ProcessImage_interrogationHandler(void* parameter, MasterConnection connection, ASDU asdu, uint8_t qoi);
+
+/**
+ * \brief Read handler that answers the read commands from the process image
+ *
+ * Use with Slave_setReadHandler (parameter is the process image).
+ */
+bool
+ProcessImage_readHandler(void* parameter, MasterConnection connection, ASDU asdu, int ioa);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_INC_API_IEC60870_PROCESS_IMAGE_H_ */
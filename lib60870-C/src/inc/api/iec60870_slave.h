@@ -40,6 +40,30 @@ typedef enum {
     CONNECTION_IS_REDUNDANCY_GROUP
 } ServerMode;
 
+typedef enum {
+    THREAD_PER_CONNECTION, /**< each client connection is handled by a separate thread (default) */
+    EVENT_LOOP_THREAD /**< a single thread handles all client connections and the server socket */
+} ServerThreadingMode;
+
+/**
+ * \brief Behavior of the event queue when a new ASDU doesn't fit into the queue
+ */
+typedef enum {
+    QUEUE_OVERFLOW_DROP_OLDEST, /**< remove the oldest ASDUs to store the new ASDU (default) */
+    QUEUE_OVERFLOW_DROP_NEWEST, /**< discard the new ASDU */
+    QUEUE_OVERFLOW_BLOCK, /**< wait until the clients confirmed enough ASDUs (discard the new ASDU after the timeout) */
+    QUEUE_OVERFLOW_SPILL /**< remove the oldest ASDUs and pass them to the spill handler */
+} QueueOverflowPolicy;
+
+/**
+ * \brief Result of adding an ASDU to the event queue
+ */
+typedef enum {
+    ENQUEUE_OK, /**< the ASDU has been added */
+    ENQUEUE_OLDEST_DROPPED, /**< the ASDU has been added, older ASDUs have been removed (or spilled) */
+    ENQUEUE_DROPPED /**< the ASDU has been discarded */
+} EnqueueResult;
+
 /**
  * Callback handlers for master requests handling
  */
@@ -79,6 +103,28 @@ typedef bool (*DelayAcquisitionHandler) (void* parameter, MasterConnection conne
  */
 typedef bool (*ASDUHandler) (void* parameter, MasterConnection connection, ASDU asdu);
 
+/**
+ * \brief Producer of the ASDUs of a response stream (see \ref MasterConnection_startResponseStream)
+ *
+ * The producer is called by the connection whenever the k-window can take another ASDU.
+ *
+ * \param parameter user provided parameter
+ * \param connection the connection that sends the response
+ *
+ * \return the next ASDU of the response (the connection releases it unless it was created with
+ *         ASDU_initializeStatic) or NULL when the response is complete
+ */
+typedef ASDU (*ResponseProducer) (void* parameter, MasterConnection connection);
+
+/**
+ * \brief Called when a response stream has ended
+ *
+ * \param parameter user provided parameter
+ * \param connection the connection that sent the response
+ * \param completed true when all ASDUs have been sent, false when the stream was stopped or the connection was closed
+ */
+typedef void (*ResponseStreamFinishedHandler) (void* parameter, MasterConnection connection, bool completed);
+
 
 /**
  * \brief Connection request handler is called when a client tries to connect to the server.
@@ -90,11 +136,33 @@ typedef bool (*ASDUHandler) (void* parameter, MasterConnection connection, ASDU
  */
 typedef bool (*ConnectionRequestHandler) (void* parameter, const char* ipAddress);
 
+/**
+ * \brief Handler for ASDUs that are removed from the full event queue (QUEUE_OVERFLOW_SPILL policy)
+ *
+ * NOTE: The handler is called with the event queue locked and must not call functions of the slave.
+ *
+ * \param parameter user provided parameter
+ * \param asdu the encoded ASDU (only valid during the call)
+ * \param asduSize the size of the encoded ASDU
+ */
+typedef void (*QueueSpillHandler) (void* parameter, const uint8_t* asdu, int asduSize);
+
+/**
+ * \brief Handler that is called when the fill level of the event queue reaches the high water mark
+ * or drops to the low water mark
+ *
+ * \param parameter user provided parameter
+ * \param isHigh true when the high water mark has been reached, false when the fill level dropped to the low water mark
+ * \param fillLevel the fill level of the event queue in percent
+ */
+typedef void (*QueueWatermarkHandler) (void* parameter, bool isHigh, int fillLevel);
+
 /**
  * \brief Create a new instance of a CS104 slave (server)
  *
  * \param parameters the connection parameters to use (or NULL to use the default parameters)
- * \param maxLowPrioQueueSize the maximum size of the event queue
+ * \param maxLowPrioQueueSize the maximum size of the event queue (in CONNECTION_IS_REDUNDANCY_GROUP mode
+ *        the event queue is shared by all connections)
  * \param maxHighPrioQueueSize the maximum size of the high-priority queue
  */
 Slave
@@ -119,6 +187,136 @@ T104Slave_setLocalAddress(Slave self, const char* ipAddress);
 void
 T104Slave_setLocalPort(Slave self, int tcpPort);
 
+/**
+ * \brief Store the event queue in a file to keep the queued events when the application is restarted
+ *
+ * The file is mapped into the memory, so also large queues (millions of events) don't
+ * require heap memory. The queued events are packed (each event uses the size of the
+ * ASDU plus 3 bytes), the file size has to be less than 2 GB. Events that are not
+ * confirmed by the client are sent again after a restart.
+ *
+ * New events are written to the storage device before the queue state that refers
+ * to it, so after a failure of the operating system (e.g. a power loss) the newest events
+ * can be lost, but no partially written events are sent. When the file contains no valid
+ * queue state or damaged entries, the queue starts empty.
+ *
+ * NOTE: Only used in SINGLE_REDUNDANCY_GROUP server mode. Has to be called before Slave_start.
+ * Requires CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE. When the file cannot be used,
+ * the event queue is kept in memory.
+ *
+ * \param self the slave instance
+ * \param fileName full name (path + filename) of the file (created if it doesn't exist)
+ * \param fileSize the size of the file in bytes
+ */
+void
+T104Slave_setEventQueueFile(Slave self, const char* fileName, int fileSize);
+
+/**
+ * \brief Set the behavior when an ASDU is added to the full event queue
+ *
+ * The event queue is full when it only contains ASDUs that are not yet confirmed by the
+ * clients. In CONNECTION_IS_REDUNDANCY_GROUP mode an ASDU is confirmed when all connected
+ * clients confirmed it (also the clients that have not started the data transfer with
+ * STARTDT, they receive the ASDU after STARTDT), ASDUs that are added while no client is
+ * connected are discarded.
+ *
+ * NOTE: Has to be called before Slave_start. With the QUEUE_OVERFLOW_DROP_OLDEST and
+ * QUEUE_OVERFLOW_SPILL policies Slave_enqueueASDU uses the lock-free ingest queue (see
+ * CONFIG_SLAVE_INGEST_QUEUE_SIZE) and the ASDUs are moved to the event queue later. The
+ * result of the overflow policy is deferred: when older ASDUs have been removed (or spilled)
+ * while the ASDUs were moved, the next call of Slave_enqueueASDU returns ENQUEUE_OLDEST_DROPPED.
+ * Before Slave_start the ASDUs are kept in the ingest queue, when it is full the oldest
+ * ASDUs are removed (or spilled).
+ *
+ * \param self the slave instance
+ * \param policy the overflow policy (default is QUEUE_OVERFLOW_DROP_OLDEST)
+ * \param blockTimeoutInMs the maximum time Slave_enqueueASDU waits for free space (QUEUE_OVERFLOW_BLOCK policy)
+ */
+void
+T104Slave_setQueueOverflowPolicy(Slave self, QueueOverflowPolicy policy, int blockTimeoutInMs);
+
+/**
+ * \brief Set the handler for the ASDUs that are removed from the full event queue (QUEUE_OVERFLOW_SPILL policy)
+ *
+ * The handler can store the ASDUs in a secondary store (e.g. a file).
+ *
+ * NOTE: Has to be called before Slave_start.
+ *
+ * \param self the slave instance
+ * \param handler the spill handler
+ * \param parameter user provided parameter that is passed to the handler
+ */
+void
+T104Slave_setQueueSpillHandler(Slave self, QueueSpillHandler handler, void* parameter);
+
+/**
+ * \brief Set the water marks of the event queue fill level
+ *
+ * The handler is called once when the fill level reaches the high water mark and
+ * again when the fill level drops to the low water mark. The producers can use it
+ * to throttle the acquisition when the clients cannot receive the events fast enough.
+ *
+ * \param self the slave instance
+ * \param lowWatermark the low water mark in percent of the queue size
+ * \param highWatermark the high water mark in percent of the queue size
+ * \param handler the handler or NULL to disable the water marks
+ * \param parameter user provided parameter that is passed to the handler
+ */
+void
+T104Slave_setQueueWatermarks(Slave self, int lowWatermark, int highWatermark, QueueWatermarkHandler handler, void* parameter);
+
+/**
+ * \brief Replace queued measured values that are not yet sent by newer values
+ *
+ * When an ASDU with a single measured value (M_ME_*) is added and an ASDU with the same
+ * type ID, cause of transmission, CA and IOA is still waiting for transmission, the
+ * queued ASDU is overwritten with the new value (latest value wins) instead of adding
+ * the new ASDU. All other ASDUs (e.g. status changes) are added as usual, so their full
+ * history is sent. Reduces the number of stale values that are sent after a congestion
+ * or a reconnect. The replaced value keeps the position of the queued ASDU.
+ *
+ * NOTE: Has to be called before Slave_start. ASDUs added with Slave_enqueueASDUs are not
+ * replaced.
+ *
+ * \param self the slave instance
+ * \param enable true to enable the coalescing (default is false)
+ */
+void
+T104Slave_setEventCoalescing(Slave self, bool enable);
+
+/**
+ * \brief Pack single events into ASDUs with multiple information objects
+ *
+ * When an ASDU with process information in monitor direction (no sequence of elements)
+ * is added and the newest queued ASDU has the same type ID, cause of transmission and CA
+ * and is not yet sent, the information objects are appended to the queued ASDU (up to
+ * the maximum ASDU size) instead of adding the new ASDU. So more events are sent with
+ * each I message and each window of k unconfirmed messages.
+ *
+ * Events are always packed while they are waiting for transmission (e.g. when the
+ * k-buffer is full). With a maximum delay the newest queued ASDU is additionally held
+ * back until it is full or the delay has expired.
+ *
+ * NOTE: Has to be called before Slave_start. ASDUs added with Slave_enqueueASDUs are not
+ * packed. Not supported with a persistent event queue (see T104Slave_setEventQueueFile).
+ *
+ * \param self the slave instance
+ * \param enable true to enable the packing (default is false)
+ * \param maxDelayInMs maximum time in ms an event is held back to pack more events (latency budget, 0 = not held back)
+ */
+void
+T104Slave_setEventPacking(Slave self, bool enable, int maxDelayInMs);
+
+/**
+ * \brief Get the fill level of the event queue
+ *
+ * \param self the slave instance
+ *
+ * \return the fill level in percent of the queue size
+ */
+int
+Slave_getQueueFillLevel(Slave self);
+
 /**
  * \brief Get the number of connected clients
  *
@@ -141,6 +339,51 @@ T104Slave_setMaxOpenConnections(Slave self, int maxOpenConnections);
 void
 T104Slave_setServerMode(Slave self, ServerMode serverMode);
 
+/**
+ * \brief Set the threading mode of the server
+ *
+ * In the EVENT_LOOP_THREAD mode a single thread waits for new connections and received
+ * messages of all clients and handles the protocol timeouts of all connections. This keeps
+ * the required resources (threads, stacks) constant for a large number of clients.
+ *
+ * NOTE: Has to be called before Slave_start. In EVENT_LOOP_THREAD mode the callback handlers
+ * are called by the event loop thread and should return quickly. Slave_stop will also close
+ * all open client connections.
+ *
+ * \param self the slave instance
+ * \param threadingMode the threading mode to use (default is THREAD_PER_CONNECTION)
+ */
+void
+T104Slave_setThreadingMode(Slave self, ServerThreadingMode threadingMode);
+
+/**
+ * \brief Set the number of event loop threads (only used in EVENT_LOOP_THREAD mode)
+ *
+ * Each event loop thread has its own server socket bound to the same TCP port (SO_REUSEPORT)
+ * and handles all connections that are accepted by this socket. On platforms without support
+ * for shared server sockets only a single event loop thread is used.
+ *
+ * NOTE: Has to be called before Slave_start.
+ *
+ * \param self the slave instance
+ * \param numberOfThreads the number of event loop threads (default is 1)
+ */
+void
+T104Slave_setEventLoopThreads(Slave self, int numberOfThreads);
+
+/**
+ * \brief Bind the event loop threads to CPU cores (only used in EVENT_LOOP_THREAD mode)
+ *
+ * The first event loop thread is bound to the CPU core firstCpu, the second to firstCpu + 1, ...
+ *
+ * NOTE: Has to be called before Slave_start.
+ *
+ * \param self the slave instance
+ * \param firstCpu the CPU core of the first event loop thread or -1 to not bind the threads (default)
+ */
+void
+T104Slave_setEventLoopCpuAffinity(Slave self, int firstCpu);
+
 void
 T104Slave_setConnectionRequestHandler(Slave self, ConnectionRequestHandler handler, void* parameter);
 
@@ -177,11 +420,37 @@ Slave_stop(Slave self);
 /**
  * \brief Add an ASDU to the low-priority queue of the slave (use for periodic and spontaneous messages)
  *
+ * When the queue is full the ASDU is handled according to the overflow policy
+ * (see T104Slave_setQueueOverflowPolicy). The ASDU is released by the function, except
+ * for ASDUs created with ASDU_initializeStatic (they can be reused immediately).
+ *
  * \param asdu the ASDU to add
+ *
+ * \return ENQUEUE_OK when the ASDU has been added, ENQUEUE_OLDEST_DROPPED when older ASDUs
+ *         have been removed to add the ASDU (or, with the ingest queue, since the last call),
+ *         ENQUEUE_DROPPED when the ASDU has been discarded
  */
-void
+EnqueueResult
 Slave_enqueueASDU(Slave self, ASDU asdu);
 
+/**
+ * \brief Add multiple ASDUs to the low-priority queue of the slave
+ *
+ * Faster than calling Slave_enqueueASDU for each ASDU. The queue is locked only twice
+ * for up to 32 ASDUs and the ASDUs are copied to the queue without holding the lock,
+ * so multiple threads can add ASDUs in parallel. The connections are woken up once.
+ *
+ * The ASDUs are released by the function (like with Slave_enqueueASDU).
+ *
+ * \param asdus the ASDUs to add
+ * \param numberOfAsdus the number of ASDUs
+ *
+ * \return the number of ASDUs that have been added (less than numberOfAsdus when the
+ *         other ASDUs have been discarded according to the overflow policy)
+ */
+int
+Slave_enqueueASDUs(Slave self, ASDU* asdus, int numberOfAsdus);
+
 void
 Slave_destroy(Slave self);
 
@@ -190,7 +459,7 @@ Slave_destroy(Slave self);
  *
  * The ASDU will be released by this function after the message is sent.
  * You should not call the ASDU_destroy function for the given ASDU after
- * calling this function!
+ * calling this function! ASDUs created with ASDU_initializeStatic are not released.
  *
  * \param self the connection object (this is usually received as a parameter of a callback function)
  * \param asdu the ASDU to send to the client/master
@@ -206,6 +475,41 @@ MasterConnection_sendACT_CON(MasterConnection self, ASDU asdu, bool negative);
 bool
 MasterConnection_sendACT_TERM(MasterConnection self, ASDU asdu);
 
+/**
+ * \brief Send a response that is produced while it is sent
+ *
+ * Instead of sending all ASDUs of a large response (e.g. the answer to a station interrogation)
+ * at once, the connection pulls the ASDUs from the producer whenever the k-window has room for
+ * another ASDU. The response can have any size without filling the queues of the connection.
+ * The ASDUs of the stream are sent after the pending high priority ASDUs (like the ACT_CON of the
+ * request) and before the queued events. When the producer returns NULL an ACT_TERM for the
+ * request is sent and the stream ends.
+ *
+ * Only one stream per connection can be active. The function has to be called from a callback
+ * of the connection (e.g. the interrogation handler).
+ *
+ * \param self the connection object
+ * \param request the request ASDU that is terminated with ACT_TERM, or NULL to not send an ACT_TERM
+ * \param producer the producer of the response ASDUs
+ * \param finishedHandler called when the stream has ended (can be NULL)
+ * \param parameter user provided parameter for the producer and the finished handler
+ *
+ * \return true if the stream was started, false otherwise (another stream is active or connection not active)
+ */
+bool
+MasterConnection_startResponseStream(MasterConnection self, ASDU request, ResponseProducer producer,
+        ResponseStreamFinishedHandler finishedHandler, void* parameter);
+
+/**
+ * \brief Stop the active response stream (e.g. when the request is deactivated)
+ *
+ * No ACT_TERM is sent. The finished handler is called with completed = false.
+ *
+ * \return true if a stream was active, false otherwise
+ */
+bool
+MasterConnection_stopResponseStream(MasterConnection self);
+
 void
 MasterConnection_close(MasterConnection self);
 
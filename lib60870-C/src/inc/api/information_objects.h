@@ -264,6 +264,23 @@ StatusAndStatusChangeDetection_getCD(StatusAndStatusChangeDetection self, int in
 
 typedef struct sInformationObject* InformationObject;
 
+/**
+ * \brief Memory for a single information object provided by the application (see \ref ASDU_getElementEx)
+ *
+ * The memory is large enough for every information object type. It can be placed on the stack
+ * and reused for all elements of all received ASDUs.
+ *
+ * NOTE: The members must not be accessed directly.
+ */
+union uStaticInformationObject {
+    void* pointerAlignment;
+    uint64_t integerAlignment;
+    double floatAlignment;
+    uint8_t memory[64];
+};
+
+typedef union uStaticInformationObject* StaticInformationObject;
+
 /**
  * \brief return the size in memory of a generic InformationObject instance
  *
@@ -33,9 +33,56 @@
 extern "C" {
 #endif
 
+struct sASDU {
+    bool stackCreated;
+    ConnectionParameters parameters;
+    uint8_t* asdu;
+    int asduHeaderLength;
+    uint8_t* payload;
+    int payloadSize;
+    ASDUPool pool; /* the pool the ASDU is returned to by ASDU_destroy (NULL if not from a pool) */
+};
+
 void
 ASDU_encode(ASDU self, Frame frame);
 
+/**
+ * \brief Get the number of bytes written by ASDU_encode
+ */
+int
+ASDU_getEncodedSize(ASDU self);
+
+/**
+ * \brief Append encoded information objects to the ASDU (the IOAs are not checked)
+ *
+ * \param objects the encoded information objects (with IOA, or only the first with IOA for a sequence)
+ * \param size the size of the encoded information objects
+ * \param numberOfObjects the number of information objects
+ *
+ * \return true when added, false when there is not enough space left in the ASDU
+ */
+bool
+ASDU_addEncodedObjects(ASDU self, const uint8_t* objects, int size, int numberOfObjects);
+
+/**
+ * \brief Initialize a read-only ASDU that refers to the encoded ASDU in the buffer
+ *
+ * Nothing is copied or allocated, the buffer has to be valid as long as the ASDU is used.
+ * Used for received messages. Don't call ASDU_destroy for the ASDU.
+ *
+ * \return the ASDU or NULL when the message is too small
+ */
+ASDU
+ASDU_initializeFromBuffer(ASDU self, ConnectionParameters parameters, uint8_t* msg, int msgLength);
+
+/**
+ * \brief Copy an encoded ASDU into memory provided by the caller (see ASDU_initializeStatic)
+ *
+ * \return the ASDU or NULL when the encoded ASDU is too small or too large
+ */
+ASDU
+ASDU_initializeStaticFromBuffer(StaticASDU self, ConnectionParameters parameters, const uint8_t* msg, int msgLength);
+
 bool
 CP16Time2a_getFromBuffer (CP16Time2a self, uint8_t* msg, int msgSize, int startIndex);
 
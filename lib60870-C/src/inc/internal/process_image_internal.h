@@ -0,0 +1,41 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_INC_INTERNAL_PROCESS_IMAGE_INTERNAL_H_
+#define SRC_INC_INTERNAL_PROCESS_IMAGE_INTERNAL_H_
+
+#include "iec60870_process_image.h"
+
+/**
+ * \brief Get the number of interrogation snapshots that can be used by new interrogations
+ */
+int
+ProcessImage_getNumberOfCachedSnapshots(ProcessImage self);
+
+/**
+ * \brief Get the number of interrogation snapshots in memory
+ *
+ * This includes snapshots that have been invalidated but are still sent by an interrogation response.
+ */
+int
+ProcessImage_getNumberOfAllocatedSnapshots(ProcessImage self);
+
+#endif /* SRC_INC_INTERNAL_PROCESS_IMAGE_INTERNAL_H_ */
@@ -0,0 +1,74 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_INC_INTERNAL_SEQUENCE_DECODER_H_
+#define SRC_INC_INTERNAL_SEQUENCE_DECODER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "iec60870_common.h"
+
+/**
+ * Decoder for the elements of sequence ASDUs (SQ=1) without time tag.
+ *
+ * The elements of a sequence have a fixed size and are stored without gaps, so the values and
+ * quality descriptors of all elements can be unpacked with SIMD instructions. The SSE4.1 and
+ * AVX2 implementations are only available with GCC or clang on x86 platforms (and when
+ * CONFIG_USE_SIMD_DECODER is set). All implementations return the same results.
+ */
+typedef enum {
+    SEQUENCE_DECODER_SCALAR,
+    SEQUENCE_DECODER_SSE41,
+    SEQUENCE_DECODER_AVX2
+} SequenceDecoderType;
+
+/**
+ * \brief Check if the implementation is available and supported by the CPU
+ */
+bool
+SequenceDecoder_isSupported(SequenceDecoderType type);
+
+/**
+ * \brief Get the fastest implementation supported by the CPU
+ */
+SequenceDecoderType
+SequenceDecoder_getBestType(void);
+
+/**
+ * \brief Decode the values and quality descriptors of the elements of a sequence
+ *
+ * The values are converted in the same way as by ASDU_decodeBatch.
+ *
+ * \param type the implementation to use (has to be supported)
+ * \param typeId M_SP_NA_1, M_DP_NA_1, M_ME_NA_1, M_ME_NB_1 or M_ME_NC_1
+ * \param data the first element (after the IOA of the sequence)
+ * \param numberOfElements the number of elements
+ * \param value array for the values
+ * \param quality array for the quality descriptors
+ *
+ * \return true when the elements are decoded, false when the type is not supported
+ */
+bool
+SequenceDecoder_decode(SequenceDecoderType type, TypeID typeId, const uint8_t* data, int numberOfElements,
+        double* value, QualityDescriptor* quality);
+
+#endif /* SRC_INC_INTERNAL_SEQUENCE_DECODER_H_ */
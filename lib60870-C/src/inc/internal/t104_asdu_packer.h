@@ -0,0 +1,87 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_IEC60870_T104_ASDU_PACKER_H_
+#define SRC_IEC60870_T104_ASDU_PACKER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "iec60870_common.h"
+#include "message_ring.h"
+
+/**
+ * Packing of queued events into ASDUs with multiple information objects.
+ *
+ * When an encoded ASDU (process information in monitor direction, no sequence of
+ * elements) is added and the newest queued entry is not yet sent and has the same
+ * type ID, cause of transmission, originator address and CA, the information objects
+ * of the ASDU are appended to the queued entry (up to the maximum ASDU size) instead of
+ * adding a new entry. So multiple events are sent with one I message.
+ *
+ * To collect more events, the newest entry can be held back for a maximum delay
+ * (latency budget) before it is sent.
+ */
+typedef struct sAsduPacker* AsduPacker;
+
+/**
+ * \brief Create a new packer
+ *
+ * \param parameters the application layer parameters of the encoded ASDUs
+ * \param maxDelayInMs maximum time the newest entry is held back to pack more events (0 = not held back)
+ */
+AsduPacker
+AsduPacker_create(ConnectionParameters parameters, int maxDelayInMs);
+
+void
+AsduPacker_destroy(AsduPacker self);
+
+/**
+ * \brief Append the information objects of the encoded ASDU to the newest entry of the ring
+ *
+ * \param ring the ring that contains the queued entries
+ * \param firstUnsentSeqNo sequence number of the first entry that has not been sent
+ *
+ * \return true when the ASDU has been packed, false when it has to be added as a new entry
+ */
+bool
+AsduPacker_pack(AsduPacker self, MessageRing ring, uint64_t firstUnsentSeqNo, const uint8_t* asdu, int asduSize);
+
+/**
+ * \brief Inform the packer that an ASDU has been added as a new entry (starts the delay of the entry)
+ *
+ * \param seqNo the sequence number of the new entry
+ */
+void
+AsduPacker_entryAdded(AsduPacker self, uint64_t seqNo);
+
+/**
+ * \brief Get the time until the entry can be sent
+ *
+ * \param ring the ring that contains the queued entries
+ * \param seqNo the sequence number of the next entry to send
+ *
+ * \return the remaining time in ms the entry is held back or 0 when the entry can be sent
+ */
+int
+AsduPacker_getSendDelay(AsduPacker self, MessageRing ring, uint64_t seqNo);
+
+#endif /* SRC_IEC60870_T104_ASDU_PACKER_H_ */
@@ -0,0 +1,76 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_IEC60870_T104_COALESCING_INDEX_H_
+#define SRC_IEC60870_T104_COALESCING_INDEX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "iec60870_common.h"
+#include "message_ring.h"
+
+/**
+ * Index of the queued measured value events (M_ME_*) with a single information object.
+ *
+ * The index maps (type ID, cause of transmission, CA, IOA) to the queued entry of the
+ * newest event. It is used to replace an event that has not yet been sent with a newer
+ * value of the same information object (latest value wins). The index has a fixed number
+ * of slots and two keys can use the same slot, so an event is not always found (then the
+ * new event is added to the queue as usual).
+ */
+typedef struct sCoalescingIndex* CoalescingIndex;
+
+/**
+ * \brief Create a new index
+ *
+ * \param parameters the application layer parameters of the encoded ASDUs
+ * \param minSize minimum number of slots (rounded up to a power of two)
+ */
+CoalescingIndex
+CoalescingIndex_create(ConnectionParameters parameters, int minSize);
+
+void
+CoalescingIndex_destroy(CoalescingIndex self);
+
+/**
+ * \brief Find the queued entry that can be replaced by the encoded ASDU
+ *
+ * \param ring the ring that contains the queued entries
+ * \param firstUnsentSeqNo sequence number of the first entry that has not been sent
+ *
+ * \return the queued entry (same size as the ASDU) or NULL when the ASDU has to be added
+ */
+uint8_t*
+CoalescingIndex_lookup(CoalescingIndex self, MessageRing ring, uint64_t firstUnsentSeqNo,
+        const uint8_t* asdu, int asduSize);
+
+/**
+ * \brief Add a committed entry to the index (ignored when it cannot be replaced)
+ *
+ * \param entry the queued entry
+ * \param entrySize the size of the entry
+ * \param seqNo the sequence number of the entry
+ */
+void
+CoalescingIndex_add(CoalescingIndex self, uint8_t* entry, int entrySize, uint64_t seqNo);
+
+#endif /* SRC_IEC60870_T104_COALESCING_INDEX_H_ */
@@ -0,0 +1,237 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_IEC60870_T104_MESSAGE_QUEUE_H_
+#define SRC_IEC60870_T104_MESSAGE_QUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "iec60870_common.h"
+#include "iec60870_slave.h"
+
+/** Memory reserved for each entry of the queue (maximum ASDU size plus length header) */
+#define MESSAGE_QUEUE_ENTRY_SIZE 256
+
+/**
+ * Low-priority (event) queue of the slave.
+ *
+ * The encoded ASDUs (without APCI) are packed into a byte ring (see MessageRing),
+ * so an entry only uses the size of the ASDU plus three bytes. Every entry gets a
+ * sequence number when it is added. The queue keeps the sequence numbers of the
+ * oldest entry (not yet confirmed), of the next entry to send and of the next
+ * entry to add. When the queue is full the entries are handled according to the
+ * overflow policy (the oldest entries are overwritten by default).
+ */
+typedef struct sMessageQueue* MessageQueue;
+
+/**
+ * \brief Create a new message queue
+ *
+ * The queue has space for maxQueueSize ASDUs of maximum size. Smaller ASDUs
+ * are packed, so the queue can store more entries.
+ *
+ * \param maxQueueSize number of maximum size ASDUs that fit into the queue
+ */
+MessageQueue
+MessageQueue_create(int maxQueueSize);
+
+/**
+ * \brief Create a persistent message queue that is stored in a memory mapped file
+ *
+ * The state of the queue is written to the file with every change. When the file
+ * contains a queue (e.g. after a restart of the application) all entries that have not
+ * been confirmed are restored and sent again.
+ *
+ * Only available when CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE is enabled.
+ *
+ * \param fileName full name (path + filename) of the file
+ * \param fileSize the size of the file in bytes
+ *
+ * \return the new queue or NULL when the file cannot be opened or is too small
+ */
+MessageQueue
+MessageQueue_createPersistent(const char* fileName, int fileSize);
+
+void
+MessageQueue_destroy(MessageQueue self);
+
+void
+MessageQueue_lock(MessageQueue self);
+
+void
+MessageQueue_unlock(MessageQueue self);
+
+/**
+ * \brief Get the number of maximum size ASDUs that fit into the queue
+ */
+int
+MessageQueue_getSize(MessageQueue self);
+
+/**
+ * \brief Get the number of queued entries (waiting for transmission or not yet confirmed)
+ */
+int
+MessageQueue_getNumberOfEntries(MessageQueue self);
+
+/**
+ * \brief Set the behavior when an entry is added to the full queue
+ *
+ * With the QUEUE_OVERFLOW_BLOCK policy the queue doesn't wait for free space, the
+ * new entry is rejected (like with QUEUE_OVERFLOW_DROP_NEWEST) and the caller has to retry.
+ *
+ * \param spillHandler handler for the removed entries (QUEUE_OVERFLOW_SPILL policy)
+ */
+void
+MessageQueue_setOverflowPolicy(MessageQueue self, QueueOverflowPolicy policy, QueueSpillHandler spillHandler,
+        void* spillHandlerParameter);
+
+/**
+ * \brief Replace queued measured values (M_ME_*) that are not yet sent by newer values
+ *
+ * When an ASDU with a single measured value is added and an entry with the same type ID,
+ * cause of transmission, CA and IOA is waiting for transmission, the entry is overwritten
+ * with the new ASDU instead of adding a new entry (latest value wins).
+ *
+ * \param parameters the application layer parameters of the queued ASDUs
+ */
+void
+MessageQueue_enableCoalescing(MessageQueue self, ConnectionParameters parameters);
+
+/**
+ * \brief Pack single events into the newest entry that is not yet sent (see AsduPacker)
+ *
+ * Not supported by persistent queues (the call is ignored).
+ *
+ * \param parameters the application layer parameters of the queued ASDUs
+ * \param maxDelayInMs maximum time the newest entry is held back to pack more events
+ */
+void
+MessageQueue_enablePacking(MessageQueue self, ConnectionParameters parameters, int maxDelayInMs);
+
+/**
+ * \brief Get the fill level of the queue in percent
+ */
+int
+MessageQueue_getFillLevel(MessageQueue self);
+
+/**
+ * \brief Get the fill level of the queue in percent
+ *
+ * Has to be called with the queue lock held.
+ */
+int
+MessageQueue_getFillLevelLocked(MessageQueue self);
+
+/**
+ * \brief Encode the ASDU and add it to the queue. When the queue is full, apply the overflow policy.
+ */
+EnqueueResult
+MessageQueue_enqueueASDU(MessageQueue self, ASDU asdu);
+
+/**
+ * \brief Add an encoded ASDU to the queue. When the queue is full, apply the overflow policy.
+ *
+ * Has to be called with the queue lock held.
+ */
+EnqueueResult
+MessageQueue_enqueueEncodedASDU(MessageQueue self, const uint8_t* asdu, int asduSize);
+
+/**
+ * \brief Encode the ASDUs and add them to the queue. When the queue is full, apply the overflow policy.
+ *
+ * The entries for the ASDUs are reserved with a single acquisition of the queue lock,
+ * the ASDUs are encoded without holding the lock, and all entries are committed with
+ * another acquisition of the lock.
+ *
+ * \return the number of ASDUs added to the queue (less than numberOfAsdus when the
+ *         overflow policy rejects new entries or all space is used by reserved entries)
+ */
+int
+MessageQueue_enqueueASDUs(MessageQueue self, ASDU* asdus, int numberOfAsdus);
+
+/**
+ * \brief Reserve an entry for an encoded ASDU. When the queue is full, apply the overflow policy.
+ *
+ * The ASDU has to be written to the returned buffer (without holding the queue lock) and
+ * the entry committed with MessageQueue_commitASDU. Entries become visible for sending
+ * in the order they have been reserved.
+ *
+ * \param asduSize the size of the encoded ASDU
+ *
+ * \return the buffer for the encoded ASDU or NULL when no space is available
+ */
+uint8_t*
+MessageQueue_reserveASDU(MessageQueue self, int asduSize);
+
+/**
+ * \brief Commit an entry that has been reserved with MessageQueue_reserveASDU
+ */
+void
+MessageQueue_commitASDU(MessageQueue self, uint8_t* entry);
+
+/**
+ * \brief Get the time the next entry is held back to pack more events
+ *
+ * Has to be called with the queue lock held.
+ *
+ * \return the remaining time in ms or 0 when the entry can be sent (or no entry is waiting)
+ */
+int
+MessageQueue_getSendDelay(MessageQueue self);
+
+/**
+ * \brief Get the next entry waiting for transmission and mark it as sent
+ *
+ * Has to be called with the queue lock held. The returned message is valid
+ * until the queue lock is released.
+ *
+ * \param seqNo returns the sequence number of the entry (required to confirm the entry)
+ * \param asduSize returns the size of the encoded ASDU
+ *
+ * \return the encoded ASDU or NULL if no entry is waiting for transmission
+ */
+uint8_t*
+MessageQueue_getNextWaitingASDU(MessageQueue self, uint64_t* seqNo, int* asduSize);
+
+/**
+ * \brief Check if entries are waiting for transmission (and are not held back)
+ *
+ * Has to be called with the queue lock held.
+ */
+bool
+MessageQueue_isAsduWaiting(MessageQueue self);
+
+/**
+ * \brief Confirm the entry with the given sequence number and all older entries
+ *
+ * Nothing happens when the entry has already been removed from the queue.
+ */
+void
+MessageQueue_markAsduAsConfirmed(MessageQueue self, uint64_t seqNo);
+
+/**
+ * \brief Remove all entries from the queue
+ */
+void
+MessageQueue_releaseAllQueuedASDUs(MessageQueue self);
+
+#endif /* SRC_IEC60870_T104_MESSAGE_QUEUE_H_ */
@@ -0,0 +1,70 @@
+/*
+ *  Copyright 2017 MZ Automation GmbH
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_IEC60870_T104_RECEIVE_BUFFER_H_
+#define SRC_IEC60870_T104_RECEIVE_BUFFER_H_
+
+#include <stdint.h>
+
+#include "hal_socket.h"
+#include "lib60870_config.h"
+
+#ifndef CONFIG_T104_RECEIVE_BUFFER_SIZE
+#define CONFIG_T104_RECEIVE_BUFFER_SIZE 2048
+#endif
+
+/**
+ * Receive buffer of a CS104 connection.
+ *
+ * All data available at the socket is read at once. The complete APDUs in the
+ * buffer can then be taken one by one. The start of an incomplete APDU remains
+ * in the buffer until the remaining data is received.
+ */
+struct sT104ReceiveBuffer {
+    uint8_t buffer[CONFIG_T104_RECEIVE_BUFFER_SIZE];
+    int readPos; /* start of the first unhandled byte */
+    int writePos; /* end of the received data */
+};
+
+typedef struct sT104ReceiveBuffer* T104ReceiveBuffer;
+
+void
+T104ReceiveBuffer_initialize(T104ReceiveBuffer self);
+
+/**
+ * \brief Read the available data from the socket (single non-blocking read)
+ *
+ * \return number of bytes read, 0 if no data is available, -1 if connection is closed or in case of an error
+ */
+int
+T104ReceiveBuffer_fill(T104ReceiveBuffer self, Socket socket);
+
+/**
+ * \brief Get the next complete APDU from the buffer
+ *
+ * \param msg returns the pointer to the APDU. The APDU remains valid until the next call of T104ReceiveBuffer_fill.
+ *
+ * \return size of the APDU, 0 if no complete APDU is available, -1 in case of a framing error
+ */
+int
+T104ReceiveBuffer_getNextMessage(T104ReceiveBuffer self, uint8_t** msg);
+
+#endif /* SRC_IEC60870_T104_RECEIVE_BUFFER_H_ */
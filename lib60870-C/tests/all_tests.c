@@ -1,6 +1,20 @@
 #include "unity.h"
 #include "iec60870_common.h"
 #include "hal_time.h"
+#include "t104_receive_buffer.h"
+#include "timer_wheel.h"
+#include "message_ring.h"
+#include "t104_message_queue.h"
+#include "iec60870_process_image.h"
+#include "process_image_internal.h"
+#include "iec60870_slave.h"
+#include "t104_connection.h"
+#include "hal_thread.h"
+#include "sequence_decoder.h"
+#include "lib60870_internal.h"
+
+#include <string.h>
+#include <stdio.h>
 
 void setUp(void) { }
 void tearDown(void) {}
@@ -72,6 +86,1899 @@ test_StepPositionInformation(void)
 }
 
 
+void
+test_ASDU_getOA(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    ASDU asdu = ASDU_create(&parameters, M_ME_NC_1, false, SPONTANEOUS, 5, 0x1234, false, false);
+
+    TEST_ASSERT_EQUAL_INT(5, ASDU_getOA(asdu));
+    TEST_ASSERT_EQUAL_INT(0x1234, ASDU_getCA(asdu));
+
+    ASDU_destroy(asdu);
+
+    /* no originator address with a single byte COT */
+    parameters.sizeOfCOT = 1;
+
+    asdu = ASDU_create(&parameters, M_ME_NC_1, false, SPONTANEOUS, 5, 1, false, false);
+
+    TEST_ASSERT_EQUAL_INT(-1, ASDU_getOA(asdu));
+
+    ASDU_destroy(asdu);
+}
+
+void
+test_BitString32(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    ASDU asdu = ASDU_create(&parameters, M_BO_NA_1, false, SPONTANEOUS, 0, 1, false, false);
+
+    BitString32 bs = BitString32_create(NULL, 100, 0x12345678);
+    ASDU_addInformationObject(asdu, (InformationObject) bs);
+
+    /* values with the highest bit set */
+    BitString32_create(bs, 101, 0xdeadbeef);
+    ASDU_addInformationObject(asdu, (InformationObject) bs);
+
+    BitString32_destroy(bs);
+
+    bs = (BitString32) ASDU_getElement(asdu, 0);
+    TEST_ASSERT_EQUAL_HEX32(0x12345678, BitString32_getValue(bs));
+    BitString32_destroy(bs);
+
+    bs = (BitString32) ASDU_getElement(asdu, 1);
+    TEST_ASSERT_EQUAL_HEX32(0xdeadbeef, BitString32_getValue(bs));
+    BitString32_destroy(bs);
+
+    ASDU_destroy(asdu);
+
+    struct sCP56Time2a time;
+    CP56Time2a_createFromMsTimestamp(&time, 1500000000000);
+
+    asdu = ASDU_create(&parameters, M_BO_TB_1, false, SPONTANEOUS, 0, 1, false, false);
+
+    Bitstring32WithCP56Time2a bst = Bitstring32WithCP56Time2a_create(NULL, 100, 0x80000001, &time);
+    ASDU_addInformationObject(asdu, (InformationObject) bst);
+    Bitstring32WithCP56Time2a_destroy(bst);
+
+    bst = (Bitstring32WithCP56Time2a) ASDU_getElement(asdu, 0);
+    TEST_ASSERT_EQUAL_HEX32(0x80000001, BitString32_getValue((BitString32) bst));
+    Bitstring32WithCP56Time2a_destroy(bst);
+
+    ASDU_destroy(asdu);
+}
+
+void
+test_T104ReceiveBuffer_partialFrames(void)
+{
+    struct sT104ReceiveBuffer recvBuffer;
+
+    /* S frame, U frame (TESTFR act) and start of an I frame */
+    uint8_t data[] = { 0x68, 0x04, 0x01, 0x00, 0x02, 0x00,
+                       0x68, 0x04, 0x43, 0x00, 0x00, 0x00,
+                       0x68, 0x0e, 0x00, 0x00, 0x00, 0x00, 0x64, 0x01 };
+
+    uint8_t rest[] = { 0x06, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x14 };
+
+    uint8_t* msg;
+
+    T104ReceiveBuffer_initialize(&recvBuffer);
+
+    memcpy(recvBuffer.buffer, data, sizeof(data));
+    recvBuffer.writePos = sizeof(data);
+
+    TEST_ASSERT_EQUAL_INT(6, T104ReceiveBuffer_getNextMessage(&recvBuffer, &msg));
+    TEST_ASSERT_EQUAL_UINT8(0x01, msg[2]);
+
+    TEST_ASSERT_EQUAL_INT(6, T104ReceiveBuffer_getNextMessage(&recvBuffer, &msg));
+    TEST_ASSERT_EQUAL_UINT8(0x43, msg[2]);
+
+    /* incomplete I frame */
+    TEST_ASSERT_EQUAL_INT(0, T104ReceiveBuffer_getNextMessage(&recvBuffer, &msg));
+
+    memcpy(recvBuffer.buffer + recvBuffer.writePos, rest, sizeof(rest));
+    recvBuffer.writePos += sizeof(rest);
+
+    TEST_ASSERT_EQUAL_INT(16, T104ReceiveBuffer_getNextMessage(&recvBuffer, &msg));
+    TEST_ASSERT_EQUAL_UINT8(0x64, msg[6]);
+    TEST_ASSERT_EQUAL_UINT8(0x14, msg[15]);
+
+    TEST_ASSERT_EQUAL_INT(0, T104ReceiveBuffer_getNextMessage(&recvBuffer, &msg));
+
+    /* invalid start byte */
+    recvBuffer.buffer[recvBuffer.writePos++] = 0x67;
+    recvBuffer.buffer[recvBuffer.writePos++] = 0x04;
+
+    TEST_ASSERT_EQUAL_INT(-1, T104ReceiveBuffer_getNextMessage(&recvBuffer, &msg));
+}
+
+
+static uint64_t timerWheelTime;
+
+static void
+timerWheelTestHandler(void* parameter)
+{
+    uint64_t* expiredAt = (uint64_t*) parameter;
+
+    *expiredAt = timerWheelTime;
+}
+
+void
+test_TimerWheel(void)
+{
+    uint64_t delays[] = { 0, 5, 63, 64, 1000, 4096, 15000, 300000, 20000000 };
+
+    struct sTimerWheelTimer timers[9];
+    uint64_t expiredAt[9];
+
+    timerWheelTime = 1490087538821;
+
+    TimerWheel timerWheel = TimerWheel_create(timerWheelTime);
+
+    int i;
+
+    for (i = 0; i < 9; i++) {
+        expiredAt[i] = 0;
+        TimerWheelTimer_initialize(&(timers[i]), timerWheelTestHandler, &(expiredAt[i]));
+        TimerWheel_arm(timerWheel, &(timers[i]), timerWheelTime + delays[i]);
+    }
+
+    /* cancelled timer never expires */
+    TimerWheel_cancel(timerWheel, &(timers[4]));
+    TEST_ASSERT_FALSE(TimerWheelTimer_isArmed(&(timers[4])));
+
+    uint64_t startTime = timerWheelTime;
+
+    while (TimerWheel_getNextExpiryTime(timerWheel) != UINT64_MAX) {
+        timerWheelTime = TimerWheel_getNextExpiryTime(timerWheel);
+        TimerWheel_advance(timerWheel, timerWheelTime);
+    }
+
+    for (i = 0; i < 9; i++) {
+        if (i == 4)
+            TEST_ASSERT_EQUAL_UINT64(0, expiredAt[i]);
+        else
+            TEST_ASSERT_EQUAL_UINT64(startTime + delays[i], expiredAt[i]);
+    }
+
+    /* timers expire when the time jumps */
+    expiredAt[0] = 0;
+    TimerWheel_arm(timerWheel, &(timers[0]), timerWheelTime + 10000);
+
+    timerWheelTime += 100000;
+    TimerWheel_advance(timerWheel, timerWheelTime);
+
+    TEST_ASSERT_EQUAL_UINT64(timerWheelTime, expiredAt[0]);
+
+    TimerWheel_destroy(timerWheel);
+}
+
+static void
+enqueueTestASDU(MessageQueue queue, ConnectionParameters parameters, int ca)
+{
+    ASDU asdu = ASDU_create(parameters, M_ME_NC_1, false, SPONTANEOUS, 0, ca, false, false);
+
+    MessageQueue_enqueueASDU(queue, asdu);
+
+    ASDU_destroy(asdu);
+}
+
+static int
+getQueuedCA(uint8_t* asdu)
+{
+    /* ASDU header: type ID, VSQ, COT (2 bytes), CA (2 bytes) */
+    return asdu[4];
+}
+
+void
+test_MessageQueue(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    /* space for one ASDU of maximum size = 28 ASDUs without information objects (6 bytes + 3 bytes header) */
+    MessageQueue queue = MessageQueue_create(1);
+
+    TEST_ASSERT_EQUAL_INT(1, MessageQueue_getSize(queue));
+
+    int i;
+
+    for (i = 0; i < 5; i++)
+        enqueueTestASDU(queue, &parameters, i);
+
+    uint64_t seqNo;
+    int asduSize;
+    uint8_t* asdu;
+
+    MessageQueue_lock(queue);
+
+    for (i = 0; i < 3; i++) {
+        asdu = MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize);
+
+        TEST_ASSERT_NOT_NULL(asdu);
+        TEST_ASSERT_EQUAL_INT(6, asduSize);
+        TEST_ASSERT_EQUAL_UINT64(i, seqNo);
+        TEST_ASSERT_EQUAL_INT(i, getQueuedCA(asdu));
+    }
+
+    MessageQueue_unlock(queue);
+
+    /* confirmation removes all older entries */
+    MessageQueue_markAsduAsConfirmed(queue, 1);
+    TEST_ASSERT_EQUAL_INT(3, MessageQueue_getNumberOfEntries(queue));
+
+    MessageQueue_markAsduAsConfirmed(queue, 0);
+    TEST_ASSERT_EQUAL_INT(3, MessageQueue_getNumberOfEntries(queue));
+
+    /* queue overflow removes the oldest entries (also the sent but not confirmed ones) */
+    for (i = 5; i < 38; i++)
+        enqueueTestASDU(queue, &parameters, i);
+
+    TEST_ASSERT_EQUAL_INT(28, MessageQueue_getNumberOfEntries(queue));
+
+    MessageQueue_lock(queue);
+
+    asdu = MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize);
+
+    TEST_ASSERT_NOT_NULL(asdu);
+    TEST_ASSERT_EQUAL_UINT64(10, seqNo);
+    TEST_ASSERT_EQUAL_INT(10, getQueuedCA(asdu));
+
+    MessageQueue_unlock(queue);
+
+    /* entry is no longer in the queue */
+    MessageQueue_markAsduAsConfirmed(queue, 2);
+    TEST_ASSERT_EQUAL_INT(28, MessageQueue_getNumberOfEntries(queue));
+
+    MessageQueue_releaseAllQueuedASDUs(queue);
+    TEST_ASSERT_EQUAL_INT(0, MessageQueue_getNumberOfEntries(queue));
+
+    MessageQueue_lock(queue);
+    TEST_ASSERT_NULL(MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize));
+    MessageQueue_unlock(queue);
+
+    MessageQueue_destroy(queue);
+}
+
+static int spilledASDUs;
+static int lastSpilledCA;
+
+static void
+spillHandler(void* parameter, const uint8_t* asdu, int asduSize)
+{
+    spilledASDUs++;
+    lastSpilledCA = asdu[4];
+}
+
+void
+test_MessageQueueOverflowPolicy(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    MessageQueue queue = MessageQueue_create(1);
+
+    MessageQueue_setOverflowPolicy(queue, QUEUE_OVERFLOW_DROP_NEWEST, NULL, NULL);
+
+    ASDU asdu = ASDU_create(&parameters, M_ME_NC_1, false, SPONTANEOUS, 0, 1, false, false);
+
+    int i;
+
+    for (i = 0; i < 28; i++)
+        TEST_ASSERT_EQUAL_INT(ENQUEUE_OK, MessageQueue_enqueueASDU(queue, asdu));
+
+    TEST_ASSERT_EQUAL_INT(98, MessageQueue_getFillLevel(queue));
+
+    /* the new ASDU is discarded */
+    TEST_ASSERT_EQUAL_INT(ENQUEUE_DROPPED, MessageQueue_enqueueASDU(queue, asdu));
+    TEST_ASSERT_EQUAL_INT(28, MessageQueue_getNumberOfEntries(queue));
+
+    ASDU_destroy(asdu);
+
+    MessageQueue_releaseAllQueuedASDUs(queue);
+    TEST_ASSERT_EQUAL_INT(0, MessageQueue_getFillLevel(queue));
+
+    /* the oldest ASDUs are passed to the spill handler */
+    MessageQueue_setOverflowPolicy(queue, QUEUE_OVERFLOW_SPILL, spillHandler, NULL);
+
+    spilledASDUs = 0;
+
+    for (i = 0; i < 30; i++)
+        enqueueTestASDU(queue, &parameters, i);
+
+    TEST_ASSERT_EQUAL_INT(2, spilledASDUs);
+    TEST_ASSERT_EQUAL_INT(1, lastSpilledCA);
+    TEST_ASSERT_EQUAL_INT(28, MessageQueue_getNumberOfEntries(queue));
+
+    MessageQueue_destroy(queue);
+}
+
+static void
+enqueueMeasuredValue(MessageQueue queue, ConnectionParameters parameters, TypeID typeId, int ioa, float value)
+{
+    ASDU asdu = ASDU_create(parameters, typeId, false, SPONTANEOUS, 0, 1, false, false);
+
+    InformationObject io;
+
+    if (typeId == M_ME_NC_1)
+        io = (InformationObject) MeasuredValueShort_create(NULL, ioa, value, IEC60870_QUALITY_GOOD);
+    else
+        io = (InformationObject) SinglePointInformation_create(NULL, ioa, (value != 0.f), IEC60870_QUALITY_GOOD);
+
+    ASDU_addInformationObject(asdu, io);
+    InformationObject_destroy(io);
+
+    MessageQueue_enqueueASDU(queue, asdu);
+
+    ASDU_destroy(asdu);
+}
+
+void
+test_MessageQueueCoalescing(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    MessageQueue queue = MessageQueue_create(10);
+
+    MessageQueue_enableCoalescing(queue, &parameters);
+
+    /* the waiting value is replaced, other IOAs and status changes are added */
+    enqueueMeasuredValue(queue, &parameters, M_ME_NC_1, 100, 1.f);
+    enqueueMeasuredValue(queue, &parameters, M_ME_NC_1, 101, 1.f);
+    enqueueMeasuredValue(queue, &parameters, M_ME_NC_1, 100, 2.f);
+    enqueueMeasuredValue(queue, &parameters, M_SP_NA_1, 100, 1.f);
+    enqueueMeasuredValue(queue, &parameters, M_SP_NA_1, 100, 0.f);
+    enqueueMeasuredValue(queue, &parameters, M_ME_NC_1, 100, 3.f);
+
+    TEST_ASSERT_EQUAL_INT(4, MessageQueue_getNumberOfEntries(queue));
+
+    uint64_t seqNo;
+    int asduSize;
+
+    MessageQueue_lock(queue);
+
+    uint8_t* asdu = MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize);
+
+    TEST_ASSERT_NOT_NULL(asdu);
+    TEST_ASSERT_EQUAL_INT(M_ME_NC_1, asdu[0]);
+
+    float value;
+    memcpy(&value, asdu + 9, sizeof(float));
+
+    TEST_ASSERT_EQUAL_FLOAT(3.f, value);
+
+    MessageQueue_unlock(queue);
+
+    /* a value that has been sent is not replaced */
+    enqueueMeasuredValue(queue, &parameters, M_ME_NC_1, 100, 4.f);
+
+    TEST_ASSERT_EQUAL_INT(5, MessageQueue_getNumberOfEntries(queue));
+
+    MessageQueue_destroy(queue);
+}
+
+void
+test_MessageQueuePacking(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    MessageQueue queue = MessageQueue_create(10);
+
+    MessageQueue_enablePacking(queue, &parameters, 0);
+
+    /* events with the same type ID, COT, and CA are packed into the newest entry */
+    enqueueMeasuredValue(queue, &parameters, M_SP_NA_1, 100, 1.f);
+    enqueueMeasuredValue(queue, &parameters, M_SP_NA_1, 101, 0.f);
+    enqueueMeasuredValue(queue, &parameters, M_SP_NA_1, 102, 1.f);
+    enqueueMeasuredValue(queue, &parameters, M_ME_NC_1, 200, 1.f);
+    enqueueMeasuredValue(queue, &parameters, M_SP_NA_1, 103, 1.f);
+
+    TEST_ASSERT_EQUAL_INT(3, MessageQueue_getNumberOfEntries(queue));
+
+    uint64_t seqNo;
+    int asduSize;
+
+    MessageQueue_lock(queue);
+
+    uint8_t* asdu = MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize);
+
+    TEST_ASSERT_NOT_NULL(asdu);
+    TEST_ASSERT_EQUAL_INT(M_SP_NA_1, asdu[0]);
+    TEST_ASSERT_EQUAL_INT(3, asdu[1]);
+    TEST_ASSERT_EQUAL_INT(6 + (3 * 4), asduSize);
+    TEST_ASSERT_EQUAL_INT(102, asdu[6 + 8]);
+
+    MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize);
+    MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize);
+
+    MessageQueue_unlock(queue);
+
+    /* an entry that has been sent is not changed */
+    enqueueMeasuredValue(queue, &parameters, M_SP_NA_1, 104, 1.f);
+
+    TEST_ASSERT_EQUAL_INT(4, MessageQueue_getNumberOfEntries(queue));
+
+    MessageQueue_destroy(queue);
+
+    /* the newest entry is held back until it is full or the delay has expired */
+    queue = MessageQueue_create(10);
+
+    MessageQueue_enablePacking(queue, &parameters, 10000);
+
+    enqueueMeasuredValue(queue, &parameters, M_SP_NA_1, 100, 1.f);
+
+    MessageQueue_lock(queue);
+
+    TEST_ASSERT_NULL(MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize));
+    TEST_ASSERT_FALSE(MessageQueue_isAsduWaiting(queue));
+    TEST_ASSERT_TRUE(MessageQueue_getSendDelay(queue) > 0);
+
+    MessageQueue_unlock(queue);
+
+    int i;
+
+    /* 60 single points fit into an ASDU */
+    for (i = 1; i < 61; i++)
+        enqueueMeasuredValue(queue, &parameters, M_SP_NA_1, 100 + i, 1.f);
+
+    MessageQueue_lock(queue);
+
+    asdu = MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize);
+
+    TEST_ASSERT_NOT_NULL(asdu);
+    TEST_ASSERT_EQUAL_INT(60, asdu[1]);
+
+    TEST_ASSERT_NULL(MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize));
+
+    MessageQueue_unlock(queue);
+
+    MessageQueue_destroy(queue);
+}
+
+void
+test_StaticASDUAndPool(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    struct sStaticASDU staticAsdu;
+
+    ASDU asdu = ASDU_initializeStatic(&staticAsdu, &parameters, M_ME_NC_1, false, SPONTANEOUS, 5, 1, false, false);
+
+    TEST_ASSERT_TRUE(ASDU_isStackCreated(asdu));
+    TEST_ASSERT_EQUAL_INT(5, ASDU_getOA(asdu));
+    TEST_ASSERT_EQUAL_INT(1, ASDU_getCA(asdu));
+
+    MeasuredValueShort io = MeasuredValueShort_create(NULL, 100, 1.0f, IEC60870_QUALITY_GOOD);
+
+    ASDU_addInformationObject(asdu, (InformationObject) io);
+    ASDU_addInformationObject(asdu, (InformationObject) io);
+    TEST_ASSERT_EQUAL_INT(2, ASDU_getNumberOfElements(asdu));
+
+    ASDU_reset(asdu);
+    TEST_ASSERT_EQUAL_INT(0, ASDU_getNumberOfElements(asdu));
+    TEST_ASSERT_EQUAL_INT(M_ME_NC_1, ASDU_getTypeID(asdu));
+    TEST_ASSERT_EQUAL_INT(SPONTANEOUS, ASDU_getCOT(asdu));
+
+    ASDU_addInformationObject(asdu, (InformationObject) io);
+    TEST_ASSERT_EQUAL_INT(1, ASDU_getNumberOfElements(asdu));
+
+    /* the ASDUs are returned to the pool - when the pool is empty the ASDU is allocated */
+    ASDUPool pool = ASDUPool_create(2);
+
+    ASDU first = ASDUPool_createASDU(pool, &parameters, M_ME_NC_1, false, SPONTANEOUS, 0, 1, false, false);
+    ASDU second = ASDUPool_createASDU(pool, &parameters, M_ME_NC_1, false, SPONTANEOUS, 0, 1, false, false);
+    ASDU third = ASDUPool_createASDU(pool, &parameters, M_ME_NC_1, false, SPONTANEOUS, 0, 1, false, false);
+
+    TEST_ASSERT_NOT_NULL(third);
+    TEST_ASSERT_FALSE(ASDU_isStackCreated(first));
+
+    ASDU_destroy(third);
+    ASDU_destroy(second);
+
+    TEST_ASSERT_TRUE(ASDUPool_createASDU(pool, &parameters, M_SP_NA_1, false, SPONTANEOUS, 0, 1, false, false) == second);
+
+    ASDU_destroy(second);
+    ASDU_destroy(first);
+
+    ASDUPool_destroy(pool);
+
+    MeasuredValueShort_destroy(io);
+}
+
+void
+test_ASDU_getElementEx(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    struct sStaticASDU staticAsdu;
+
+    ASDU asdu = ASDU_initializeStatic(&staticAsdu, &parameters, M_ME_NC_1, true, PERIODIC, 0, 1, false, false);
+
+    int i;
+
+    for (i = 0; i < 10; i++) {
+        MeasuredValueShort io = MeasuredValueShort_create(NULL, 200 + i, (float) i, IEC60870_QUALITY_GOOD);
+        ASDU_addInformationObject(asdu, (InformationObject) io);
+        MeasuredValueShort_destroy(io);
+    }
+
+    TEST_ASSERT_EQUAL_INT(10, ASDU_getNumberOfElements(asdu));
+
+    /* one memory block is reused for all elements */
+    union uStaticInformationObject ioMemory;
+
+    for (i = 0; i < ASDU_getNumberOfElements(asdu); i++) {
+        MeasuredValueShort mvs = (MeasuredValueShort) ASDU_getElementEx(asdu, &ioMemory, i);
+
+        TEST_ASSERT_TRUE((void*) mvs == (void*) &ioMemory);
+        TEST_ASSERT_EQUAL_INT(200 + i, InformationObject_getObjectAddress((InformationObject) mvs));
+        TEST_ASSERT_EQUAL_FLOAT((float) i, MeasuredValueShort_getValue(mvs));
+    }
+
+    /* a different type can be decoded into the same memory */
+    asdu = ASDU_initializeStatic(&staticAsdu, &parameters, C_SC_NA_1, false, ACTIVATION, 0, 1, false, false);
+
+    SingleCommand sc = SingleCommand_create(NULL, 5000, true, false, 0);
+    ASDU_addInformationObject(asdu, (InformationObject) sc);
+    SingleCommand_destroy(sc);
+
+    sc = (SingleCommand) ASDU_getElementEx(asdu, &ioMemory, 0);
+
+    TEST_ASSERT_EQUAL_INT(5000, InformationObject_getObjectAddress((InformationObject) sc));
+    TEST_ASSERT_TRUE(SingleCommand_getState(sc));
+}
+
+void
+test_ASDU_decodeBatch(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    struct sStaticASDU staticAsdu;
+
+    int ioa[10];
+    double value[10];
+    QualityDescriptor quality[10];
+    uint64_t timestamp[10];
+
+    /* short floating point values with time tag */
+    ASDU asdu = ASDU_initializeStatic(&staticAsdu, &parameters, M_ME_TF_1, false, SPONTANEOUS, 0, 1, false, false);
+
+    struct sCP56Time2a time;
+    CP56Time2a_createFromMsTimestamp(&time, 1500000000123);
+
+    int i;
+
+    for (i = 0; i < 5; i++) {
+        MeasuredValueShortWithCP56Time2a io = MeasuredValueShortWithCP56Time2a_create(NULL, 1000 + (i * 7), 0.5f * i,
+                (i == 3) ? IEC60870_QUALITY_INVALID : IEC60870_QUALITY_GOOD, &time);
+        ASDU_addInformationObject(asdu, (InformationObject) io);
+        MeasuredValueShortWithCP56Time2a_destroy(io);
+    }
+
+    TEST_ASSERT_EQUAL_INT(5, ASDU_decodeBatch(asdu, ioa, value, quality, timestamp, 10));
+
+    for (i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_INT(1000 + (i * 7), ioa[i]);
+        TEST_ASSERT_EQUAL_FLOAT(0.5f * i, (float) value[i]);
+        TEST_ASSERT_EQUAL_INT((i == 3) ? IEC60870_QUALITY_INVALID : IEC60870_QUALITY_GOOD, quality[i]);
+        TEST_ASSERT_TRUE(timestamp[i] == 1500000000123);
+    }
+
+    /* the arrays limit the number of elements */
+    TEST_ASSERT_EQUAL_INT(2, ASDU_decodeBatch(asdu, ioa, NULL, NULL, NULL, 2));
+
+    /* sequence of single points */
+    asdu = ASDU_initializeStatic(&staticAsdu, &parameters, M_SP_NA_1, true, INTERROGATED_BY_STATION, 0, 1, false, false);
+
+    for (i = 0; i < 8; i++) {
+        SinglePointInformation io = SinglePointInformation_create(NULL, 300 + i, (i % 2) == 1,
+                (i == 4) ? IEC60870_QUALITY_BLOCKED : IEC60870_QUALITY_GOOD);
+        ASDU_addInformationObject(asdu, (InformationObject) io);
+        SinglePointInformation_destroy(io);
+    }
+
+    TEST_ASSERT_EQUAL_INT(8, ASDU_decodeBatch(asdu, ioa, value, quality, timestamp, 10));
+
+    for (i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_INT(300 + i, ioa[i]);
+        TEST_ASSERT_TRUE(value[i] == (double) (i % 2));
+        TEST_ASSERT_EQUAL_INT((i == 4) ? IEC60870_QUALITY_BLOCKED : IEC60870_QUALITY_GOOD, quality[i]);
+        TEST_ASSERT_TRUE(timestamp[i] == 0);
+    }
+
+    /* the values are the same as with ASDU_getElementEx */
+    asdu = ASDU_initializeStatic(&staticAsdu, &parameters, M_BO_NA_1, false, SPONTANEOUS, 0, 1, false, false);
+
+    BitString32 bitString = BitString32_create(NULL, 77, 0xdeadbeef);
+    ASDU_addInformationObject(asdu, (InformationObject) bitString);
+    BitString32_destroy(bitString);
+
+    union uStaticInformationObject ioMemory;
+
+    bitString = (BitString32) ASDU_getElementEx(asdu, &ioMemory, 0);
+
+    TEST_ASSERT_EQUAL_INT(1, ASDU_decodeBatch(asdu, ioa, value, NULL, NULL, 10));
+    TEST_ASSERT_EQUAL_INT(77, ioa[0]);
+    TEST_ASSERT_TRUE(value[0] == (double) 0xdeadbeef);
+    TEST_ASSERT_TRUE(BitString32_getValue(bitString) == 0xdeadbeef);
+
+    /* types without batch support */
+    asdu = ASDU_initializeStatic(&staticAsdu, &parameters, C_SC_NA_1, false, ACTIVATION, 0, 1, false, false);
+
+    TEST_ASSERT_EQUAL_INT(-1, ASDU_decodeBatch(asdu, ioa, value, quality, timestamp, 10));
+}
+
+void
+test_ASDU_decodeBatch_normalizedWithoutQuality(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    struct sStaticASDU staticAsdu;
+
+    float testValues[] = {-1.0f, -0.5f, -0.001f, 0.0f, 0.001f, 0.25f, 0.5f, 0.99f, 1.0f};
+    int numberOfValues = sizeof(testValues) / sizeof(testValues[0]);
+
+    int ioa[10];
+    double value[10];
+    QualityDescriptor quality[10];
+
+    ASDU asdu = ASDU_initializeStatic(&staticAsdu, &parameters, M_ME_ND_1, false, PERIODIC, 0, 1, false, false);
+
+    int i;
+
+    for (i = 0; i < numberOfValues; i++) {
+        MeasuredValueNormalizedWithoutQuality io = MeasuredValueNormalizedWithoutQuality_create(NULL, 400 + i, testValues[i]);
+        ASDU_addInformationObject(asdu, (InformationObject) io);
+        MeasuredValueNormalizedWithoutQuality_destroy(io);
+    }
+
+    TEST_ASSERT_EQUAL_INT(numberOfValues, ASDU_decodeBatch(asdu, ioa, value, quality, NULL, 10));
+
+    union uStaticInformationObject ioMemory;
+
+    for (i = 0; i < numberOfValues; i++) {
+        MeasuredValueNormalizedWithoutQuality io = (MeasuredValueNormalizedWithoutQuality) ASDU_getElementEx(asdu, &ioMemory, i);
+
+        TEST_ASSERT_EQUAL_INT(InformationObject_getObjectAddress((InformationObject) io), ioa[i]);
+        TEST_ASSERT_TRUE(value[i] == (double) MeasuredValueNormalizedWithoutQuality_getValue(io));
+        TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_GOOD, quality[i]);
+    }
+}
+
+void
+test_SequenceDecoder(void)
+{
+    TypeID types[] = {M_SP_NA_1, M_DP_NA_1, M_ME_NA_1, M_ME_NB_1, M_ME_NC_1};
+    int elementSizes[] = {1, 1, 3, 3, 5};
+
+    uint8_t data[127 * 5];
+
+    double expectedValues[128];
+    QualityDescriptor expectedQuality[128];
+    double values[128];
+    QualityDescriptor quality[128];
+
+    int i;
+
+    for (i = 0; i < (int) sizeof(data); i++)
+        data[i] = (uint8_t) ((i * 167) + (i >> 3));
+
+    TEST_ASSERT_FALSE(SequenceDecoder_decode(SEQUENCE_DECODER_SCALAR, M_BO_NA_1, data, 1, values, quality));
+
+    int t;
+
+    for (t = 0; t < 5; t++) {
+        int maxElements = (int) sizeof(data) / elementSizes[t];
+
+        if (maxElements > 127)
+            maxElements = 127;
+
+        int numberOfElements;
+
+        for (numberOfElements = 1; numberOfElements <= maxElements; numberOfElements++) {
+
+            /* the data is placed at the end of the buffer to detect reads beyond the last element */
+            const uint8_t* elements = data + sizeof(data) - (numberOfElements * elementSizes[t]);
+
+            SequenceDecoder_decode(SEQUENCE_DECODER_SCALAR, types[t], elements, numberOfElements,
+                    expectedValues, expectedQuality);
+
+            SequenceDecoderType type;
+
+            for (type = SEQUENCE_DECODER_SSE41; type <= SEQUENCE_DECODER_AVX2; type++) {
+
+                if (SequenceDecoder_isSupported(type) == false)
+                    continue;
+
+                memset(values, 0xaa, sizeof(values));
+                memset(quality, 0xaa, sizeof(quality));
+
+                TEST_ASSERT_TRUE(SequenceDecoder_decode(type, types[t], elements, numberOfElements, values, quality));
+
+                TEST_ASSERT_EQUAL_MEMORY(expectedValues, values, numberOfElements * sizeof(double));
+                TEST_ASSERT_EQUAL_MEMORY(expectedQuality, quality, numberOfElements);
+
+                /* nothing is written beyond the last element */
+                TEST_ASSERT_EQUAL_UINT8(0xaa, quality[numberOfElements]);
+            }
+        }
+    }
+
+    /* scaled values of the scalar decoder */
+    uint8_t scaled[] = {0xff, 0x7f, 0x00, 0x00, 0x80, 0x10};
+
+    SequenceDecoder_decode(SEQUENCE_DECODER_SCALAR, M_ME_NB_1, scaled, 2, values, quality);
+
+    TEST_ASSERT_TRUE(values[0] == 32767.0);
+    TEST_ASSERT_TRUE(values[1] == -32768.0);
+    TEST_ASSERT_EQUAL_UINT8(0x10, quality[1]);
+}
+
+void
+test_ProcessImage(void)
+{
+    Slave slave = T104Slave_create(NULL, 10, 10);
+
+    ProcessImage image = ProcessImage_create(slave);
+
+    TEST_ASSERT_TRUE(ProcessImage_addPoints(image, 1, M_SP_NA_1, 100, 100));
+    TEST_ASSERT_TRUE(ProcessImage_addPoints(image, 1, M_ME_NC_1, 10, 90));
+    TEST_ASSERT_TRUE(ProcessImage_addPoints(image, 2, M_ME_NC_1, 100, 10));
+
+    /* overlapping IOAs and unsupported types are rejected */
+    TEST_ASSERT_FALSE(ProcessImage_addPoints(image, 1, M_ME_NB_1, 199, 10));
+    TEST_ASSERT_FALSE(ProcessImage_addPoints(image, 1, M_ME_NB_1, 1, 10));
+    TEST_ASSERT_FALSE(ProcessImage_addPoints(image, 1, M_IT_NA_1, 1000, 10));
+
+    TEST_ASSERT_TRUE(ProcessImage_updateSinglePoint(image, 1, 199, true, IEC60870_QUALITY_GOOD));
+    TEST_ASSERT_TRUE(ProcessImage_updateShortFloat(image, 1, 10, 1.5f, IEC60870_QUALITY_GOOD));
+    TEST_ASSERT_TRUE(ProcessImage_updateShortFloat(image, 2, 109, 1.5f, IEC60870_QUALITY_GOOD));
+
+    /* unknown points and wrong types */
+    TEST_ASSERT_FALSE(ProcessImage_updateSinglePoint(image, 1, 200, true, IEC60870_QUALITY_GOOD));
+    TEST_ASSERT_FALSE(ProcessImage_updateSinglePoint(image, 3, 100, true, IEC60870_QUALITY_GOOD));
+    TEST_ASSERT_FALSE(ProcessImage_updateScaledValue(image, 1, 10, 1, IEC60870_QUALITY_GOOD));
+
+    TEST_ASSERT_TRUE(ProcessImage_setInterrogationGroup(image, 1, 10, 2));
+    TEST_ASSERT_FALSE(ProcessImage_setInterrogationGroup(image, 1, 11, 2));
+
+    ProcessImage_destroy(image);
+
+    Slave_destroy(slave);
+}
+
+#define PROCESS_IMAGE_TEST_PORT 20410
+#define PROCESS_IMAGE_TEST_POINTS 2000
+#define PROCESS_IMAGE_TEST_TIMEOUT 5000
+#define MAX_RECEIVED_ASDUS 64
+
+typedef struct {
+    TypeID typeId;
+    CauseOfTransmission cot;
+    bool isNegative;
+    int oa;
+    int ca;
+    int numberOfElements;
+} ReceivedASDU;
+
+/* master of the process image tests that records the received ASDUs */
+typedef struct {
+    T104Connection connection;
+
+    volatile bool started;
+
+    ReceivedASDU asdus[MAX_RECEIVED_ASDUS];
+    volatile int numberOfAsdus;
+
+    volatile int numberOfPoints; /* points received with interrogation responses */
+    volatile bool watchedPointValue; /* value of the point with IOA 2099 in the last interrogation response */
+
+    /* values of the measured value with IOA 10 in the last event and the last interrogation response */
+    volatile float eventValue;
+    volatile float interrogatedValue;
+
+    /* block the receiving thread at the first points of an interrogation response (to keep the stream open) */
+    volatile bool pauseAtPoints;
+    volatile bool paused;
+} TestMaster;
+
+static void
+testMasterConnectionHandler(void* parameter, T104Connection connection, IEC60870ConnectionEvent event)
+{
+    TestMaster* self = (TestMaster*) parameter;
+
+    if (event == IEC60870_CONNECTION_STARTDT_CON_RECEIVED)
+        self->started = true;
+}
+
+static bool
+testMasterASDUReceivedHandler(void* parameter, ASDU asdu)
+{
+    TestMaster* self = (TestMaster*) parameter;
+
+    CauseOfTransmission cot = ASDU_getCOT(asdu);
+
+    bool isInterrogationResponse = (cot >= INTERROGATED_BY_STATION) && (cot <= INTERROGATED_BY_GROUP_16);
+
+    if (isInterrogationResponse && self->pauseAtPoints) {
+        self->paused = true;
+
+        while (self->pauseAtPoints)
+            Thread_sleep(1);
+
+        self->paused = false;
+    }
+
+    if (self->numberOfAsdus < MAX_RECEIVED_ASDUS) {
+        ReceivedASDU* received = &(self->asdus[self->numberOfAsdus]);
+
+        received->typeId = ASDU_getTypeID(asdu);
+        received->cot = cot;
+        received->isNegative = ASDU_isNegative(asdu);
+        received->oa = ASDU_getOA(asdu);
+        received->ca = ASDU_getCA(asdu);
+        received->numberOfElements = ASDU_getNumberOfElements(asdu);
+
+        self->numberOfAsdus++;
+    }
+
+    if (ASDU_getTypeID(asdu) == M_ME_NC_1) {
+        union uStaticInformationObject ioMemory;
+
+        int i;
+
+        for (i = 0; i < ASDU_getNumberOfElements(asdu); i++) {
+            InformationObject io = ASDU_getElementEx(asdu, &ioMemory, i);
+
+            if (InformationObject_getObjectAddress(io) == 10) {
+                float value = MeasuredValueShort_getValue((MeasuredValueShort) io);
+
+                if (cot == SPONTANEOUS)
+                    self->eventValue = value;
+                else if (isInterrogationResponse)
+                    self->interrogatedValue = value;
+            }
+        }
+    }
+
+    if (isInterrogationResponse) {
+        self->numberOfPoints += ASDU_getNumberOfElements(asdu);
+
+        if (ASDU_getTypeID(asdu) == M_SP_NA_1) {
+            union uStaticInformationObject ioMemory;
+
+            int i;
+
+            for (i = 0; i < ASDU_getNumberOfElements(asdu); i++) {
+                InformationObject io = ASDU_getElementEx(asdu, &ioMemory, i);
+
+                if (InformationObject_getObjectAddress(io) == 2099)
+                    self->watchedPointValue = SinglePointInformation_getValue((SinglePointInformation) io);
+            }
+        }
+    }
+
+    return true;
+}
+
+static void
+TestMaster_reset(TestMaster* self)
+{
+    self->numberOfAsdus = 0;
+    self->numberOfPoints = 0;
+}
+
+/* connect without starting the data transfer */
+static void
+TestMaster_open(TestMaster* self, int originatorAddress)
+{
+    memset(self, 0, sizeof(TestMaster));
+
+    self->connection = T104Connection_create("127.0.0.1", PROCESS_IMAGE_TEST_PORT);
+
+    T104Connection_getConnectionParameters(self->connection)->originatorAddress = originatorAddress;
+
+    T104Connection_setConnectionHandler(self->connection, testMasterConnectionHandler, self);
+    T104Connection_setASDUReceivedHandler(self->connection, testMasterASDUReceivedHandler, self);
+
+    TEST_ASSERT_TRUE(T104Connection_connect(self->connection));
+}
+
+static void
+TestMaster_start(TestMaster* self)
+{
+    self->started = false;
+
+    T104Connection_sendStartDT(self->connection);
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    while ((self->started == false) && ((Hal_getTimeInMs() - startTime) < PROCESS_IMAGE_TEST_TIMEOUT))
+        Thread_sleep(1);
+
+    TEST_ASSERT_TRUE(self->started);
+}
+
+static void
+TestMaster_connect(TestMaster* self, int originatorAddress)
+{
+    TestMaster_open(self, originatorAddress);
+    TestMaster_start(self);
+}
+
+/* index of the first received ASDU with the type and COT (-1 when not received within the timeout) */
+static int
+TestMaster_waitForASDU(TestMaster* self, TypeID typeId, CauseOfTransmission cot)
+{
+    uint64_t startTime = Hal_getTimeInMs();
+
+    while ((Hal_getTimeInMs() - startTime) < PROCESS_IMAGE_TEST_TIMEOUT) {
+        int i;
+
+        for (i = 0; i < self->numberOfAsdus; i++) {
+            if ((self->asdus[i].typeId == typeId) && (self->asdus[i].cot == cot))
+                return i;
+        }
+
+        Thread_sleep(1);
+    }
+
+    return -1;
+}
+
+static bool
+waitForPause(TestMaster* master)
+{
+    uint64_t startTime = Hal_getTimeInMs();
+
+    while ((master->paused == false) && ((Hal_getTimeInMs() - startTime) < PROCESS_IMAGE_TEST_TIMEOUT))
+        Thread_sleep(1);
+
+    return master->paused;
+}
+
+static bool
+waitForAllocatedSnapshots(ProcessImage image, int numberOfSnapshots)
+{
+    uint64_t startTime = Hal_getTimeInMs();
+
+    while ((ProcessImage_getNumberOfAllocatedSnapshots(image) != numberOfSnapshots) &&
+            ((Hal_getTimeInMs() - startTime) < PROCESS_IMAGE_TEST_TIMEOUT))
+        Thread_sleep(1);
+
+    return (ProcessImage_getNumberOfAllocatedSnapshots(image) == numberOfSnapshots);
+}
+
+/* check the response of a station interrogation of a single CA (ACT_CON, points, ACT_TERM) */
+static void
+assertStationInterrogationResponse(TestMaster* master, int oa)
+{
+    int termination = TestMaster_waitForASDU(master, C_IC_NA_1, ACTIVATION_TERMINATION);
+
+    TEST_ASSERT_TRUE(termination > 0);
+
+    TEST_ASSERT_EQUAL_INT(C_IC_NA_1, master->asdus[0].typeId);
+    TEST_ASSERT_EQUAL_INT(ACTIVATION_CON, master->asdus[0].cot);
+    TEST_ASSERT_FALSE(master->asdus[0].isNegative);
+    TEST_ASSERT_EQUAL_INT(oa, master->asdus[0].oa);
+
+    int numberOfPoints = 0;
+
+    int i;
+
+    for (i = 1; i < termination; i++) {
+        TEST_ASSERT_EQUAL_INT(M_SP_NA_1, master->asdus[i].typeId);
+        TEST_ASSERT_EQUAL_INT(INTERROGATED_BY_STATION, master->asdus[i].cot);
+        TEST_ASSERT_EQUAL_INT(oa, master->asdus[i].oa);
+        TEST_ASSERT_EQUAL_INT(1, master->asdus[i].ca);
+
+        numberOfPoints += master->asdus[i].numberOfElements;
+    }
+
+    TEST_ASSERT_EQUAL_INT(PROCESS_IMAGE_TEST_POINTS, numberOfPoints);
+    TEST_ASSERT_EQUAL_INT(oa, master->asdus[termination].oa);
+
+    /* nothing is sent after ACT_TERM */
+    Thread_sleep(20);
+    TEST_ASSERT_EQUAL_INT(termination + 1, master->numberOfAsdus);
+}
+
+static ProcessImage
+createTestProcessImage(Slave slave)
+{
+    ProcessImage image = ProcessImage_create(slave);
+
+    ProcessImage_addPoints(image, 1, M_SP_NA_1, 100, PROCESS_IMAGE_TEST_POINTS);
+    ProcessImage_addPoints(image, 2, M_ME_NC_1, 10, 5);
+
+    Slave_setInterrogationHandler(slave, ProcessImage_interrogationHandler, image);
+
+    return image;
+}
+
+void
+test_ProcessImage_interrogationStream(void)
+{
+    Slave slave = T104Slave_create(NULL, 100, 100);
+    T104Slave_setLocalPort(slave, PROCESS_IMAGE_TEST_PORT);
+
+    /* both masters are active at the same time */
+    T104Slave_setServerMode(slave, CONNECTION_IS_REDUNDANCY_GROUP);
+
+    ProcessImage image = createTestProcessImage(slave);
+
+    Slave_start(slave);
+
+    TestMaster master1;
+    TestMaster master2;
+
+    TestMaster_connect(&master1, 5);
+    TestMaster_connect(&master2, 7);
+
+    T104Connection_sendInterrogationCommand(master1.connection, ACTIVATION, 1, IEC60870_QOI_STATION);
+    assertStationInterrogationResponse(&master1, 5);
+
+    TEST_ASSERT_EQUAL_INT(1, ProcessImage_getNumberOfCachedSnapshots(image));
+    TEST_ASSERT_EQUAL_INT(1, ProcessImage_getNumberOfAllocatedSnapshots(image));
+
+    /* the second master gets the same snapshot with its own OA */
+    T104Connection_sendInterrogationCommand(master2.connection, ACTIVATION, 1, IEC60870_QOI_STATION);
+    assertStationInterrogationResponse(&master2, 7);
+
+    TEST_ASSERT_EQUAL_INT(1, ProcessImage_getNumberOfCachedSnapshots(image));
+    TEST_ASSERT_EQUAL_INT(1, ProcessImage_getNumberOfAllocatedSnapshots(image));
+
+    /* broadcast: ACT_CON and ACT_TERM for each CA */
+    TestMaster_reset(&master2);
+
+    T104Connection_sendInterrogationCommand(master2.connection, ACTIVATION, 0xffff, IEC60870_QOI_STATION);
+
+    TEST_ASSERT_TRUE(waitForAllocatedSnapshots(image, 2));
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    while ((master2.numberOfPoints < (PROCESS_IMAGE_TEST_POINTS + 5)) &&
+            ((Hal_getTimeInMs() - startTime) < PROCESS_IMAGE_TEST_TIMEOUT))
+        Thread_sleep(1);
+
+    int termination1 = TestMaster_waitForASDU(&master2, C_IC_NA_1, ACTIVATION_TERMINATION);
+
+    TEST_ASSERT_TRUE(termination1 > 0);
+
+    TEST_ASSERT_EQUAL_INT(ACTIVATION_CON, master2.asdus[0].cot);
+    TEST_ASSERT_EQUAL_INT(1, master2.asdus[0].ca);
+    TEST_ASSERT_EQUAL_INT(1, master2.asdus[termination1].ca);
+
+    int i;
+
+    for (i = 1; i < termination1; i++)
+        TEST_ASSERT_EQUAL_INT(M_SP_NA_1, master2.asdus[i].typeId);
+
+    Thread_sleep(20);
+
+    TEST_ASSERT_EQUAL_INT(termination1 + 4, master2.numberOfAsdus);
+
+    TEST_ASSERT_EQUAL_INT(ACTIVATION_CON, master2.asdus[termination1 + 1].cot);
+    TEST_ASSERT_EQUAL_INT(2, master2.asdus[termination1 + 1].ca);
+    TEST_ASSERT_EQUAL_INT(M_ME_NC_1, master2.asdus[termination1 + 2].typeId);
+    TEST_ASSERT_EQUAL_INT(2, master2.asdus[termination1 + 2].ca);
+    TEST_ASSERT_EQUAL_INT(ACTIVATION_TERMINATION, master2.asdus[termination1 + 3].cot);
+    TEST_ASSERT_EQUAL_INT(2, master2.asdus[termination1 + 3].ca);
+
+    TEST_ASSERT_EQUAL_INT(2, ProcessImage_getNumberOfCachedSnapshots(image));
+
+    /* an update releases the snapshot of the CA */
+    ProcessImage_updateSinglePoint(image, 1, 150, true, IEC60870_QUALITY_GOOD);
+
+    TEST_ASSERT_EQUAL_INT(1, ProcessImage_getNumberOfCachedSnapshots(image));
+    TEST_ASSERT_EQUAL_INT(1, ProcessImage_getNumberOfAllocatedSnapshots(image));
+
+    T104Connection_destroy(master1.connection);
+    T104Connection_destroy(master2.connection);
+
+    Slave_destroy(slave);
+
+    ProcessImage_destroy(image);
+}
+
+void
+test_ProcessImage_interrogationSnapshotUpdate(void)
+{
+    Slave slave = T104Slave_create(NULL, 100, 100);
+    T104Slave_setLocalPort(slave, PROCESS_IMAGE_TEST_PORT);
+
+    /* both masters are active at the same time */
+    T104Slave_setServerMode(slave, CONNECTION_IS_REDUNDANCY_GROUP);
+
+    ProcessImage image = createTestProcessImage(slave);
+
+    Slave_start(slave);
+
+    TestMaster master1;
+    TestMaster master2;
+
+    TestMaster_connect(&master1, 5);
+    TestMaster_connect(&master2, 7);
+
+    /* the stream of the first master keeps the snapshot while the point is updated */
+    master1.pauseAtPoints = true;
+
+    T104Connection_sendInterrogationCommand(master1.connection, ACTIVATION, 1, IEC60870_QOI_STATION);
+
+    TEST_ASSERT_TRUE(waitForPause(&master1));
+
+    ProcessImage_updateSinglePoint(image, 1, 2099, true, IEC60870_QUALITY_GOOD);
+
+    TEST_ASSERT_EQUAL_INT(0, ProcessImage_getNumberOfCachedSnapshots(image));
+    TEST_ASSERT_EQUAL_INT(1, ProcessImage_getNumberOfAllocatedSnapshots(image));
+
+    /* the second master gets a new snapshot with the updated value */
+    T104Connection_sendInterrogationCommand(master2.connection, ACTIVATION, 1, IEC60870_QOI_STATION);
+
+    TEST_ASSERT_TRUE(TestMaster_waitForASDU(&master2, C_IC_NA_1, ACTIVATION_TERMINATION) > 0);
+    TEST_ASSERT_EQUAL_INT(PROCESS_IMAGE_TEST_POINTS, master2.numberOfPoints);
+    TEST_ASSERT_TRUE(master2.watchedPointValue);
+
+    TEST_ASSERT_EQUAL_INT(1, ProcessImage_getNumberOfCachedSnapshots(image));
+    TEST_ASSERT_EQUAL_INT(2, ProcessImage_getNumberOfAllocatedSnapshots(image));
+
+    /* the first master gets the old snapshot */
+    master1.pauseAtPoints = false;
+
+    TEST_ASSERT_TRUE(TestMaster_waitForASDU(&master1, C_IC_NA_1, ACTIVATION_TERMINATION) > 0);
+    TEST_ASSERT_EQUAL_INT(PROCESS_IMAGE_TEST_POINTS, master1.numberOfPoints);
+    TEST_ASSERT_FALSE(master1.watchedPointValue);
+
+    TEST_ASSERT_TRUE(waitForAllocatedSnapshots(image, 1));
+
+    /* deactivation while the response is sent */
+    TestMaster_reset(&master1);
+    master1.pauseAtPoints = true;
+
+    T104Connection_sendInterrogationCommand(master1.connection, ACTIVATION, 1, IEC60870_QOI_STATION);
+
+    TEST_ASSERT_TRUE(waitForPause(&master1));
+
+    /* only the stream uses the snapshot */
+    ProcessImage_updateSinglePoint(image, 1, 2099, false, IEC60870_QUALITY_GOOD);
+
+    TEST_ASSERT_EQUAL_INT(0, ProcessImage_getNumberOfCachedSnapshots(image));
+    TEST_ASSERT_EQUAL_INT(1, ProcessImage_getNumberOfAllocatedSnapshots(image));
+
+    T104Connection_sendInterrogationCommand(master1.connection, DEACTIVATION, 1, IEC60870_QOI_STATION);
+
+    /* the stopped stream releases the snapshot */
+    TEST_ASSERT_TRUE(waitForAllocatedSnapshots(image, 0));
+
+    master1.pauseAtPoints = false;
+
+    int deactivation = TestMaster_waitForASDU(&master1, C_IC_NA_1, DEACTIVATION_CON);
+
+    TEST_ASSERT_TRUE(deactivation > 0);
+    TEST_ASSERT_FALSE(master1.asdus[deactivation].isNegative);
+
+    Thread_sleep(20);
+
+    TEST_ASSERT_TRUE(master1.numberOfPoints < PROCESS_IMAGE_TEST_POINTS);
+
+    int i;
+
+    /* no points and no ACT_TERM after DEACT_CON */
+    for (i = deactivation + 1; i < master1.numberOfAsdus; i++) {
+        TEST_ASSERT_NOT_EQUAL(INTERROGATED_BY_STATION, master1.asdus[i].cot);
+        TEST_ASSERT_NOT_EQUAL(ACTIVATION_TERMINATION, master1.asdus[i].cot);
+    }
+
+    T104Connection_destroy(master1.connection);
+    T104Connection_destroy(master2.connection);
+
+    Slave_destroy(slave);
+
+    ProcessImage_destroy(image);
+}
+
+#define CONCURRENT_UPDATES 2000
+
+typedef struct {
+    ProcessImage image;
+    int firstValue;
+} UpdateThreadParameter;
+
+static void*
+updateThread(void* parameter)
+{
+    UpdateThreadParameter* self = (UpdateThreadParameter*) parameter;
+
+    int i;
+
+    for (i = 0; i < CONCURRENT_UPDATES; i++)
+        ProcessImage_updateShortFloat(self->image, 2, 10, (float) (self->firstValue + i), IEC60870_QUALITY_GOOD);
+
+    return NULL;
+}
+
+void
+test_ProcessImage_concurrentUpdates(void)
+{
+    Slave slave = T104Slave_create(NULL, 10000, 100);
+    T104Slave_setLocalPort(slave, PROCESS_IMAGE_TEST_PORT);
+
+    ProcessImage image = createTestProcessImage(slave);
+
+    Slave_start(slave);
+
+    TestMaster master;
+
+    TestMaster_connect(&master, 5);
+
+    /* two threads update the same point */
+    UpdateThreadParameter parameter1 = { image, 1 };
+    UpdateThreadParameter parameter2 = { image, 1000001 };
+
+    Thread thread1 = Thread_create(updateThread, &parameter1, false);
+    Thread thread2 = Thread_create(updateThread, &parameter2, false);
+
+    Thread_start(thread1);
+    Thread_start(thread2);
+
+    Thread_destroy(thread1);
+    Thread_destroy(thread2);
+
+    /* the last event has the value of the process image */
+    master.interrogatedValue = -1.0f;
+
+    T104Connection_sendInterrogationCommand(master.connection, ACTIVATION, 2, IEC60870_QOI_STATION);
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    while ((master.eventValue != master.interrogatedValue) && ((Hal_getTimeInMs() - startTime) < PROCESS_IMAGE_TEST_TIMEOUT))
+        Thread_sleep(1);
+
+    TEST_ASSERT_EQUAL_FLOAT(master.interrogatedValue, master.eventValue);
+
+    T104Connection_destroy(master.connection);
+
+    Slave_destroy(slave);
+
+    ProcessImage_destroy(image);
+}
+
+static EnqueueResult
+enqueueEvent(Slave slave, int ioa)
+{
+    ASDU asdu = ASDU_create(Slave_getConnectionParameters(slave), M_ME_NC_1, false, SPONTANEOUS, 0, 1, false, false);
+
+    InformationObject io = (InformationObject) MeasuredValueShort_create(NULL, ioa, (float) ioa, IEC60870_QUALITY_GOOD);
+    ASDU_addInformationObject(asdu, io);
+    InformationObject_destroy(io);
+
+    return Slave_enqueueASDU(slave, asdu);
+}
+
+static bool
+waitForEmptyEventQueue(Slave slave)
+{
+    uint64_t startTime = Hal_getTimeInMs();
+
+    while ((Slave_getQueueFillLevel(slave) > 0) && ((Hal_getTimeInMs() - startTime) < PROCESS_IMAGE_TEST_TIMEOUT))
+        Thread_sleep(1);
+
+    return (Slave_getQueueFillLevel(slave) == 0);
+}
+
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+static bool
+waitForReceivedAsdus(TestMaster* master, int numberOfAsdus)
+{
+    uint64_t startTime = Hal_getTimeInMs();
+
+    while ((master->numberOfAsdus < numberOfAsdus) && ((Hal_getTimeInMs() - startTime) < PROCESS_IMAGE_TEST_TIMEOUT))
+        Thread_sleep(1);
+
+    return (master->numberOfAsdus == numberOfAsdus);
+}
+
+void
+test_Slave_eventLogWithStoppedConnection(void)
+{
+    Slave slave = T104Slave_create(NULL, 100, 100);
+
+    T104Slave_setLocalPort(slave, PROCESS_IMAGE_TEST_PORT);
+    T104Slave_setServerMode(slave, CONNECTION_IS_REDUNDANCY_GROUP);
+
+    Slave_start(slave);
+
+    TestMaster master1;
+    TestMaster master2;
+
+    TestMaster_connect(&master1, 5);
+
+    /* the second master is connected but has not started the data transfer */
+    TestMaster_open(&master2, 7);
+
+    /* the masters confirm every w = 8 received ASDUs */
+    int i;
+
+    for (i = 0; i < 48; i++)
+        TEST_ASSERT_NOT_EQUAL(ENQUEUE_DROPPED, enqueueEvent(slave, 100 + i));
+
+    TEST_ASSERT_TRUE(waitForReceivedAsdus(&master1, 48));
+
+    /* the events are kept for the second master */
+    Thread_sleep(100);
+
+    TEST_ASSERT_TRUE(Slave_getQueueFillLevel(slave) > 0);
+    TEST_ASSERT_EQUAL_INT(0, master2.numberOfAsdus);
+
+    TestMaster_start(&master2);
+
+    TEST_ASSERT_TRUE(waitForReceivedAsdus(&master2, 48));
+    TEST_ASSERT_TRUE(waitForEmptyEventQueue(slave));
+
+    /* events added after STOPDT are sent after the next STARTDT */
+    T104Connection_sendStopDT(master1.connection);
+
+    Thread_sleep(100);
+
+    TestMaster_reset(&master1);
+    TestMaster_reset(&master2);
+
+    for (i = 0; i < 48; i++)
+        TEST_ASSERT_NOT_EQUAL(ENQUEUE_DROPPED, enqueueEvent(slave, 200 + i));
+
+    TEST_ASSERT_TRUE(waitForReceivedAsdus(&master2, 48));
+
+    Thread_sleep(100);
+
+    TEST_ASSERT_TRUE(Slave_getQueueFillLevel(slave) > 0);
+    TEST_ASSERT_EQUAL_INT(0, master1.numberOfAsdus);
+
+    TestMaster_start(&master1);
+
+    TEST_ASSERT_TRUE(waitForReceivedAsdus(&master1, 48));
+    TEST_ASSERT_TRUE(waitForEmptyEventQueue(slave));
+
+    T104Connection_destroy(master1.connection);
+    T104Connection_destroy(master2.connection);
+
+    Slave_destroy(slave);
+}
+typedef struct {
+    bool isHigh;
+    int fillLevel;
+} WatermarkCall;
+
+typedef struct {
+    WatermarkCall calls[4];
+    volatile int numberOfCalls;
+} WatermarkRecorder;
+
+static void
+watermarkHandler(void* parameter, bool isHigh, int fillLevel)
+{
+    WatermarkRecorder* self = (WatermarkRecorder*) parameter;
+
+    if (self->numberOfCalls < 4) {
+        self->calls[self->numberOfCalls].isHigh = isHigh;
+        self->calls[self->numberOfCalls].fillLevel = fillLevel;
+    }
+
+    self->numberOfCalls++;
+}
+
+void
+test_Slave_queueWatermarks(void)
+{
+    WatermarkRecorder recorder;
+
+    memset(&recorder, 0, sizeof(recorder));
+
+    Slave slave = T104Slave_create(NULL, 10, 10);
+
+    T104Slave_setLocalPort(slave, PROCESS_IMAGE_TEST_PORT);
+    T104Slave_setServerMode(slave, CONNECTION_IS_REDUNDANCY_GROUP);
+    T104Slave_setQueueWatermarks(slave, 10, 50, watermarkHandler, &recorder);
+
+    Slave_start(slave);
+
+    TestMaster master1;
+    TestMaster master2;
+
+    TestMaster_connect(&master1, 5);
+
+    /* the events are kept in the log until the second master has started and confirmed them */
+    TestMaster_open(&master2, 7);
+
+    int i;
+
+    for (i = 0; (i < 30) && (recorder.numberOfCalls == 0); i++) {
+        int j;
+
+        /* the masters confirm every w = 8 received ASDUs */
+        for (j = 0; j < 8; j++)
+            TEST_ASSERT_NOT_EQUAL(ENQUEUE_DROPPED, enqueueEvent(slave, 100 + j));
+
+        Thread_sleep(20);
+    }
+
+    TEST_ASSERT_EQUAL_INT(1, recorder.numberOfCalls);
+    TEST_ASSERT_TRUE(recorder.calls[0].isHigh);
+    TEST_ASSERT_TRUE(recorder.calls[0].fillLevel >= 50);
+    TEST_ASSERT_TRUE(recorder.calls[0].fillLevel < 100);
+
+    TestMaster_start(&master2);
+
+    TEST_ASSERT_TRUE(waitForEmptyEventQueue(slave));
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    while ((recorder.numberOfCalls < 2) && ((Hal_getTimeInMs() - startTime) < PROCESS_IMAGE_TEST_TIMEOUT))
+        Thread_sleep(1);
+
+    TEST_ASSERT_EQUAL_INT(2, recorder.numberOfCalls);
+    TEST_ASSERT_FALSE(recorder.calls[1].isHigh);
+    TEST_ASSERT_TRUE(recorder.calls[1].fillLevel <= 10);
+
+    T104Connection_destroy(master1.connection);
+    T104Connection_destroy(master2.connection);
+
+    Slave_destroy(slave);
+}
+#if (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0)
+static void
+countingSpillHandler(void* parameter, const uint8_t* asdu, int asduSize)
+{
+    (*((int*) parameter))++;
+}
+
+void
+test_Slave_ingestQueueOverflow(void)
+{
+    int spilledAsdus = 0;
+
+    /* before Slave_start the ASDUs are kept in the ingest queue (the size is a power of two) */
+    Slave slave = T104Slave_create(NULL, 10, 10);
+
+    T104Slave_setQueueOverflowPolicy(slave, QUEUE_OVERFLOW_SPILL, 0);
+    T104Slave_setQueueSpillHandler(slave, countingSpillHandler, &spilledAsdus);
+
+    int i;
+
+    for (i = 0; i < CONFIG_SLAVE_INGEST_QUEUE_SIZE; i++)
+        TEST_ASSERT_EQUAL_INT(ENQUEUE_OK, enqueueEvent(slave, 100));
+
+    for (i = 0; i < 10; i++)
+        TEST_ASSERT_EQUAL_INT(ENQUEUE_OLDEST_DROPPED, enqueueEvent(slave, 100));
+
+    TEST_ASSERT_EQUAL_INT(10, spilledAsdus);
+
+    Slave_destroy(slave);
+
+    /* events that are overwritten while the ingest queue is drained are reported by the next call */
+    slave = T104Slave_create(NULL, 10, 10);
+
+    T104Slave_setLocalPort(slave, PROCESS_IMAGE_TEST_PORT);
+    T104Slave_setServerMode(slave, CONNECTION_IS_REDUNDANCY_GROUP);
+
+    Slave_start(slave);
+
+    /* the master keeps all events in the log (no STARTDT) */
+    TestMaster master;
+
+    TestMaster_open(&master, 5);
+
+    int oldestDropped = 0;
+
+    for (i = 0; i < 1000; i++) {
+        EnqueueResult result = enqueueEvent(slave, 100 + (i % 100));
+
+        TEST_ASSERT_NOT_EQUAL(ENQUEUE_DROPPED, result);
+
+        if (result == ENQUEUE_OLDEST_DROPPED)
+            oldestDropped++;
+    }
+
+    TEST_ASSERT_TRUE(oldestDropped > 0);
+
+    T104Connection_destroy(master.connection);
+
+    Slave_destroy(slave);
+}
+#endif /* (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0) */
+
+static bool
+waitForOpenConnections(Slave slave, int openConnections)
+{
+    uint64_t startTime = Hal_getTimeInMs();
+
+    while ((T104Slave_getOpenConnections(slave) != openConnections) &&
+            ((Hal_getTimeInMs() - startTime) < PROCESS_IMAGE_TEST_TIMEOUT))
+        Thread_sleep(1);
+
+    return (T104Slave_getOpenConnections(slave) == openConnections);
+}
+
+/* client that only sends the given frames and never reads the messages of the slave */
+static Socket
+connectRawClient(uint8_t* frame, int frameSize)
+{
+    Socket socket = TcpSocket_create();
+
+    TEST_ASSERT_TRUE(Socket_connect(socket, "127.0.0.1", PROCESS_IMAGE_TEST_PORT));
+    TEST_ASSERT_EQUAL_INT(frameSize, Socket_write(socket, frame, frameSize));
+
+    return socket;
+}
+
+static uint8_t STARTDT_ACT_FRAME[] = { 0x68, 0x04, 0x07, 0x00, 0x00, 0x00 };
+static uint8_t TESTFR_ACT_FRAME[] = { 0x68, 0x04, 0x43, 0x00, 0x00, 0x00 };
+
+static Slave
+createEventLoopSlave(int numberOfEventLoops)
+{
+    Slave slave = T104Slave_create(NULL, 100, 100);
+
+    T104Slave_setLocalPort(slave, PROCESS_IMAGE_TEST_PORT);
+    T104Slave_setServerMode(slave, CONNECTION_IS_REDUNDANCY_GROUP);
+    T104Slave_setThreadingMode(slave, EVENT_LOOP_THREAD);
+    T104Slave_setEventLoopThreads(slave, numberOfEventLoops);
+
+    ((T104ConnectionParameters) Slave_getConnectionParameters(slave))->t1 = 2;
+
+    return slave;
+}
+
+static void
+runEventLoopTest(int numberOfEventLoops)
+{
+    Slave slave = createEventLoopSlave(numberOfEventLoops);
+
+    Slave_start(slave);
+
+    TestMaster masters[3];
+
+    int i;
+
+    for (i = 0; i < 3; i++)
+        TestMaster_connect(&(masters[i]), 5 + i);
+
+    /* the masters confirm every w = 8 received ASDUs */
+    for (i = 0; i < 48; i++)
+        TEST_ASSERT_NOT_EQUAL(ENQUEUE_DROPPED, enqueueEvent(slave, 100 + i));
+
+    for (i = 0; i < 3; i++)
+        TEST_ASSERT_TRUE(waitForReceivedAsdus(&(masters[i]), 48));
+
+    TEST_ASSERT_TRUE(waitForEmptyEventQueue(slave));
+
+    /* a master that doesn't confirm the events is closed by timeout T1 */
+    Socket client = connectRawClient(STARTDT_ACT_FRAME, sizeof(STARTDT_ACT_FRAME));
+
+    TEST_ASSERT_TRUE(waitForOpenConnections(slave, 4));
+
+    Thread_sleep(100);
+
+    for (i = 0; i < 3; i++)
+        TestMaster_reset(&(masters[i]));
+
+    for (i = 0; i < 48; i++)
+        TEST_ASSERT_NOT_EQUAL(ENQUEUE_DROPPED, enqueueEvent(slave, 200 + i));
+
+    for (i = 0; i < 3; i++)
+        TEST_ASSERT_TRUE(waitForReceivedAsdus(&(masters[i]), 48));
+
+    /* the events remain in the log until the connection is closed */
+    Thread_sleep(100);
+
+    TEST_ASSERT_TRUE(Slave_getQueueFillLevel(slave) > 0);
+
+    TEST_ASSERT_TRUE(waitForOpenConnections(slave, 3));
+    TEST_ASSERT_TRUE(waitForEmptyEventQueue(slave));
+
+    Socket_destroy(client);
+
+    for (i = 0; i < 3; i++)
+        T104Connection_destroy(masters[i].connection);
+
+    Slave_destroy(slave);
+}
+
+void
+test_Slave_eventLoop(void)
+{
+    runEventLoopTest(1);
+    runEventLoopTest(4);
+}
+
+void
+test_Slave_eventLoopWithStalledMaster(void)
+{
+    Slave slave = createEventLoopSlave(1);
+
+    Slave_start(slave);
+
+    TestMaster master;
+
+    TestMaster_connect(&master, 5);
+
+    /* the client sends test frames until the slave stops reading because the client doesn't take the responses */
+    Socket client = connectRawClient(TESTFR_ACT_FRAME, sizeof(TESTFR_ACT_FRAME));
+
+    Socket_setNonBlocking(client);
+
+    uint8_t frames[6 * 1000];
+
+    int i;
+
+    for (i = 0; i < 1000; i++)
+        memcpy(frames + (i * 6), TESTFR_ACT_FRAME, 6);
+
+    int offset = 0;
+
+    uint64_t lastWriteTime = Hal_getTimeInMs();
+
+    while ((Hal_getTimeInMs() - lastWriteTime) < 100) {
+        int sentBytes = Socket_write(client, frames + offset, sizeof(frames) - offset);
+
+        TEST_ASSERT_TRUE(sentBytes >= 0);
+
+        if (sentBytes > 0) {
+            offset = (offset + sentBytes) % sizeof(frames);
+            lastWriteTime = Hal_getTimeInMs();
+        }
+        else
+            Thread_sleep(1);
+    }
+
+    /* the other connections of the event loop are not affected */
+    for (i = 0; i < 48; i++)
+        TEST_ASSERT_NOT_EQUAL(ENQUEUE_DROPPED, enqueueEvent(slave, 100 + i));
+
+    TEST_ASSERT_TRUE(waitForReceivedAsdus(&master, 48));
+
+    /* the stalled client is closed when it doesn't take the responses within timeout T1 */
+    TEST_ASSERT_TRUE(waitForOpenConnections(slave, 1));
+    TEST_ASSERT_TRUE(waitForEmptyEventQueue(slave));
+
+    Socket_destroy(client);
+
+    T104Connection_destroy(master.connection);
+
+    Slave_destroy(slave);
+}
+#endif /* (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1) */
+
+void
+test_Slave_blockingOverflowPolicy(void)
+{
+    Slave slave = T104Slave_create(NULL, 10, 10);
+
+    T104Slave_setLocalPort(slave, PROCESS_IMAGE_TEST_PORT);
+    T104Slave_setQueueOverflowPolicy(slave, QUEUE_OVERFLOW_BLOCK, PROCESS_IMAGE_TEST_TIMEOUT);
+
+    Slave_start(slave);
+
+    TestMaster master;
+
+    TestMaster_connect(&master, 5);
+
+    /* the queue has space for about 140 events -> the producer waits for the confirmations */
+    int i;
+
+    for (i = 0; i < 1000; i++)
+        TEST_ASSERT_NOT_EQUAL(ENQUEUE_DROPPED, enqueueEvent(slave, 100 + (i % 100)));
+
+    T104Connection_destroy(master.connection);
+
+    /* without connections the producer doesn't wait */
+    uint64_t startTime = Hal_getTimeInMs();
+
+    while ((T104Slave_getOpenConnections(slave) > 0) && ((Hal_getTimeInMs() - startTime) < PROCESS_IMAGE_TEST_TIMEOUT))
+        Thread_sleep(1);
+
+    TEST_ASSERT_NOT_EQUAL(ENQUEUE_DROPPED, enqueueEvent(slave, 100));
+
+    Slave_destroy(slave);
+}
+
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+void
+test_PersistentMessageQueue(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    const char* fileName = "test_event_queue.dat";
+
+    remove(fileName);
+
+    MessageQueue queue = MessageQueue_createPersistent(fileName, 128 + 1024);
+
+    TEST_ASSERT_NOT_NULL(queue);
+    TEST_ASSERT_EQUAL_INT(4, MessageQueue_getSize(queue));
+
+    int i;
+
+    for (i = 0; i < 5; i++)
+        enqueueTestASDU(queue, &parameters, i);
+
+    uint64_t seqNo;
+    int asduSize;
+
+    MessageQueue_lock(queue);
+
+    for (i = 0; i < 3; i++)
+        MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize);
+
+    MessageQueue_unlock(queue);
+
+    MessageQueue_markAsduAsConfirmed(queue, 1);
+
+    MessageQueue_destroy(queue);
+
+    /* unconfirmed entries are restored and sent again */
+    queue = MessageQueue_createPersistent(fileName, 128 + 1024);
+
+    TEST_ASSERT_NOT_NULL(queue);
+    TEST_ASSERT_EQUAL_INT(3, MessageQueue_getNumberOfEntries(queue));
+
+    enqueueTestASDU(queue, &parameters, 5);
+
+    MessageQueue_lock(queue);
+
+    for (i = 2; i < 6; i++) {
+        uint8_t* asdu = MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize);
+
+        TEST_ASSERT_NOT_NULL(asdu);
+        TEST_ASSERT_EQUAL_UINT64(i, seqNo);
+        TEST_ASSERT_EQUAL_INT(i, getQueuedCA(asdu));
+    }
+
+    TEST_ASSERT_NULL(MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize));
+
+    MessageQueue_unlock(queue);
+
+    MessageQueue_destroy(queue);
+
+    remove(fileName);
+}
+
+void
+test_PersistentMessageQueue_damagedEntries(void)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    const char* fileName = "test_event_queue.dat";
+
+    remove(fileName);
+
+    MessageQueue queue = MessageQueue_createPersistent(fileName, 128 + 1024);
+
+    TEST_ASSERT_NOT_NULL(queue);
+
+    int i;
+
+    for (i = 0; i < 3; i++)
+        enqueueTestASDU(queue, &parameters, i);
+
+    MessageQueue_destroy(queue);
+
+    /* set the length of the first entry (behind the 128 byte header) to a value above the maximum ASDU length */
+    FILE* file = fopen(fileName, "r+b");
+
+    TEST_ASSERT_NOT_NULL(file);
+
+    uint8_t length[2] = {0x00, 0x01};
+
+    fseek(file, 128, SEEK_SET);
+    fwrite(length, 1, sizeof(length), file);
+    fclose(file);
+
+    /* the damaged entries are not restored */
+    queue = MessageQueue_createPersistent(fileName, 128 + 1024);
+
+    TEST_ASSERT_NOT_NULL(queue);
+    TEST_ASSERT_EQUAL_INT(0, MessageQueue_getNumberOfEntries(queue));
+
+    enqueueTestASDU(queue, &parameters, 7);
+
+    MessageQueue_destroy(queue);
+
+    /* the state of the damaged queue is not used again */
+    queue = MessageQueue_createPersistent(fileName, 128 + 1024);
+
+    TEST_ASSERT_NOT_NULL(queue);
+    TEST_ASSERT_EQUAL_INT(1, MessageQueue_getNumberOfEntries(queue));
+
+    uint64_t seqNo;
+    int asduSize;
+
+    MessageQueue_lock(queue);
+
+    uint8_t* asdu = MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize);
+
+    TEST_ASSERT_NOT_NULL(asdu);
+    TEST_ASSERT_EQUAL_INT(7, getQueuedCA(asdu));
+
+    MessageQueue_unlock(queue);
+
+    MessageQueue_destroy(queue);
+
+    remove(fileName);
+}
+#endif /* (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1) */
+
+void
+test_MessageRing(void)
+{
+    uint8_t buffer[20];
+    uint8_t msg[5] = {1, 2, 3, 4, 5};
+
+    struct sMessageRing ring;
+
+    MessageRing_initialize(&ring, buffer, sizeof(buffer));
+
+    TEST_ASSERT_TRUE(MessageRing_add(&ring, msg, 5));
+
+    msg[0] = 2;
+    TEST_ASSERT_TRUE(MessageRing_add(&ring, msg, 5));
+
+    /* not enough space at the end and at the beginning of the buffer */
+    TEST_ASSERT_FALSE(MessageRing_add(&ring, msg, 5));
+
+    MessageRing_removeOldest(&ring);
+
+    /* message is stored at the beginning of the buffer */
+    msg[0] = 3;
+    TEST_ASSERT_TRUE(MessageRing_add(&ring, msg, 5));
+    TEST_ASSERT_EQUAL_INT(2, MessageRing_getNumberOfMessages(&ring));
+
+    MessageRingCursor cursor;
+    MessageRing_getOldest(&ring, &cursor);
+
+    int msgSize;
+    uint8_t* readMsg = MessageRing_read(&ring, &cursor, &msgSize);
+
+    TEST_ASSERT_EQUAL_INT(5, msgSize);
+    TEST_ASSERT_EQUAL_UINT8(2, readMsg[0]);
+
+    readMsg = MessageRing_read(&ring, &cursor, &msgSize);
+
+    TEST_ASSERT_EQUAL_INT(5, msgSize);
+    TEST_ASSERT_EQUAL_UINT8(3, readMsg[0]);
+    TEST_ASSERT_EQUAL_PTR(buffer + 3, readMsg);
+    TEST_ASSERT_TRUE(MessageRing_isAtEnd(&ring, &cursor));
+
+    /* messages larger than the buffer are rejected */
+    TEST_ASSERT_FALSE(MessageRing_add(&ring, buffer, 18));
+
+    MessageRing_removeUntil(&ring, 2);
+    TEST_ASSERT_FALSE(MessageRing_isRemoved(&ring, &cursor));
+    TEST_ASSERT_TRUE(MessageRing_isEmpty(&ring));
+
+    /* reserved messages are visible when all older messages are committed */
+    uint8_t* first = MessageRing_reserve(&ring, 1);
+    uint8_t* second = MessageRing_reserve(&ring, 1);
+
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+
+    *second = 5;
+    MessageRing_commit(&ring, second);
+    TEST_ASSERT_TRUE(MessageRing_isAtEnd(&ring, &cursor));
+
+    *first = 4;
+    MessageRing_commit(&ring, first);
+    TEST_ASSERT_EQUAL_INT(2, MessageRing_getNumberOfMessages(&ring));
+
+    readMsg = MessageRing_read(&ring, &cursor, &msgSize);
+    TEST_ASSERT_EQUAL_UINT8(4, readMsg[0]);
+
+    readMsg = MessageRing_read(&ring, &cursor, &msgSize);
+    TEST_ASSERT_EQUAL_UINT8(5, readMsg[0]);
+    TEST_ASSERT_TRUE(MessageRing_isAtEnd(&ring, &cursor));
+}
+
+
 int
 main(int argc, char** argv)
 {
@@ -79,5 +1986,37 @@ main(int argc, char** argv)
     RUN_TEST(test_CP56Time2a);
     RUN_TEST(test_CP56Time2aToMsTimestamp);
     RUN_TEST(test_StepPositionInformation);
+    RUN_TEST(test_ASDU_getOA);
+    RUN_TEST(test_BitString32);
+    RUN_TEST(test_T104ReceiveBuffer_partialFrames);
+    RUN_TEST(test_TimerWheel);
+    RUN_TEST(test_MessageQueue);
+    RUN_TEST(test_MessageQueueOverflowPolicy);
+    RUN_TEST(test_MessageQueueCoalescing);
+    RUN_TEST(test_MessageQueuePacking);
+    RUN_TEST(test_StaticASDUAndPool);
+    RUN_TEST(test_ASDU_getElementEx);
+    RUN_TEST(test_ASDU_decodeBatch);
+    RUN_TEST(test_ASDU_decodeBatch_normalizedWithoutQuality);
+    RUN_TEST(test_SequenceDecoder);
+    RUN_TEST(test_ProcessImage);
+    RUN_TEST(test_ProcessImage_interrogationStream);
+    RUN_TEST(test_ProcessImage_interrogationSnapshotUpdate);
+    RUN_TEST(test_ProcessImage_concurrentUpdates);
+#if (CONFIG_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    RUN_TEST(test_Slave_eventLogWithStoppedConnection);
+    RUN_TEST(test_Slave_queueWatermarks);
+#if (CONFIG_SLAVE_INGEST_QUEUE_SIZE > 0)
+    RUN_TEST(test_Slave_ingestQueueOverflow);
+#endif
+    RUN_TEST(test_Slave_eventLoop);
+    RUN_TEST(test_Slave_eventLoopWithStalledMaster);
+#endif
+    RUN_TEST(test_Slave_blockingOverflowPolicy);
+    RUN_TEST(test_MessageRing);
+#if (CONFIG_SLAVE_WITH_PERSISTENT_MESSAGE_QUEUE == 1)
+    RUN_TEST(test_PersistentMessageQueue);
+    RUN_TEST(test_PersistentMessageQueue_damagedEntries);
+#endif
     return UNITY_END();
 }
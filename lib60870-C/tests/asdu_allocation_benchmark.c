@@ -0,0 +1,306 @@
+/*
+ * Heap usage of the send and receive paths
+ *
+ * Send: ASDUs with a single measured value are created and added with Slave_enqueueASDU
+ * (1) with ASDU_create, (2) from an ASDU pool and (3) by reusing a static ASDU with
+ * ASDU_reset.
+ *
+ * Receive: a client receives the response to a station interrogation of a process image
+ * with 100000 points (the receive handler doesn't decode the ASDUs).
+ *
+ * Decode: the elements of a received ASDU with measured values are decoded with
+ * ASDU_getElement, with ASDU_getElementEx and with ASDU_decodeBatch.
+ *
+ * The benchmark provides the memory functions of the library to count the allocations.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "iec60870_slave.h"
+#include "iec60870_process_image.h"
+#include "t104_connection.h"
+#include "lib_memory.h"
+#include "hal_atomic.h"
+#include "hal_thread.h"
+#include "hal_time.h"
+
+#define NUMBER_OF_ASDUS 1000000
+
+#define NUMBER_OF_POINTS 100000
+
+#define NUMBER_OF_DECODED_ASDUS 100000
+
+/* maximum number of elements in an ASDU (single points in a sequence) */
+#define IEC60870_5_MAX_ELEMENTS 127
+
+#define TCP_PORT 20414
+
+/* the memory functions are called by the threads of the slave and the client */
+static volatile uint64_t allocations = 0;
+static volatile uint64_t releases = 0;
+
+static void
+increment(volatile uint64_t* counter)
+{
+    uint64_t value;
+
+    do {
+        value = Atomic_loadAcquire(counter);
+    } while (Atomic_compareAndSwap(counter, value, value + 1) == false);
+}
+
+void
+Memory_installExceptionHandler(MemoryExceptionHandler handler, void* parameter)
+{
+}
+
+void*
+Memory_malloc(size_t size)
+{
+    increment(&allocations);
+    return malloc(size);
+}
+
+void*
+Memory_calloc(size_t nmemb, size_t size)
+{
+    increment(&allocations);
+    return calloc(nmemb, size);
+}
+
+void*
+Memory_realloc(void* ptr, size_t size)
+{
+    increment(&allocations);
+    return realloc(ptr, size);
+}
+
+void
+Memory_free(void* memb)
+{
+    if (memb != NULL)
+        increment(&releases);
+
+    free(memb);
+}
+
+typedef enum {
+    USE_ASDU_CREATE,
+    USE_ASDU_POOL,
+    USE_STATIC_ASDU
+} AllocationMode;
+
+static void
+runBenchmark(Slave slave, AllocationMode mode, const char* name)
+{
+    ConnectionParameters parameters = Slave_getConnectionParameters(slave);
+
+    ASDUPool pool = ASDUPool_create(16);
+
+    struct sStaticASDU staticAsdu;
+
+    ASDU asdu = ASDU_initializeStatic(&staticAsdu, parameters, M_ME_NC_1, false, SPONTANEOUS, 0, 1, false, false);
+
+    /* the information object is initialized again for each value */
+    MeasuredValueShort io = MeasuredValueShort_create(NULL, 100, 0.0f, IEC60870_QUALITY_GOOD);
+
+    uint64_t allocationsBefore = allocations;
+    uint64_t releasesBefore = releases;
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_ASDUS; i++) {
+
+        if (mode == USE_ASDU_CREATE)
+            asdu = ASDU_create(parameters, M_ME_NC_1, false, SPONTANEOUS, 0, 1, false, false);
+        else if (mode == USE_ASDU_POOL)
+            asdu = ASDUPool_createASDU(pool, parameters, M_ME_NC_1, false, SPONTANEOUS, 0, 1, false, false);
+        else
+            ASDU_reset(asdu);
+
+        MeasuredValueShort_create(io, 100 + (i % 1000), (float) i, IEC60870_QUALITY_GOOD);
+        ASDU_addInformationObject(asdu, (InformationObject) io);
+
+        Slave_enqueueASDU(slave, asdu);
+    }
+
+    uint64_t duration = Hal_getTimeInMs() - startTime;
+
+    printf("send %-12s %6llu ms (%.0f ASDUs/s), %llu allocations, %llu releases\n", name, (unsigned long long) duration,
+            (duration > 0) ? (NUMBER_OF_ASDUS * 1000.0) / duration : 0.0,
+            (unsigned long long) (allocations - allocationsBefore), (unsigned long long) (releases - releasesBefore));
+
+    MeasuredValueShort_destroy(io);
+
+    ASDUPool_destroy(pool);
+}
+
+typedef enum {
+    DECODE_GET_ELEMENT,
+    DECODE_GET_ELEMENT_EX,
+    DECODE_BATCH
+} DecodeMode;
+
+static void
+runDecodeBenchmark(DecodeMode mode, const char* name)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    struct sStaticASDU staticAsdu;
+
+    ASDU asdu = ASDU_initializeStatic(&staticAsdu, &parameters, M_ME_NC_1, false, PERIODIC, 0, 1, false, false);
+
+    MeasuredValueShort io = MeasuredValueShort_create(NULL, 100, 0.0f, IEC60870_QUALITY_GOOD);
+
+    /* fill the ASDU */
+    do {
+        MeasuredValueShort_create(io, 100 + ASDU_getNumberOfElements(asdu), 1.0f, IEC60870_QUALITY_GOOD);
+    } while (ASDU_addInformationObject(asdu, (InformationObject) io));
+
+    MeasuredValueShort_destroy(io);
+
+    int numberOfElements = ASDU_getNumberOfElements(asdu);
+
+    union uStaticInformationObject ioMemory;
+
+    int ioa[IEC60870_5_MAX_ELEMENTS];
+    double value[IEC60870_5_MAX_ELEMENTS];
+    QualityDescriptor quality[IEC60870_5_MAX_ELEMENTS];
+
+    float sum = 0.0f;
+
+    uint64_t allocationsBefore = allocations;
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_DECODED_ASDUS; i++) {
+        int j;
+
+        if (mode == DECODE_BATCH) {
+            int decodedElements = ASDU_decodeBatch(asdu, ioa, value, quality, NULL, IEC60870_5_MAX_ELEMENTS);
+
+            for (j = 0; j < decodedElements; j++)
+                sum += (float) value[j];
+
+            continue;
+        }
+
+        for (j = 0; j < numberOfElements; j++) {
+
+            if (mode == DECODE_GET_ELEMENT_EX) {
+                MeasuredValueShort mvs = (MeasuredValueShort) ASDU_getElementEx(asdu, &ioMemory, j);
+
+                sum += MeasuredValueShort_getValue(mvs);
+            }
+            else {
+                MeasuredValueShort mvs = (MeasuredValueShort) ASDU_getElement(asdu, j);
+
+                sum += MeasuredValueShort_getValue(mvs);
+
+                MeasuredValueShort_destroy(mvs);
+            }
+        }
+    }
+
+    uint64_t duration = Hal_getTimeInMs() - startTime;
+
+    printf("decode %-17s %6llu ms (%i elements/ASDU, sum %.0f), %llu allocations\n", name, (unsigned long long) duration,
+            numberOfElements, sum, (unsigned long long) (allocations - allocationsBefore));
+}
+
+static volatile int receivedAsdus;
+static volatile bool interrogationTerminated;
+
+static bool
+asduReceivedHandler(void* parameter, ASDU asdu)
+{
+    if (ASDU_getTypeID(asdu) == C_IC_NA_1) {
+        if (ASDU_getCOT(asdu) == ACTIVATION_TERMINATION)
+            interrogationTerminated = true;
+    }
+    else
+        receivedAsdus++;
+
+    return true;
+}
+
+static void
+runReceiveBenchmark(int tcpPort)
+{
+    Slave slave = T104Slave_create(NULL, 1000, 100);
+
+    T104Slave_setLocalPort(slave, tcpPort);
+
+    ProcessImage image = ProcessImage_create(slave);
+
+    ProcessImage_addPoints(image, 1, M_ME_NC_1, 1, NUMBER_OF_POINTS);
+
+    Slave_setInterrogationHandler(slave, ProcessImage_interrogationHandler, image);
+
+    Slave_start(slave);
+
+    T104Connection connection = T104Connection_create("127.0.0.1", tcpPort);
+
+    T104Connection_setASDUReceivedHandler(connection, asduReceivedHandler, NULL);
+
+    if (T104Connection_connect(connection)) {
+
+        T104Connection_sendStartDT(connection);
+
+        Thread_sleep(100);
+
+        receivedAsdus = 0;
+        interrogationTerminated = false;
+
+        uint64_t allocationsBefore = allocations;
+
+        uint64_t startTime = Hal_getTimeInMs();
+
+        T104Connection_sendInterrogationCommand(connection, ACTIVATION, 1, IEC60870_QOI_STATION);
+
+        while ((interrogationTerminated == false) && ((Hal_getTimeInMs() - startTime) < 10000))
+            Thread_sleep(1);
+
+        uint64_t duration = Hal_getTimeInMs() - startTime;
+
+        printf("receive interrogation %6llu ms, %i ASDUs, %llu allocations (client and slave)\n",
+                (unsigned long long) duration, receivedAsdus, (unsigned long long) (allocations - allocationsBefore));
+    }
+    else
+        printf("Failed to connect\n");
+
+    T104Connection_destroy(connection);
+
+    Slave_destroy(slave);
+
+    ProcessImage_destroy(image);
+}
+
+int
+main(int argc, char** argv)
+{
+    Slave slave = T104Slave_create(NULL, 1000, 100);
+
+    T104Slave_setLocalPort(slave, TCP_PORT);
+
+    Slave_start(slave);
+
+    runBenchmark(slave, USE_ASDU_CREATE, "ASDU_create");
+    runBenchmark(slave, USE_ASDU_POOL, "ASDU pool");
+    runBenchmark(slave, USE_STATIC_ASDU, "static ASDU");
+
+    Slave_destroy(slave);
+
+    runReceiveBenchmark(TCP_PORT + 1);
+
+    runDecodeBenchmark(DECODE_GET_ELEMENT, "ASDU_getElement");
+    runDecodeBenchmark(DECODE_GET_ELEMENT_EX, "ASDU_getElementEx");
+    runDecodeBenchmark(DECODE_BATCH, "ASDU_decodeBatch");
+
+    return 0;
+}
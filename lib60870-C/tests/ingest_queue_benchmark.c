@@ -0,0 +1,128 @@
+/*
+ * Producer throughput benchmark for Slave_enqueueASDU
+ *
+ * 1, 4 and 16 producer threads add ASDUs with Slave_enqueueASDU while a client is
+ * connected and receives them. The time until all producers are finished and until
+ * the client has received all ASDUs is measured. To compare the lock-free ingest queue
+ * with adding the ASDUs directly to the event queue, build the library with
+ * CONFIG_SLAVE_INGEST_QUEUE_SIZE set to 0.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "iec60870_slave.h"
+#include "t104_connection.h"
+#include "hal_thread.h"
+#include "hal_time.h"
+
+#define NUMBER_OF_ASDUS 100000
+#define MAX_PRODUCERS 16
+
+#define TCP_PORT 20404
+
+static Slave slave;
+
+static int asdusPerProducer;
+
+static volatile int receivedAsdus;
+
+static bool
+asduReceivedHandler(void* parameter, ASDU asdu)
+{
+    if (ASDU_getTypeID(asdu) == M_ME_NC_1)
+        receivedAsdus++;
+
+    return true;
+}
+
+static void*
+producerThread(void* parameter)
+{
+    int id = (int) (intptr_t) parameter;
+
+    int i;
+
+    for (i = 0; i < asdusPerProducer; i++) {
+        ASDU asdu = ASDU_create(Slave_getConnectionParameters(slave), M_ME_NC_1, false, SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueShort_create(NULL, 100 + id, (float) i, IEC60870_QUALITY_GOOD);
+        ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+
+        Slave_enqueueASDU(slave, asdu);
+    }
+
+    return NULL;
+}
+
+static void
+runBenchmark(int numberOfProducers, int tcpPort)
+{
+    slave = T104Slave_create(NULL, NUMBER_OF_ASDUS, 100);
+
+    T104Slave_setLocalPort(slave, tcpPort);
+
+    Slave_start(slave);
+
+    T104Connection connection = T104Connection_create("127.0.0.1", tcpPort);
+
+    T104Connection_setASDUReceivedHandler(connection, asduReceivedHandler, NULL);
+
+    if (T104Connection_connect(connection) == false) {
+        printf("Failed to connect\n");
+        T104Connection_destroy(connection);
+        Slave_destroy(slave);
+        return;
+    }
+
+    T104Connection_sendStartDT(connection);
+
+    Thread_sleep(100);
+
+    asdusPerProducer = NUMBER_OF_ASDUS / numberOfProducers;
+    receivedAsdus = 0;
+
+    Thread producers[MAX_PRODUCERS];
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    int i;
+
+    for (i = 0; i < numberOfProducers; i++) {
+        producers[i] = Thread_create(producerThread, (void*) (intptr_t) i, false);
+        Thread_start(producers[i]);
+    }
+
+    for (i = 0; i < numberOfProducers; i++)
+        Thread_destroy(producers[i]);
+
+    uint64_t produceTime = Hal_getTimeInMs() - startTime;
+
+    int asdus = asdusPerProducer * numberOfProducers;
+
+    while ((receivedAsdus < asdus) && ((Hal_getTimeInMs() - startTime) < 30000))
+        Thread_sleep(1);
+
+    uint64_t totalTime = Hal_getTimeInMs() - startTime;
+
+    printf("%2i producers: enqueue %5llu ms (%.0f ASDUs/s), received %i/%i after %5llu ms\n", numberOfProducers,
+            (unsigned long long) produceTime, (produceTime > 0) ? (asdus * 1000.0) / produceTime : 0.0,
+            receivedAsdus, asdus, (unsigned long long) totalTime);
+
+    T104Connection_destroy(connection);
+
+    Slave_destroy(slave);
+}
+
+int
+main(int argc, char** argv)
+{
+    int numberOfProducers;
+    int tcpPort = TCP_PORT;
+
+    for (numberOfProducers = 1; numberOfProducers <= MAX_PRODUCERS; numberOfProducers = numberOfProducers * 4)
+        runBenchmark(numberOfProducers, tcpPort++);
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * Drain rate benchmark for the slave event queue (MessageQueue)
+ *
+ * The queue is filled with queueSize ASDUs and then drained the same way as by a slave
+ * connection: k ASDUs are taken from the queue and confirmed at once.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "iec60870_common.h"
+#include "information_objects.h"
+#include "hal_time.h"
+#include "t104_message_queue.h"
+
+#define K 12
+
+static void
+runBenchmark(ConnectionParameters parameters, int queueSize)
+{
+    MessageQueue queue = MessageQueue_create(queueSize);
+
+    int entries = MessageQueue_getSize(queue);
+
+    ASDU asdu = ASDU_create(parameters, M_ME_NC_1, false, SPONTANEOUS, 0, 1, false, false);
+
+    InformationObject io = (InformationObject) MeasuredValueShort_create(NULL, 100, 1.0f, IEC60870_QUALITY_GOOD);
+    ASDU_addInformationObject(asdu, io);
+    InformationObject_destroy(io);
+
+    /* repeat the test to handle at least one million ASDUs */
+    int rounds = 1000000 / entries;
+
+    if (rounds < 1)
+        rounds = 1;
+
+    uint64_t fillTime = 0;
+    uint64_t drainTime = 0;
+    int drained = 0;
+
+    int round;
+
+    for (round = 0; round < rounds; round++) {
+        uint64_t startTime = Hal_getTimeInMs();
+
+        int i;
+
+        for (i = 0; i < entries; i++)
+            MessageQueue_enqueueASDU(queue, asdu);
+
+        uint64_t filledTime = Hal_getTimeInMs();
+
+        while (MessageQueue_getNumberOfEntries(queue) > 0) {
+            uint64_t seqNo = 0;
+
+            MessageQueue_lock(queue);
+
+            for (i = 0; i < K; i++) {
+                int asduSize;
+
+                if (MessageQueue_getNextWaitingASDU(queue, &seqNo, &asduSize) == NULL)
+                    break;
+
+                drained++;
+            }
+
+            MessageQueue_unlock(queue);
+
+            MessageQueue_markAsduAsConfirmed(queue, seqNo);
+        }
+
+        fillTime += (filledTime - startTime);
+        drainTime += (Hal_getTimeInMs() - filledTime);
+    }
+
+    printf("queue size %7i: fill %5llu ms, drain %5llu ms (%i ASDUs, %.0f ASDUs/s)\n", entries,
+            (unsigned long long) fillTime, (unsigned long long) drainTime, drained,
+            (drainTime > 0) ? (drained * 1000.0) / drainTime : 0.0);
+
+    ASDU_destroy(asdu);
+
+    MessageQueue_destroy(queue);
+}
+
+int
+main(int argc, char** argv)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    int queueSize;
+
+    for (queueSize = 1000; queueSize <= 1000000; queueSize = queueSize * 10)
+        runBenchmark(&parameters, queueSize);
+
+    return 0;
+}
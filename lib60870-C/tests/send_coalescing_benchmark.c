@@ -0,0 +1,158 @@
+/*
+ * Syscall and TCP segment benchmark for the send buffer of slave connections (Linux only)
+ *
+ * A client receives NUMBER_OF_ASDUS events from a slave over a loopback connection. The
+ * events are either queued after the client has connected but before it sends STARTDT (the
+ * slave sends full k-windows) or added by the application while the client is receiving.
+ * The send calls of the slave connection are counted by wrapping send() (linker option
+ * --wrap=send) and the number of TCP segments with data is read with TCP_INFO from the
+ * socket of the slave connection. Without the send buffer every message is written with
+ * its own send call (one ASDU per call).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/tcp.h>
+
+#include "iec60870_slave.h"
+#include "t104_connection.h"
+#include "hal_thread.h"
+#include "hal_time.h"
+
+#define NUMBER_OF_ASDUS 100000
+
+#define TCP_PORT 20424
+
+ssize_t __real_send(int fd, const void* buf, size_t len, int flags);
+
+static volatile int slaveFd = -1;
+static volatile int sendCalls;
+
+static volatile int receivedAsdus;
+
+/* counts the send calls of the slave connection (the socket with the local port TCP_PORT) */
+ssize_t
+__wrap_send(int fd, const void* buf, size_t len, int flags)
+{
+    if (slaveFd == -1) {
+        struct sockaddr_in address;
+        socklen_t addressLength = sizeof(address);
+
+        if ((getsockname(fd, (struct sockaddr*) &address, &addressLength) == 0) &&
+                (ntohs(address.sin_port) == TCP_PORT))
+            slaveFd = fd;
+    }
+
+    if (fd == slaveFd)
+        sendCalls++;
+
+    return __real_send(fd, buf, len, flags);
+}
+
+static int
+getDataSegmentsOut(void)
+{
+    struct tcp_info info;
+    socklen_t infoLength = sizeof(info);
+
+    if ((slaveFd == -1) || (getsockopt(slaveFd, IPPROTO_TCP, TCP_INFO, &info, &infoLength) != 0))
+        return -1;
+
+    return (int) info.tcpi_data_segs_out;
+}
+
+static bool
+asduReceivedHandler(void* parameter, ASDU asdu)
+{
+    if (ASDU_getTypeID(asdu) == M_ME_NC_1)
+        receivedAsdus++;
+
+    return true;
+}
+
+static void
+enqueueEvents(Slave slave, int numberOfEvents)
+{
+    int i;
+
+    for (i = 0; i < numberOfEvents; i++) {
+        ASDU asdu = ASDU_create(Slave_getConnectionParameters(slave), M_ME_NC_1, false, SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueShort_create(NULL, 100 + (i % 1000), (float) i,
+                IEC60870_QUALITY_GOOD);
+        ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+
+        Slave_enqueueASDU(slave, asdu);
+    }
+}
+
+static void
+runBenchmark(const char* name, bool queueBeforeStart)
+{
+    Slave slave = T104Slave_create(NULL, NUMBER_OF_ASDUS, 100);
+
+    T104Slave_setLocalPort(slave, TCP_PORT);
+
+    Slave_start(slave);
+
+    slaveFd = -1;
+    receivedAsdus = 0;
+
+    T104Connection connection = T104Connection_create("127.0.0.1", TCP_PORT);
+
+    T104Connection_setASDUReceivedHandler(connection, asduReceivedHandler, NULL);
+
+    if (T104Connection_connect(connection) == false) {
+        printf("Failed to connect\n");
+        T104Connection_destroy(connection);
+        Slave_destroy(slave);
+        return;
+    }
+
+    /* events are only stored for connected clients */
+    if (queueBeforeStart) {
+        Thread_sleep(100);
+        enqueueEvents(slave, NUMBER_OF_ASDUS);
+    }
+
+    /* the slave has not sent anything yet (the STARTDT_CON is counted) */
+    sendCalls = 0;
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    T104Connection_sendStartDT(connection);
+
+    if (queueBeforeStart == false) {
+        Thread_sleep(100);
+        enqueueEvents(slave, NUMBER_OF_ASDUS);
+    }
+
+    while ((receivedAsdus < NUMBER_OF_ASDUS) && ((Hal_getTimeInMs() - startTime) < 30000))
+        Thread_sleep(1);
+
+    uint64_t duration = Hal_getTimeInMs() - startTime;
+
+    int segments = getDataSegmentsOut();
+
+    printf("%-16s received %i/%i in %5llu ms: %6i send calls (%.2f ASDUs/call), %6i data segments (%.2f ASDUs/segment)\n",
+            name, receivedAsdus, NUMBER_OF_ASDUS, (unsigned long long) duration,
+            sendCalls, (sendCalls > 0) ? ((double) receivedAsdus / sendCalls) : 0.0,
+            segments, (segments > 0) ? ((double) receivedAsdus / segments) : 0.0);
+
+    T104Connection_destroy(connection);
+
+    Slave_destroy(slave);
+}
+
+int
+main(int argc, char** argv)
+{
+    runBenchmark("queued events", true);
+    runBenchmark("live events", false);
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * Decode speed of sequence ASDUs (SQ=1)
+ *
+ * The values and quality descriptors of the elements of a sequence with the maximum number of
+ * elements are decoded with the scalar, SSE4.1 and AVX2 implementations of the sequence decoder
+ * (the SIMD implementations are skipped when not supported by the CPU or not compiled in).
+ * The last column shows ASDU_decodeBatch, which uses the fastest supported implementation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "iec60870_common.h"
+#include "apl_types_internal.h"
+#include "information_objects_internal.h"
+#include "sequence_decoder.h"
+#include "hal_time.h"
+
+#define NUMBER_OF_ASDUS 1000000
+
+static double values[127];
+static QualityDescriptor quality[127];
+
+static double
+runDecoder(SequenceDecoderType type, TypeID typeId, const uint8_t* data, int numberOfElements)
+{
+    uint64_t startTime = Hal_getTimeInMs();
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_ASDUS; i++)
+        SequenceDecoder_decode(type, typeId, data, numberOfElements, values, quality);
+
+    uint64_t duration = Hal_getTimeInMs() - startTime;
+
+    return (duration * 1000000.0) / ((double) NUMBER_OF_ASDUS * numberOfElements);
+}
+
+static double
+runDecodeBatch(ASDU asdu, int numberOfElements)
+{
+    uint64_t startTime = Hal_getTimeInMs();
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_ASDUS; i++)
+        ASDU_decodeBatch(asdu, NULL, values, quality, NULL, 127);
+
+    uint64_t duration = Hal_getTimeInMs() - startTime;
+
+    return (duration * 1000000.0) / ((double) NUMBER_OF_ASDUS * numberOfElements);
+}
+
+static void
+runBenchmark(TypeID typeId, const char* name, InformationObject io)
+{
+    struct sConnectionParameters parameters = {1, 1, 2, 0, 2, 3};
+
+    struct sStaticASDU staticAsdu;
+
+    ASDU asdu = ASDU_initializeStatic(&staticAsdu, &parameters, typeId, true, PERIODIC, 0, 1, false, false);
+
+    /* fill the ASDU (the elements of a sequence have consecutive IOAs) */
+    while ((ASDU_getNumberOfElements(asdu) < 127) && ASDU_addInformationObject(asdu, io))
+        InformationObject_setObjectAddress(io, InformationObject_getObjectAddress(io) + 1);
+
+    int numberOfElements = ASDU_getNumberOfElements(asdu);
+
+    /* elements start after the IOA of the sequence */
+    const uint8_t* data = asdu->payload + parameters.sizeOfIOA;
+
+    printf("%s (%3i elements) ns/element:", name, numberOfElements);
+
+    SequenceDecoderType type;
+
+    for (type = SEQUENCE_DECODER_SCALAR; type <= SEQUENCE_DECODER_AVX2; type++) {
+        if (SequenceDecoder_isSupported(type))
+            printf("  %5.2f", runDecoder(type, typeId, data, numberOfElements));
+        else
+            printf("      -");
+    }
+
+    printf("  | batch %5.2f\n", runDecodeBatch(asdu, numberOfElements));
+}
+
+int
+main(int argc, char** argv)
+{
+    printf("                              scalar SSE4.1   AVX2\n");
+
+    SinglePointInformation sp = SinglePointInformation_create(NULL, 100, true, IEC60870_QUALITY_GOOD);
+    runBenchmark(M_SP_NA_1, "M_SP_NA_1", (InformationObject) sp);
+    SinglePointInformation_destroy(sp);
+
+    MeasuredValueScaled mvs = MeasuredValueScaled_create(NULL, 100, -1234, IEC60870_QUALITY_GOOD);
+    runBenchmark(M_ME_NB_1, "M_ME_NB_1", (InformationObject) mvs);
+    MeasuredValueScaled_destroy(mvs);
+
+    MeasuredValueShort mvf = MeasuredValueShort_create(NULL, 100, 12.5f, IEC60870_QUALITY_GOOD);
+    runBenchmark(M_ME_NC_1, "M_ME_NC_1", (InformationObject) mvf);
+    MeasuredValueShort_destroy(mvf);
+
+    return 0;
+}